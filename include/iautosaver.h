@@ -29,12 +29,21 @@ public:
     // for the currently loaded map, regardless whether it is due for a save or not.
     // Call the "runAutosaveCheck" method to see if an autosave is overdue.
     virtual void performAutosave() = 0;
+
+    // When saving in the background, the files are written by a worker thread after
+    // performAutosave() returned. This reports the outcome of a finished background write.
+    // Returns true if a write is still in progress.
+    virtual bool checkPendingSave() = 0;
+
+    // Blocks until any background write is done, reporting its outcome
+    virtual void waitForPendingSave() = 0;
 };
 
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_ENABLED = "user/ui/map/autoSaveSnapshots";
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_FOLDER = "user/ui/map/snapshotFolder";
 constexpr const char* const RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE = "user/ui/map/maxSnapshotFolderSize";
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOT_FOLDER_SIZE_HISTORY = "user/ui/map/snapshotFolderSizeHistory";
+constexpr const char* const RKEY_AUTOSAVE_IN_BACKGROUND = "user/ui/map/autoSaveInBackground";
 
 }
 
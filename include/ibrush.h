@@ -316,6 +316,12 @@ public:
 
 	// Method used internally to recalculate the brush windings
 	virtual void evaluateBRep() const = 0;
+
+	// Constructs the face windings and bounds if the brush geometry changed, without notifying
+	// any observers. This can be called for several brushes concurrently, as long as they're
+	// not modified meanwhile. The next evaluateBRep() call publishes the prepared windings
+	// and has to happen on the main thread.
+	virtual void prepareBRep() const = 0;
 };
 
 // Forward-declare the Brush object, only accessible from main binary
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "inode.h"
+#include <atomic>
+#include <ios>
+#include <string>
+
+namespace scene
+{
+
+/**
+ * The text block a map writer emitted for a node during the last export,
+ * along with the state it has been written in. Writers reuse the text as long
+ * as the node's change stamp and the format settings are still the same.
+ */
+struct SerialisationCache
+{
+    // The change stamp of the node at the time of writing, 0 if nothing is cached
+    std::size_t changeStamp = 0;
+
+    // Identifies the writer (and its variant) which produced the text
+    std::string format;
+
+    // The floating point precision of the target stream
+    std::streamsize precision = 0;
+
+    std::string text;
+};
+
+/**
+ * A node keeping track of changes to its persistent state (geometry, materials,
+ * keyvalues, etc.). Every change renews the node's change stamp, which allows
+ * for caching data derived from that state.
+ */
+class IChangeTrackedNode :
+    public virtual INode
+{
+public:
+    virtual ~IChangeTrackedNode() {}
+
+    // Returns the current change stamp of this node, this is never 0
+    virtual std::size_t getChangeStamp() const = 0;
+
+    // Provides access to the text emitted by the last map export of this node
+    virtual SerialisationCache& getSerialisationCache() = 0;
+};
+
+// Returns a new change stamp, unique throughout the lifetime of the application
+inline std::size_t getNextChangeStamp()
+{
+    static std::atomic<std::size_t> _lastStamp(0);
+    return ++_lastStamp;
+}
+
+}
@@ -22,6 +22,18 @@ public:
     virtual std::string getFingerprint() = 0;
 };
 
+/**
+ * The last fingerprint calculated for a node, along with the change stamp
+ * of the state it has been calculated from (see IChangeTrackedNode).
+ */
+struct FingerprintCache
+{
+    // The change stamp at the time of calculation, 0 if nothing is cached
+    std::size_t changeStamp = 0;
+
+    std::string fingerprint;
+};
+
 // The number of digits that are considered when hashing floating point values in fingerprinting
 constexpr std::size_t SignificantFingerprintDoubleDigits = 6;
 
@@ -10,6 +10,9 @@
 namespace decl
 {
 
+// Set to "1" to keep the parsed decl blocks in a persistent cache (see DeclarationParseCache)
+constexpr const char* const RKEY_DECL_PARSE_CACHE = "user/ui/declarations/useParseCache";
+
 // Represents a declaration block as found in the various decl files
 // Holds the name of the block, its typename and the raw block contents
 // including whitespace and comments but exluding the outermost brace pair
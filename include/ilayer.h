@@ -1,10 +1,10 @@
 #pragma once
 
-#include <set>
 #include <string>
 #include <functional>
 #include "imodule.h"
 #include <sigc++/signal.h>
+#include "scene/LayerList.h"
 
 namespace scene
 {
@@ -12,9 +12,6 @@ namespace scene
 class INode;
 typedef std::shared_ptr<INode> INodePtr;
 
-// A list of named layers
-typedef std::set<int> LayerList;
-
 /**
  * greebo: Interface of a Layered object.
  */
@@ -225,6 +225,15 @@ public:
 	 * check of the file header.
 	 */
 	virtual bool canLoad(std::istream& stream) const = 0;
+
+	/**
+	 * Returns true if the files of this format contain binary data,
+	 * they are then written without any line ending conversion.
+	 */
+	virtual bool isBinaryFormat() const
+	{
+		return false;
+	}
 };
 typedef std::shared_ptr<MapFormat> MapFormatPtr;
 
@@ -281,6 +290,9 @@ typedef std::shared_ptr<IMapFormatManager> IMapFormatManagerPtr;
 // Portable Map Format Name is used across module boundaries
 const char* const PORTABLE_MAP_FORMAT_NAME("Portable");
 
+// Binary Map Format Name
+const char* const BINARY_MAP_FORMAT_NAME("Binary");
+
 } // namespace map
 
 const char* const MODULE_MAPFORMATMANAGER("MapFormatManager");
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <vector>
 #include "imodule.h"
 #include "inode.h"
 #include "ipath.h"
@@ -112,6 +113,33 @@ public:
 	// Same as above, but culls any hidden nodes
 	virtual void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) = 0;
 
+	/**
+	 * A walker receiving the nodes of a parallel volume traversal in chunks.
+	 * Walkers declaring themselves thread-safe are invoked concurrently from
+	 * several threads, chunks are delivered in no particular order.
+	 * The walker must not modify the scene (or any node's bounds).
+	 */
+	class ChunkWalker
+	{
+	public:
+		virtual ~ChunkWalker() {}
+
+		// Return true if visitChunk() can be called from several threads at once,
+		// otherwise the chunks are delivered sequentially on the calling thread
+		virtual bool isThreadSafe() const = 0;
+
+		// Called for each chunk of nodes intersecting the volume
+		virtual void visitChunk(const std::vector<INodePtr>& nodes) = 0;
+	};
+
+	// Parallel variant of foreachNodeInVolume: culls the space partition and its
+	// members on worker threads and passes the nodes intersecting the volume
+	// (or having no valid bounds) to the walker, even hidden ones
+	virtual void foreachNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker) = 0;
+
+	// Same as above, but culls any hidden nodes
+	virtual void foreachVisibleNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker) = 0;
+
 	// Returns the associated spacepartition
 	virtual ISpacePartitionSystemPtr getSpacePartition() = 0;
 };
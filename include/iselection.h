@@ -3,6 +3,7 @@
 #include <cstddef>
 #include "imodule.h"
 #include <memory>
+#include <vector>
 #include <sigc++/signal.h>
 #include "imanipulator.h"
 
@@ -87,6 +88,20 @@ public:
 		 * @isComponent: is TRUE if the changed selectable is a component (like a FaceInstance, VertexInstance).
 		 */
 		virtual void selectionChanged(const scene::INodePtr& node, bool isComponent) = 0;
+
+		/** 
+		 * Gets called once at the end of a selection change transaction, with all the
+		 * nodes that changed their selection status during the transaction (in order).
+		 * The default implementation invokes selectionChanged() for each of them,
+		 * observers doing expensive work on every change should override this.
+		 */
+		virtual void selectionBatchChanged(const std::vector<scene::INodePtr>& nodes, bool isComponent)
+		{
+			for (const auto& node : nodes)
+			{
+				selectionChanged(node, isComponent);
+			}
+		}
 	};
 
 	virtual void addObserver(Observer* observer) = 0;
@@ -121,6 +136,16 @@ public:
   virtual void onSelectedChanged(const scene::INodePtr& node, const ISelectable& selectable) = 0;
   virtual void onComponentSelection(const scene::INodePtr& node, const ISelectable& selectable) = 0;
 
+    /**
+     * Starts a selection change transaction, to be used around bulk selection operations.
+     * While a transaction is active, the selection counters and lists are kept up to date,
+     * but the selection changed signal is emitted only once and the observers are notified
+     * through Observer::selectionBatchChanged() when the outermost transaction ends.
+     * Transactions can be nested, use the SelectionChangeTransaction guard below.
+     */
+    virtual void beginSelectionChangeTransaction() = 0;
+    virtual void endSelectionChangeTransaction() = 0;
+
 	virtual scene::INodePtr ultimateSelected() = 0;
 	virtual scene::INodePtr penultimateSelected() = 0;
 
@@ -254,3 +279,33 @@ inline selection::SelectionSystem& GlobalSelectionSystem()
 	static module::InstanceReference<selection::SelectionSystem> _reference(MODULE_SELECTIONSYSTEM);
 	return _reference;
 }
+
+namespace selection
+{
+
+/**
+ * Scoped selection change transaction, merging all the selection changes
+ * happening during its lifetime into a single change notification.
+ */
+class SelectionChangeTransaction
+{
+private:
+    SelectionSystem& _selectionSystem;
+
+public:
+    SelectionChangeTransaction(SelectionSystem& selectionSystem = GlobalSelectionSystem()) :
+        _selectionSystem(selectionSystem)
+    {
+        _selectionSystem.beginSelectionChangeTransaction();
+    }
+
+    SelectionChangeTransaction(const SelectionChangeTransaction& other) = delete;
+    SelectionChangeTransaction& operator=(const SelectionChangeTransaction& other) = delete;
+
+    ~SelectionChangeTransaction()
+    {
+        _selectionSystem.endSelectionChangeTransaction();
+    }
+};
+
+}
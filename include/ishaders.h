@@ -498,6 +498,15 @@ public:
 
 constexpr const char* const MODULE_SHADERSYSTEM = "MaterialManager";
 
+// Set to "1" to evaluate the image maps of the material stages in the background
+constexpr const char* const RKEY_TEXTURE_STREAMING = "user/ui/textures/loadInBackground";
+
+// Memory in MB for keeping the images evaluated from map expressions, 0 disables the cache
+constexpr const char* const RKEY_IMAGE_CACHE_SIZE = "user/ui/textures/imageCacheSize";
+
+// Texture memory in MB above which unused streamed textures are evicted, 0 disables the limit
+constexpr const char* const RKEY_TEXTURE_MEMORY_LIMIT = "user/ui/textures/textureMemoryLimit";
+
 /**
  * \brief
  * Interface for the material manager.
@@ -614,6 +623,17 @@ public:
 
     // Reload the textures used by the active shaders
     virtual void reloadImages() = 0;
+
+    /**
+     * Uploads the textures whose images have been loaded in the background,
+     * until about the given amount of time has been spent. Until then these
+     * textures are showing a placeholder image. This is called by the render
+     * system at the start of every frame, with the GL context being current.
+     */
+    virtual void uploadStreamedTextures(std::size_t millisecondBudget) = 0;
+
+    // Returns the number of textures which are still being loaded in the background
+    virtual std::size_t getNumPendingTextureLoads() = 0;
 };
 
 inline IMaterialManager& GlobalMaterialManager()
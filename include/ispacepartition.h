@@ -1,7 +1,6 @@
 #ifndef _ISPACE_PARTITION_H_
 #define _ISPACE_PARTITION_H_
 
-#include <list>
 #include <vector>
 #include "imodule.h"
 
@@ -11,6 +10,10 @@ class AABB;
 namespace scene
 {
 
+// Selects the ISpacePartitionSystem implementation used by scenegraphs when
+// a new root is assigned, either "octree" (default) or "flatOctree"
+constexpr const char* const RKEY_SPACE_PARTITION_TYPE = "user/ui/scenegraph/spacePartition";
+
 // Some forward declarations to avoid including all the headers
 class INode;
 typedef std::shared_ptr<INode> INodePtr;
@@ -43,8 +46,8 @@ public:
 	// The child nodes
 	typedef std::vector<ISPNodePtr> NodeList;
 
-	// The members
-	typedef std::list<INodePtr> MemberList;
+	// The members (stored contiguously, the order is not significant)
+	typedef std::vector<INodePtr> MemberList;
 
 	// Get the parent node (can be NULL for the root node)
 	virtual ISPNodePtr getParent() const = 0;
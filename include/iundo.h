@@ -18,6 +18,14 @@ class IUndoMemento
 {
 public:
     virtual ~IUndoMemento() {}
+
+    // Returns the approximate number of bytes occupied by this memento,
+    // including the heap memory owned by it. The undo system uses this
+    // to enforce its memory limit.
+    virtual std::size_t getMemoryUsage() const
+    {
+        return sizeof(IUndoMemento);
+    }
 };
 typedef std::shared_ptr<IUndoMemento> IUndoMementoPtr;
 
@@ -82,6 +90,9 @@ public:
 	// Returns true if an operation is already started
 	virtual bool operationStarted() const = 0;
 
+	// Returns the approximate number of bytes occupied by the recorded undo and redo operations
+	virtual std::size_t getMemoryUsage() const = 0;
+
 	// greebo: This finishes the current operation and removes
 	// it immediately from the stack, therefore it never existed.
 	virtual void cancel() = 0;
@@ -1,10 +1,23 @@
 #pragma once
 
 #include "iundo.h"
+#include <type_traits>
+#include <utility>
 
 namespace undo
 {
 
+namespace detail
+{
+	// Detects container types, whose elements are accounted for in the memory usage
+	template<typename T, typename = void>
+	struct IsContainer : std::false_type {};
+
+	template<typename T>
+	struct IsContainer<T, std::void_t<typename T::value_type, decltype(std::declval<const T&>().size())>> :
+		std::true_type {};
+}
+
 /**
  * An UndoMemento implementation capable of holding a single
  * copyable object, which is stored by value.
@@ -23,6 +36,18 @@ public:
 	{
 		return _data;
 	}
+
+	std::size_t getMemoryUsage() const override
+	{
+		if constexpr (detail::IsContainer<Copyable>::value)
+		{
+			return sizeof(BasicUndoMemento) + _data.size() * sizeof(typename Copyable::value_type);
+		}
+		else
+		{
+			return sizeof(BasicUndoMemento);
+		}
+	}
 };
 
 } // namespace
@@ -0,0 +1,1056 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define IMAGEKERNELS_USE_SSE2
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define IMAGEKERNELS_USE_AVX2
+#endif
+
+/**
+ * Pixel processing kernels used when loading textures and evaluating map
+ * expressions. All of them operate on tightly packed 8-bit RGBA pixels.
+ *
+ * The functions in image::kernel are vectorised using SSE2, the simpler ones
+ * also using AVX2 if the build is targeting it. Each of them produces exactly
+ * the same pixels as its counterpart in image::kernel::scalar, which is used
+ * for the remainders and serves as reference for the tests.
+ */
+namespace image
+{
+
+namespace kernel
+{
+
+namespace detail
+{
+
+// Linear interpolation of two bytes, lerp is a 16.16 fixed point fraction
+inline std::uint8_t lerpByte(int a, int b, std::size_t lerp)
+{
+    return static_cast<std::uint8_t>((((b - a) * static_cast<int>(lerp)) >> 16) + a);
+}
+
+// Calculates the output pixel of the horizontal resampling at the 16.16 fixed point source position f
+inline void resamplePixel(const std::uint8_t* in, std::uint8_t* out, std::size_t f, std::size_t endx)
+{
+    auto xi = f >> 16;
+    const auto* pixel = in + xi * 4;
+
+    if (xi < endx)
+    {
+        auto lerp = f & 0xFFFF;
+
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            out[c] = lerpByte(pixel[c], pixel[c + 4], lerp);
+        }
+    }
+    else // last pixel of the line has no pixel to lerp to
+    {
+        std::memcpy(out, pixel, 4);
+    }
+}
+
+// Average of two bytes, rounding halves to even like lrint() does
+inline std::uint8_t averageByte(int a, int b)
+{
+    auto sum = a + b;
+    return static_cast<std::uint8_t>((sum + ((sum >> 1) & 1)) >> 1);
+}
+
+// Encodes the normal of the given height gradient into out
+inline void encodeNormal(int du, int dv, float factor, std::uint8_t* out)
+{
+    auto nx = static_cast<float>(-du) * factor;
+    auto ny = static_cast<float>(-dv) * factor;
+
+    auto norm = 1.0f / std::sqrt(nx * nx + ny * ny + 1.0f);
+
+    out[0] = static_cast<std::uint8_t>(std::lrint((nx * norm + 1.0f) * 127.5f));
+    out[1] = static_cast<std::uint8_t>(std::lrint((ny * norm + 1.0f) * 127.5f));
+    out[2] = static_cast<std::uint8_t>(std::lrint((norm + 1.0f) * 127.5f));
+    out[3] = 255;
+}
+
+// Returns the given coordinate wrapped around at the image borders
+inline std::size_t wrap(std::size_t coord, int offset, std::size_t size)
+{
+    return (coord + size + offset) % size;
+}
+
+// The bilinear resampling shared by the scalar and the vectorised kernel
+template<typename ResampleLineFunc, typename LerpRowsFunc>
+void resample(const std::uint8_t* in, std::size_t inwidth, std::size_t inheight,
+              std::uint8_t* out, std::size_t outwidth, std::size_t outheight,
+              ResampleLineFunc resampleLine, LerpRowsFunc lerpRows)
+{
+    const auto inStride = inwidth * 4;
+    const auto outStride = outwidth * 4;
+
+    // The two horizontally resampled source rows the output rows are interpolated from
+    thread_local std::vector<std::uint8_t> rows;
+    rows.resize(outStride * 2);
+
+    auto* row1 = rows.data();
+    auto* row2 = row1 + outStride;
+
+    auto fstep = static_cast<std::size_t>(inheight * 65536.0f / outheight);
+    auto endy = inheight - 1;
+    std::size_t oldy = 0;
+
+    resampleLine(in, row1, inwidth, outwidth);
+
+    if (inheight > 1)
+    {
+        resampleLine(in + inStride, row2, inwidth, outwidth);
+    }
+
+    for (std::size_t i = 0, f = 0; i < outheight; ++i, f += fstep, out += outStride)
+    {
+        auto yi = f >> 16;
+
+        if (yi != oldy)
+        {
+            const auto* inRow = in + inStride * yi;
+
+            // Moving on by one row, the previous second row is the new first one
+            if (yi == oldy + 1)
+            {
+                std::swap(row1, row2);
+            }
+            else
+            {
+                resampleLine(inRow, row1, inwidth, outwidth);
+            }
+
+            if (yi < endy)
+            {
+                resampleLine(inRow + inStride, row2, inwidth, outwidth);
+            }
+
+            oldy = yi;
+        }
+
+        if (yi < endy)
+        {
+            lerpRows(row1, row2, out, outStride, f & 0xFFFF);
+        }
+        else
+        {
+            std::memcpy(out, row1, outStride);
+        }
+    }
+}
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+
+inline __m128i load(const std::uint8_t* pixels)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+}
+
+inline void store(std::uint8_t* pixels, __m128i value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), value);
+}
+
+// Multiplies the signed 16-bit differences with the 16.16 fractions (0..0xFFFF) and
+// shifts the result right by 16 bits. _mm_mulhi_epi16 treats fractions >= 0x8000 as
+// negative numbers, which is compensated by adding the difference once more.
+inline __m128i mulFraction(__m128i difference, __m128i fraction)
+{
+    return _mm_add_epi16(_mm_mulhi_epi16(difference, fraction),
+        _mm_and_si128(difference, _mm_srai_epi16(fraction, 15)));
+}
+
+// Sums the 16-bit channels of neighbouring pixels, low = [P0, P1], high = [P2, P3] => [P0 + P1, P2 + P3]
+inline __m128i sumPixelPairs(__m128i low, __m128i high)
+{
+    return _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+}
+
+// Average of the 16-bit channels, rounding halves to even
+inline __m128i averageRoundEven(__m128i sum)
+{
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_and_si128(_mm_srli_epi16(sum, 1), _mm_set1_epi16(1))), 1);
+}
+
+#endif
+
+#if defined(IMAGEKERNELS_USE_AVX2)
+
+inline __m256i load256(const std::uint8_t* pixels)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels));
+}
+
+inline void store256(std::uint8_t* pixels, __m256i value)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels), value);
+}
+
+#endif
+
+} // namespace detail
+
+/**
+ * Reference implementations, producing the same pixels as the
+ * vectorised kernels of the same name.
+ */
+namespace scalar
+{
+
+// Interpolates between two rows of bytes, lerp is a 16.16 fixed point fraction (0..0xFFFF)
+inline void lerpRows(const std::uint8_t* row1, const std::uint8_t* row2, std::uint8_t* out,
+                     std::size_t numBytes, std::size_t lerp)
+{
+    for (std::size_t i = 0; i < numBytes; ++i)
+    {
+        out[i] = detail::lerpByte(row1[i], row2[i], lerp);
+    }
+}
+
+// Linearly resamples a row of inwidth pixels to outwidth pixels
+inline void resampleLine(const std::uint8_t* in, std::uint8_t* out, std::size_t inwidth, std::size_t outwidth)
+{
+    auto fstep = static_cast<std::size_t>(inwidth * 65536.0f / outwidth);
+    auto endx = inwidth - 1;
+
+    for (std::size_t j = 0, f = 0; j < outwidth; ++j, f += fstep, out += 4)
+    {
+        detail::resamplePixel(in, out, f, endx);
+    }
+}
+
+// Bilinearly resamples an image to the given dimensions
+inline void resample(const std::uint8_t* in, std::size_t inwidth, std::size_t inheight,
+                     std::uint8_t* out, std::size_t outwidth, std::size_t outheight)
+{
+    detail::resample(in, inwidth, inheight, out, outwidth, outheight, resampleLine, lerpRows);
+}
+
+// Halves the width and/or the height of the image using a box filter, depending on
+// which of the destination dimensions is smaller. in can be the same as out.
+inline void mipReduce(const std::uint8_t* in, std::uint8_t* out,
+                      std::size_t width, std::size_t height,
+                      std::size_t destwidth, std::size_t destheight)
+{
+    auto width2 = width >> 1;
+    auto height2 = height >> 1;
+    auto nextrow = width * 4;
+
+    if (width > destwidth && height > destheight)
+    {
+        for (std::size_t y = 0; y < height2; ++y, in += nextrow) // skip a line
+        {
+            for (std::size_t x = 0; x < width2; ++x, in += 8, out += 4)
+            {
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    out[c] = static_cast<std::uint8_t>((in[c] + in[c + 4] + in[nextrow + c] + in[nextrow + c + 4]) >> 2);
+                }
+            }
+        }
+    }
+    else if (width > destwidth)
+    {
+        for (std::size_t y = 0; y < height; ++y)
+        {
+            for (std::size_t x = 0; x < width2; ++x, in += 8, out += 4)
+            {
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    out[c] = static_cast<std::uint8_t>((in[c] + in[c + 4]) >> 1);
+                }
+            }
+        }
+    }
+    else if (height > destheight)
+    {
+        for (std::size_t y = 0; y < height2; ++y, in += nextrow) // skip a line
+        {
+            for (std::size_t x = 0; x < width; ++x, in += 4, out += 4)
+            {
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    out[c] = static_cast<std::uint8_t>((in[c] + in[nextrow + c]) >> 1);
+                }
+            }
+        }
+    }
+}
+
+// Replaces the RGB channels using the given table, alpha is left untouched
+inline void applyLookupTable(std::uint8_t* pixels, std::size_t numPixels, const std::uint8_t* table)
+{
+    for (std::size_t i = 0; i < numPixels; ++i, pixels += 4)
+    {
+        pixels[0] = table[pixels[0]];
+        pixels[1] = table[pixels[1]];
+        pixels[2] = table[pixels[2]];
+    }
+}
+
+// RGB = 255 - RGB
+inline void invertColour(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    for (std::size_t i = 0; i < numPixels; ++i, in += 4, out += 4)
+    {
+        out[0] = 255 - in[0];
+        out[1] = 255 - in[1];
+        out[2] = 255 - in[2];
+        out[3] = in[3];
+    }
+}
+
+// A = 255 - A
+inline void invertAlpha(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    for (std::size_t i = 0; i < numPixels; ++i, in += 4, out += 4)
+    {
+        out[0] = in[0];
+        out[1] = in[1];
+        out[2] = in[2];
+        out[3] = 255 - in[3];
+    }
+}
+
+// RGBA = R
+inline void makeIntensity(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    for (std::size_t i = 0; i < numPixels; ++i, in += 4, out += 4)
+    {
+        out[0] = in[0];
+        out[1] = in[0];
+        out[2] = in[0];
+        out[3] = in[0];
+    }
+}
+
+// RGB = 255, A = average of RGB
+inline void makeAlpha(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    for (std::size_t i = 0; i < numPixels; ++i, in += 4, out += 4)
+    {
+        out[0] = 255;
+        out[1] = 255;
+        out[2] = 255;
+        out[3] = static_cast<std::uint8_t>((in[0] + in[1] + in[2]) / 3);
+    }
+}
+
+// Average of the two images, halves are rounded to even
+inline void average(const std::uint8_t* one, const std::uint8_t* two, std::uint8_t* out, std::size_t numPixels)
+{
+    for (std::size_t i = 0; i < numPixels * 4; ++i)
+    {
+        out[i] = detail::averageByte(one[i], two[i]);
+    }
+}
+
+// Average of the two normal maps, halves are rounded to even. The result is opaque.
+inline void averageNormals(const std::uint8_t* one, const std::uint8_t* two, std::uint8_t* out, std::size_t numPixels)
+{
+    for (std::size_t i = 0; i < numPixels; ++i, one += 4, two += 4, out += 4)
+    {
+        out[0] = detail::averageByte(one[0], two[0]);
+        out[1] = detail::averageByte(one[1], two[1]);
+        out[2] = detail::averageByte(one[2], two[2]);
+        out[3] = 255;
+    }
+}
+
+// Averages the RGB channels of each pixel and its eight neighbours, wrapping around
+// at the borders. The result is opaque.
+inline void smoothNormals(const std::uint8_t* in, std::uint8_t* out, std::size_t width, std::size_t height)
+{
+    for (std::size_t y = 0; y < height; ++y)
+    {
+        for (std::size_t x = 0; x < width; ++x, out += 4)
+        {
+            int sum[3] = { 0, 0, 0 };
+
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    const auto* pixel = in + (detail::wrap(y, dy, height) * width + detail::wrap(x, dx, width)) * 4;
+
+                    sum[0] += pixel[0];
+                    sum[1] += pixel[1];
+                    sum[2] += pixel[2];
+                }
+            }
+
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                out[c] = static_cast<std::uint8_t>(std::lrint(sum[c] * static_cast<double>(1.0f / 9)));
+            }
+
+            out[3] = 255;
+        }
+    }
+}
+
+// Derives a normal map from the red channel of the given height map, using a 3x3
+// Prewitt filter that wraps around at the borders
+inline void createNormalMap(const std::uint8_t* in, std::uint8_t* out, std::size_t width, std::size_t height, float scale)
+{
+    auto factor = scale / 255.0f;
+
+    auto getHeight = [&](std::size_t x, std::size_t y, int dx, int dy)
+    {
+        return static_cast<int>(in[(detail::wrap(y, dy, height) * width + detail::wrap(x, dx, width)) * 4]);
+    };
+
+    for (std::size_t y = 0; y < height; ++y)
+    {
+        for (std::size_t x = 0; x < width; ++x, out += 4)
+        {
+            int du = 0;
+            int dv = 0;
+
+            for (int d = -1; d <= 1; ++d)
+            {
+                du += getHeight(x, y, 1, d) - getHeight(x, y, -1, d);
+                dv += getHeight(x, y, d, 1) - getHeight(x, y, d, -1);
+            }
+
+            detail::encodeNormal(du, dv, factor, out);
+        }
+    }
+}
+
+} // namespace scalar
+
+// Interpolates between two rows of bytes, lerp is a 16.16 fixed point fraction (0..0xFFFF)
+inline void lerpRows(const std::uint8_t* row1, const std::uint8_t* row2, std::uint8_t* out,
+                     std::size_t numBytes, std::size_t lerp)
+{
+    std::size_t i = 0;
+
+#if defined(IMAGEKERNELS_USE_AVX2)
+    {
+        const auto zero = _mm256_setzero_si256();
+        const auto fraction = _mm256_set1_epi16(static_cast<short>(lerp));
+        const auto correction = _mm256_srai_epi16(fraction, 15);
+
+        for (; i + 32 <= numBytes; i += 32)
+        {
+            auto a = detail::load256(row1 + i);
+            auto b = detail::load256(row2 + i);
+
+            auto aLow = _mm256_unpacklo_epi8(a, zero);
+            auto aHigh = _mm256_unpackhi_epi8(a, zero);
+            auto dLow = _mm256_sub_epi16(_mm256_unpacklo_epi8(b, zero), aLow);
+            auto dHigh = _mm256_sub_epi16(_mm256_unpackhi_epi8(b, zero), aHigh);
+
+            auto low = _mm256_add_epi16(_mm256_add_epi16(_mm256_mulhi_epi16(dLow, fraction),
+                _mm256_and_si256(dLow, correction)), aLow);
+            auto high = _mm256_add_epi16(_mm256_add_epi16(_mm256_mulhi_epi16(dHigh, fraction),
+                _mm256_and_si256(dHigh, correction)), aHigh);
+
+            detail::store256(out + i, _mm256_packus_epi16(low, high));
+        }
+    }
+#endif
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto fraction = _mm_set1_epi16(static_cast<short>(lerp));
+
+        for (; i + 16 <= numBytes; i += 16)
+        {
+            auto a = detail::load(row1 + i);
+            auto b = detail::load(row2 + i);
+
+            auto aLow = _mm_unpacklo_epi8(a, zero);
+            auto aHigh = _mm_unpackhi_epi8(a, zero);
+
+            auto low = _mm_add_epi16(detail::mulFraction(_mm_sub_epi16(_mm_unpacklo_epi8(b, zero), aLow), fraction), aLow);
+            auto high = _mm_add_epi16(detail::mulFraction(_mm_sub_epi16(_mm_unpackhi_epi8(b, zero), aHigh), fraction), aHigh);
+
+            detail::store(out + i, _mm_packus_epi16(low, high));
+        }
+    }
+#endif
+
+    scalar::lerpRows(row1 + i, row2 + i, out + i, numBytes - i, lerp);
+}
+
+// Linearly resamples a row of inwidth pixels to outwidth pixels
+inline void resampleLine(const std::uint8_t* in, std::uint8_t* out, std::size_t inwidth, std::size_t outwidth)
+{
+    auto fstep = static_cast<std::size_t>(inwidth * 65536.0f / outwidth);
+    auto endx = inwidth - 1;
+
+    std::size_t j = 0;
+    std::size_t f = 0;
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+    {
+        const auto zero = _mm_setzero_si128();
+
+        // Two output pixels at a time, as long as both of them have a right neighbour to lerp to
+        for (; j + 2 <= outwidth && ((f + fstep) >> 16) < endx; j += 2, f += fstep * 2, out += 8)
+        {
+            auto f2 = f + fstep;
+
+            // The source pixel and its right neighbour, expanded to 16 bits per channel
+            auto first = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + (f >> 16) * 4)), zero);
+            auto second = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + (f2 >> 16) * 4)), zero);
+
+            auto left = _mm_unpacklo_epi64(first, second);
+            auto right = _mm_unpackhi_epi64(first, second);
+
+            auto l1 = static_cast<short>(f & 0xFFFF);
+            auto l2 = static_cast<short>(f2 & 0xFFFF);
+            auto fraction = _mm_set_epi16(l2, l2, l2, l2, l1, l1, l1, l1);
+
+            auto result = _mm_add_epi16(detail::mulFraction(_mm_sub_epi16(right, left), fraction), left);
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(result, result));
+        }
+    }
+#endif
+
+    for (; j < outwidth; ++j, f += fstep, out += 4)
+    {
+        detail::resamplePixel(in, out, f, endx);
+    }
+}
+
+// Bilinearly resamples an image to the given dimensions
+inline void resample(const std::uint8_t* in, std::size_t inwidth, std::size_t inheight,
+                     std::uint8_t* out, std::size_t outwidth, std::size_t outheight)
+{
+    detail::resample(in, inwidth, inheight, out, outwidth, outheight, resampleLine, lerpRows);
+}
+
+// Halves the width and/or the height of the image using a box filter, depending on
+// which of the destination dimensions is smaller. in can be the same as out.
+inline void mipReduce(const std::uint8_t* in, std::uint8_t* out,
+                      std::size_t width, std::size_t height,
+                      std::size_t destwidth, std::size_t destheight)
+{
+#if defined(IMAGEKERNELS_USE_SSE2)
+    // Each iteration reads its input before writing output, which
+    // is never ahead of the input, so in-place reduction works
+    const auto zero = _mm_setzero_si128();
+    auto width2 = width >> 1;
+    auto height2 = height >> 1;
+    auto nextrow = width * 4;
+
+    if (width > destwidth && height > destheight)
+    {
+        for (std::size_t y = 0; y < height2; ++y)
+        {
+            const auto* row = in + y * (width2 * 8 + nextrow);
+            auto* outRow = out + y * width2 * 4;
+            std::size_t x = 0;
+
+            // Four output pixels from 4x2 pixel blocks
+            for (; x + 4 <= width2; x += 4)
+            {
+                const auto* block = row + x * 8;
+
+                auto a1 = detail::load(block);
+                auto a2 = detail::load(block + 16);
+                auto b1 = detail::load(block + nextrow);
+                auto b2 = detail::load(block + nextrow + 16);
+
+                auto first = detail::sumPixelPairs(
+                    _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero)),
+                    _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero)));
+                auto second = detail::sumPixelPairs(
+                    _mm_add_epi16(_mm_unpacklo_epi8(a2, zero), _mm_unpacklo_epi8(b2, zero)),
+                    _mm_add_epi16(_mm_unpackhi_epi8(a2, zero), _mm_unpackhi_epi8(b2, zero)));
+
+                detail::store(outRow + x * 4, _mm_packus_epi16(_mm_srli_epi16(first, 2), _mm_srli_epi16(second, 2)));
+            }
+
+            // The remainder of the row
+            for (; x < width2; ++x)
+            {
+                const auto* block = row + x * 8;
+
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    outRow[x * 4 + c] = static_cast<std::uint8_t>(
+                        (block[c] + block[c + 4] + block[nextrow + c] + block[nextrow + c + 4]) >> 2);
+                }
+            }
+        }
+
+        return;
+    }
+
+    if (width > destwidth)
+    {
+        for (std::size_t y = 0; y < height; ++y)
+        {
+            const auto* row = in + y * width2 * 8;
+            auto* outRow = out + y * width2 * 4;
+            std::size_t x = 0;
+
+            for (; x + 4 <= width2; x += 4)
+            {
+                auto a1 = detail::load(row + x * 8);
+                auto a2 = detail::load(row + x * 8 + 16);
+
+                auto first = detail::sumPixelPairs(_mm_unpacklo_epi8(a1, zero), _mm_unpackhi_epi8(a1, zero));
+                auto second = detail::sumPixelPairs(_mm_unpacklo_epi8(a2, zero), _mm_unpackhi_epi8(a2, zero));
+
+                detail::store(outRow + x * 4, _mm_packus_epi16(_mm_srli_epi16(first, 1), _mm_srli_epi16(second, 1)));
+            }
+
+            for (; x < width2; ++x)
+            {
+                for (std::size_t c = 0; c < 4; ++c)
+                {
+                    outRow[x * 4 + c] = static_cast<std::uint8_t>((row[x * 8 + c] + row[x * 8 + c + 4]) >> 1);
+                }
+            }
+        }
+
+        return;
+    }
+
+    if (height > destheight)
+    {
+        for (std::size_t y = 0; y < height2; ++y)
+        {
+            const auto* row = in + y * nextrow * 2;
+            auto* outRow = out + y * nextrow;
+            std::size_t i = 0;
+
+            for (; i + 16 <= nextrow; i += 16)
+            {
+                auto a = detail::load(row + i);
+                auto b = detail::load(row + nextrow + i);
+
+                auto low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                auto high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                detail::store(outRow + i, _mm_packus_epi16(_mm_srli_epi16(low, 1), _mm_srli_epi16(high, 1)));
+            }
+
+            for (; i < nextrow; ++i)
+            {
+                outRow[i] = static_cast<std::uint8_t>((row[i] + row[nextrow + i]) >> 1);
+            }
+        }
+    }
+#else
+    scalar::mipReduce(in, out, width, height, destwidth, destheight);
+#endif
+}
+
+// Replaces the RGB channels using the given table, alpha is left untouched.
+// Neither SSE2 nor AVX2 can look up bytes efficiently, this is not vectorised.
+inline void applyLookupTable(std::uint8_t* pixels, std::size_t numPixels, const std::uint8_t* table)
+{
+    scalar::applyLookupTable(pixels, numPixels, table);
+}
+
+// RGB = 255 - RGB
+inline void invertColour(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    std::size_t i = 0;
+
+#if defined(IMAGEKERNELS_USE_AVX2)
+    {
+        const auto mask = _mm256_set1_epi32(0x00FFFFFF);
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            detail::store256(out + i * 4, _mm256_xor_si256(detail::load256(in + i * 4), mask));
+        }
+    }
+#endif
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+    {
+        const auto mask = _mm_set1_epi32(0x00FFFFFF);
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            detail::store(out + i * 4, _mm_xor_si128(detail::load(in + i * 4), mask));
+        }
+    }
+#endif
+
+    scalar::invertColour(in + i * 4, out + i * 4, numPixels - i);
+}
+
+// A = 255 - A
+inline void invertAlpha(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    std::size_t i = 0;
+
+#if defined(IMAGEKERNELS_USE_AVX2)
+    {
+        const auto mask = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            detail::store256(out + i * 4, _mm256_xor_si256(detail::load256(in + i * 4), mask));
+        }
+    }
+#endif
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+    {
+        const auto mask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            detail::store(out + i * 4, _mm_xor_si128(detail::load(in + i * 4), mask));
+        }
+    }
+#endif
+
+    scalar::invertAlpha(in + i * 4, out + i * 4, numPixels - i);
+}
+
+// RGBA = R
+inline void makeIntensity(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    std::size_t i = 0;
+
+#if defined(IMAGEKERNELS_USE_AVX2)
+    {
+        const auto red = _mm256_set1_epi32(0xFF);
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto value = _mm256_and_si256(detail::load256(in + i * 4), red);
+            value = _mm256_or_si256(value, _mm256_slli_epi32(value, 8));
+            value = _mm256_or_si256(value, _mm256_slli_epi32(value, 16));
+
+            detail::store256(out + i * 4, value);
+        }
+    }
+#endif
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+    {
+        const auto red = _mm_set1_epi32(0xFF);
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            auto value = _mm_and_si128(detail::load(in + i * 4), red);
+            value = _mm_or_si128(value, _mm_slli_epi32(value, 8));
+            value = _mm_or_si128(value, _mm_slli_epi32(value, 16));
+
+            detail::store(out + i * 4, value);
+        }
+    }
+#endif
+
+    scalar::makeIntensity(in + i * 4, out + i * 4, numPixels - i);
+}
+
+// RGB = 255, A = average of RGB
+inline void makeAlpha(const std::uint8_t* in, std::uint8_t* out, std::size_t numPixels)
+{
+    std::size_t i = 0;
+
+    // The channel sums (at most 765) are divided by 3 by multiplying them
+    // with 65536 * 2 / 3 and shifting by 17 bits, which is exact in this range
+
+#if defined(IMAGEKERNELS_USE_AVX2)
+    {
+        const auto channel = _mm256_set1_epi32(0xFF);
+        const auto oneThird = _mm256_set1_epi32(43691);
+        const auto white = _mm256_set1_epi32(0x00FFFFFF);
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto pixels = detail::load256(in + i * 4);
+
+            auto sum = _mm256_add_epi32(_mm256_add_epi32(_mm256_and_si256(pixels, channel),
+                _mm256_and_si256(_mm256_srli_epi32(pixels, 8), channel)),
+                _mm256_and_si256(_mm256_srli_epi32(pixels, 16), channel));
+
+            auto alpha = _mm256_srli_epi16(_mm256_mulhi_epu16(sum, oneThird), 1);
+
+            detail::store256(out + i * 4, _mm256_or_si256(_mm256_slli_epi32(alpha, 24), white));
+        }
+    }
+#endif
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+    {
+        const auto channel = _mm_set1_epi32(0xFF);
+        const auto oneThird = _mm_set1_epi32(43691);
+        const auto white = _mm_set1_epi32(0x00FFFFFF);
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            auto pixels = detail::load(in + i * 4);
+
+            auto sum = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(pixels, channel),
+                _mm_and_si128(_mm_srli_epi32(pixels, 8), channel)),
+                _mm_and_si128(_mm_srli_epi32(pixels, 16), channel));
+
+            auto alpha = _mm_srli_epi16(_mm_mulhi_epu16(sum, oneThird), 1);
+
+            detail::store(out + i * 4, _mm_or_si128(_mm_slli_epi32(alpha, 24), white));
+        }
+    }
+#endif
+
+    scalar::makeAlpha(in + i * 4, out + i * 4, numPixels - i);
+}
+
+namespace detail
+{
+
+// Averages the pixels, optionally making the result opaque
+template<bool Opaque>
+inline std::size_t averageVectorised(const std::uint8_t* one, const std::uint8_t* two, std::uint8_t* out, std::size_t numPixels)
+{
+    std::size_t i = 0;
+
+#if defined(IMAGEKERNELS_USE_AVX2)
+    {
+        const auto zero = _mm256_setzero_si256();
+        const auto lowestBit = _mm256_set1_epi16(1);
+        const auto alpha = _mm256_set1_epi32(Opaque ? static_cast<int>(0xFF000000u) : 0);
+
+        auto averageRoundEven = [&](__m256i sum)
+        {
+            return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_and_si256(_mm256_srli_epi16(sum, 1), lowestBit)), 1);
+        };
+
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto a = load256(one + i * 4);
+            auto b = load256(two + i * 4);
+
+            auto low = averageRoundEven(_mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)));
+            auto high = averageRoundEven(_mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)));
+
+            store256(out + i * 4, _mm256_or_si256(_mm256_packus_epi16(low, high), alpha));
+        }
+    }
+#endif
+
+#if defined(IMAGEKERNELS_USE_SSE2)
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto alpha = _mm_set1_epi32(Opaque ? static_cast<int>(0xFF000000u) : 0);
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            auto a = load(one + i * 4);
+            auto b = load(two + i * 4);
+
+            auto low = averageRoundEven(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+            auto high = averageRoundEven(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+
+            store(out + i * 4, _mm_or_si128(_mm_packus_epi16(low, high), alpha));
+        }
+    }
+#endif
+
+    return i;
+}
+
+} // namespace detail
+
+// Average of the two images, halves are rounded to even
+inline void average(const std::uint8_t* one, const std::uint8_t* two, std::uint8_t* out, std::size_t numPixels)
+{
+    auto i = detail::averageVectorised<false>(one, two, out, numPixels);
+    scalar::average(one + i * 4, two + i * 4, out + i * 4, numPixels - i);
+}
+
+// Average of the two normal maps, halves are rounded to even. The result is opaque.
+inline void averageNormals(const std::uint8_t* one, const std::uint8_t* two, std::uint8_t* out, std::size_t numPixels)
+{
+    auto i = detail::averageVectorised<true>(one, two, out, numPixels);
+    scalar::averageNormals(one + i * 4, two + i * 4, out + i * 4, numPixels - i);
+}
+
+// Averages the RGB channels of each pixel and its eight neighbours, wrapping around
+// at the borders. The result is opaque.
+inline void smoothNormals(const std::uint8_t* in, std::uint8_t* out, std::size_t width, std::size_t height)
+{
+#if defined(IMAGEKERNELS_USE_SSE2)
+    const auto stride = width * 4;
+
+    // The channels summed over three rows, padded by one wrapped pixel on either side
+    thread_local std::vector<std::uint16_t> columns;
+    columns.resize((width + 2) * 4);
+
+    auto* sums = columns.data() + 4;
+
+    const auto zero = _mm_setzero_si128();
+    const auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+    // Dividing by 9 after adding 4 rounds the sum / 9 to the nearest integer, like the scalar
+    // version does. The division is done by multiplying with 65536 / 9, which is exact for
+    // sums up to 9 * 255 + 4.
+    const auto rounding = _mm_set1_epi16(4);
+    const auto oneNinth = _mm_set1_epi16(7282);
+
+    for (std::size_t y = 0; y < height; ++y, out += stride)
+    {
+        const auto* above = in + detail::wrap(y, -1, height) * stride;
+        const auto* row = in + y * stride;
+        const auto* below = in + detail::wrap(y, 1, height) * stride;
+
+        std::size_t i = 0;
+
+        for (; i < stride / 16 * 16; i += 16)
+        {
+            auto a = detail::load(above + i);
+            auto b = detail::load(row + i);
+            auto c = detail::load(below + i);
+
+            auto low = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)), _mm_unpacklo_epi8(c, zero));
+            auto high = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)), _mm_unpackhi_epi8(c, zero));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i + 8), high);
+        }
+
+        for (; i < stride; ++i)
+        {
+            sums[i] = static_cast<std::uint16_t>(above[i] + row[i] + below[i]);
+        }
+
+        std::memcpy(columns.data(), sums + stride - 4, 4 * sizeof(std::uint16_t));
+        std::memcpy(sums + stride, sums, 4 * sizeof(std::uint16_t));
+
+        // Sum up the neighbouring columns, two pixels at a time
+        std::size_t x = 0;
+
+        for (; x + 2 <= width; x += 2)
+        {
+            const auto* left = columns.data() + x * 4;
+
+            auto sum = _mm_add_epi16(_mm_add_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(left)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + 4))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + 8)));
+
+            auto result = _mm_mulhi_epu16(_mm_add_epi16(sum, rounding), oneNinth);
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_or_si128(_mm_packus_epi16(result, result), alpha));
+        }
+
+        for (; x < width; ++x)
+        {
+            const auto* left = columns.data() + x * 4;
+
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                out[x * 4 + c] = static_cast<std::uint8_t>((left[c] + left[c + 4] + left[c + 8] + 4) / 9);
+            }
+
+            out[x * 4 + 3] = 255;
+        }
+    }
+#else
+    scalar::smoothNormals(in, out, width, height);
+#endif
+}
+
+// Derives a normal map from the red channel of the given height map, using a 3x3
+// Prewitt filter that wraps around at the borders
+inline void createNormalMap(const std::uint8_t* in, std::uint8_t* out, std::size_t width, std::size_t height, float scale)
+{
+#if defined(IMAGEKERNELS_USE_SSE2)
+    const auto stride = width * 4;
+    const auto factor = scale / 255.0f;
+
+    // Per column of the current row, padded by one wrapped column on either side:
+    // the sum of the heights of the three rows and the height difference between the row below and above
+    thread_local std::vector<int> columns;
+    columns.resize((width + 2) * 2);
+
+    auto* heightSums = columns.data();
+    auto* heightDiffs = heightSums + width + 2;
+
+    const auto factors = _mm_set1_ps(factor);
+    const auto one = _mm_set1_ps(1.0f);
+    const auto halfRange = _mm_set1_ps(127.5f);
+    const auto zero = _mm_setzero_si128();
+    const auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+    for (std::size_t y = 0; y < height; ++y, out += stride)
+    {
+        const auto* above = in + detail::wrap(y, -1, height) * stride;
+        const auto* row = in + y * stride;
+        const auto* below = in + detail::wrap(y, 1, height) * stride;
+
+        for (std::size_t x = 0; x < width; ++x)
+        {
+            heightSums[x + 1] = above[x * 4] + row[x * 4] + below[x * 4];
+            heightDiffs[x + 1] = below[x * 4] - above[x * 4];
+        }
+
+        heightSums[0] = heightSums[width];
+        heightSums[width + 1] = heightSums[1];
+        heightDiffs[0] = heightDiffs[width];
+        heightDiffs[width + 1] = heightDiffs[1];
+
+        std::size_t x = 0;
+
+        // The same sequence of float operations as detail::encodeNormal(), four pixels at a time
+        for (; x + 4 <= width; x += 4)
+        {
+            auto du = _mm_sub_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(heightSums + x + 2)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(heightSums + x)));
+
+            auto dv = _mm_add_epi32(_mm_add_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(heightDiffs + x)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(heightDiffs + x + 1))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(heightDiffs + x + 2)));
+
+            auto nx = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(zero, du)), factors);
+            auto ny = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(zero, dv)), factors);
+
+            auto norm = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), one)));
+
+            auto red = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(nx, norm), one), halfRange));
+            auto green = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(ny, norm), one), halfRange));
+            auto blue = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(norm, one), halfRange));
+
+            auto pixels = _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 8)),
+                _mm_or_si128(_mm_slli_epi32(blue, 16), alpha));
+
+            detail::store(out + x * 4, pixels);
+        }
+
+        for (; x < width; ++x)
+        {
+            auto du = heightSums[x + 2] - heightSums[x];
+            auto dv = heightDiffs[x] + heightDiffs[x + 1] + heightDiffs[x + 2];
+
+            detail::encodeNormal(du, dv, factor, out + x * 4);
+        }
+    }
+#else
+    scalar::createNormalMap(in, out, width, height, scale);
+#endif
+}
+
+} // namespace kernel
+
+} // namespace image
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#if defined(WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include "string/encoding.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace os
+{
+
+/**
+ * Read-only memory mapping of an entire file. The file contents are
+ * accessible through data() as long as this object is alive, pages are
+ * loaded on demand by the operating system.
+ *
+ * Use failed() to check whether the mapping could be established,
+ * empty files cannot be mapped.
+ */
+class MappedFile
+{
+public:
+    typedef unsigned char byte_type;
+
+private:
+    const byte_type* _data;
+    std::size_t _size;
+
+#if defined(WIN32)
+    HANDLE _file;
+    HANDLE _mapping;
+#endif
+
+public:
+    MappedFile(const std::string& path) :
+        _data(nullptr),
+        _size(0)
+#if defined(WIN32)
+        , _file(INVALID_HANDLE_VALUE),
+        _mapping(nullptr)
+#endif
+    {
+#if defined(WIN32)
+        _file = CreateFileW(string::utf8_to_unicode(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (_file == INVALID_HANDLE_VALUE) return;
+
+        LARGE_INTEGER fileSize;
+
+        if (!GetFileSizeEx(_file, &fileSize) || fileSize.QuadPart == 0) return;
+
+        _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (_mapping == nullptr) return;
+
+        auto view = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+
+        if (view == nullptr) return;
+
+        _data = static_cast<const byte_type*>(view);
+        _size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        auto fd = open(path.c_str(), O_RDONLY);
+
+        if (fd == -1) return;
+
+        struct stat info;
+
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            auto view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (view != MAP_FAILED)
+            {
+                _data = static_cast<const byte_type*>(view);
+                _size = static_cast<std::size_t>(info.st_size);
+            }
+        }
+
+        // The mapping stays valid after closing the descriptor
+        close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    ~MappedFile()
+    {
+#if defined(WIN32)
+        if (_data != nullptr) UnmapViewOfFile(_data);
+        if (_mapping != nullptr) CloseHandle(_mapping);
+        if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+#else
+        if (_data != nullptr) munmap(const_cast<byte_type*>(_data), _size);
+#endif
+    }
+
+    bool failed() const
+    {
+        return _data == nullptr;
+    }
+
+    const byte_type* data() const
+    {
+        return _data;
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+};
+
+}
@@ -2,11 +2,14 @@
 
 #include "ParseException.h"
 
+#include <algorithm>
 #include <iterator>
 #include <iostream>
 #include <ios>
 #include <string>
+#include <string_view>
 #include "string/tokeniser.h"
+#include "string/from_chars.h"
 
 namespace parser
 {
@@ -422,6 +425,25 @@ public:
 	 * next without actually changing the tokeniser's state.
 	 */
 	virtual std::string peek() const = 0;
+
+    /**
+     * Consumes the next token and returns its value as floating point number,
+     * or 0 if the token is not numeric (same as std::atof).
+     * Buffer-based tokenisers override this to avoid the string copy.
+     */
+    virtual double nextDouble()
+    {
+        return string::to_double(nextToken());
+    }
+
+    /**
+     * Consumes the next token and returns its value as unsigned integer,
+     * returns the given default value if the token is not numeric.
+     */
+    virtual std::size_t nextUnsigned(std::size_t defaultValue = 0)
+    {
+        return string::to_unsigned(nextToken(), defaultValue);
+    }
 };
 
 /**
@@ -610,4 +632,383 @@ public:
 	}
 };
 
+/**
+ * Specialisation of DefTokeniser working on a contiguous block of memory,
+ * like a fully loaded or memory-mapped file. The memory is not owned by the
+ * tokeniser and needs to stay valid for its lifetime.
+ *
+ * Tokens are returned as std::string_view pointing into the buffer, no copies
+ * are made except for quoted tokens containing escape sequences or backslash
+ * continuations. The tokenising rules are the same as in DefTokeniserFunc,
+ * the default delimiters match the std::istream specialisation.
+ */
+template<>
+class BasicDefTokeniser<std::string_view> :
+	public DefTokeniser
+{
+private:
+    enum CharClass : unsigned char
+    {
+        Regular = 0,
+        Delimiter = 1,
+        KeptDelimiter = 2,
+    };
+
+    // Lookup table with a CharClass for every character
+    unsigned char _charClass[256];
+
+    const char* _position;
+    const char* _end;
+
+    // The upcoming token, valid if _hasToken is true
+    std::string_view _token;
+    bool _hasToken;
+
+    // Storage for tokens that cannot point into the buffer. Two of them, since
+    // the token returned by nextTokenView() must survive the following lookahead.
+    std::string _scratch[2];
+    std::size_t _currentScratch;
+
+public:
+    /**
+     * Construct a DefTokeniser working on the given buffer, and optionally
+     * a list of separators.
+     *
+     * @param buffer
+     * The memory to tokenise, needs to stay alive while the tokeniser is in use.
+     *
+     * @param delims
+     * The list of characters to use as delimiters.
+     *
+     * @param keptDelims
+     * String of characters to treat as delimiters but return as tokens in their
+     * own right.
+     */
+    BasicDefTokeniser(std::string_view buffer,
+                      const char* delims = WHITESPACE,
+                      const char* keptDelims = "{}(),") :
+        _position(buffer.data()),
+        _end(buffer.data() + buffer.size()),
+        _hasToken(false),
+        _currentScratch(0)
+    {
+        std::fill(_charClass, _charClass + 256, Regular);
+
+        for (auto c = delims; *c != 0; ++c)
+        {
+            _charClass[static_cast<unsigned char>(*c)] = Delimiter;
+        }
+
+        // Delimiters are checked first by DefTokeniserFunc, so they take precedence
+        for (auto c = keptDelims; *c != 0; ++c)
+        {
+            auto& charClass = _charClass[static_cast<unsigned char>(*c)];
+
+            if (charClass == Regular)
+            {
+                charClass = KeptDelimiter;
+            }
+        }
+
+        fetchToken();
+    }
+
+    // Tokens might point into the scratch buffers
+    BasicDefTokeniser(const BasicDefTokeniser& other) = delete;
+    BasicDefTokeniser& operator=(const BasicDefTokeniser& other) = delete;
+
+    bool hasMoreTokens() const override
+    {
+        return _hasToken;
+    }
+
+    std::string nextToken() override
+    {
+        return std::string(nextTokenView());
+    }
+
+    /**
+     * Returns the next token and advances to the following one. The returned
+     * view is valid until the next call to any of the next*() methods.
+     */
+    std::string_view nextTokenView()
+    {
+        if (!_hasToken)
+        {
+            throw ParseException("DefTokeniser: no more tokens");
+        }
+
+        auto token = _token;
+
+        // Any materialised lookahead token goes to the other scratch buffer
+        _currentScratch ^= 1;
+        fetchToken();
+
+        return token;
+    }
+
+    std::string peek() const override
+    {
+        if (!_hasToken)
+        {
+            throw ParseException("DefTokeniser: no more tokens");
+        }
+
+        return std::string(_token);
+    }
+
+    void assertNextToken(const std::string& val) override
+    {
+        auto token = nextTokenView();
+
+        if (token != val)
+        {
+            throw ParseException("DefTokeniser: Assertion failed: Required \""
+                + val + "\", found \"" + std::string(token) + "\"");
+        }
+    }
+
+    void skipTokens(unsigned int n) override
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            nextTokenView();
+        }
+    }
+
+    double nextDouble() override
+    {
+        return string::to_double(nextTokenView());
+    }
+
+    std::size_t nextUnsigned(std::size_t defaultValue = 0) override
+    {
+        return string::to_unsigned(nextTokenView(), defaultValue);
+    }
+
+private:
+    bool isDelim(char c) const
+    {
+        return _charClass[static_cast<unsigned char>(c)] == Delimiter;
+    }
+
+    bool isKeptDelim(char c) const
+    {
+        return _charClass[static_cast<unsigned char>(c)] == KeptDelimiter;
+    }
+
+    // Moves the given pointer past the end of the line comment, including the line break
+    const char* skipLineComment(const char* p) const
+    {
+        while (p != _end && *p != '\r' && *p != '\n') ++p;
+
+        return p != _end ? p + 1 : p;
+    }
+
+    // Moves the given pointer past the closing */ of a delimited comment
+    const char* skipDelimitedComment(const char* p) const
+    {
+        for (; p != _end; ++p)
+        {
+            if (*p == '*' && p + 1 != _end && p[1] == '/')
+            {
+                return p + 2;
+            }
+        }
+
+        return p;
+    }
+
+    // Locates the next token, sets _hasToken to false if there is none
+    void fetchToken()
+    {
+        _hasToken = false;
+
+        auto p = _position;
+
+        while (p != _end)
+        {
+            if (isDelim(*p))
+            {
+                ++p;
+                continue;
+            }
+
+            if (isKeptDelim(*p))
+            {
+                _token = std::string_view(p, 1);
+                _position = p + 1;
+                _hasToken = true;
+                return;
+            }
+
+            if (*p == '/')
+            {
+                // A single slash at the end of the input is dropped
+                if (p + 1 == _end)
+                {
+                    break;
+                }
+
+                if (p[1] == '/')
+                {
+                    p = skipLineComment(p + 2);
+                    continue;
+                }
+
+                if (p[1] == '*')
+                {
+                    p = skipDelimitedComment(p + 2);
+                    continue;
+                }
+            }
+
+            if (*p == '"')
+            {
+                fetchQuotedToken(p + 1);
+            }
+            else
+            {
+                fetchRegularToken(p);
+            }
+            return;
+        }
+
+        _position = _end;
+    }
+
+    // Token starting at the given (non-delimiter, non-quote) character
+    void fetchRegularToken(const char* start)
+    {
+        auto p = start;
+
+        while (p != _end && !isDelim(*p) && !isKeptDelim(*p) && *p != '"')
+        {
+            if (*p == '/' && (p + 1 == _end || p[1] == '/' || p[1] == '*'))
+            {
+                // Comments end the token, the slash at the end of the input is dropped
+                _token = std::string_view(start, p - start);
+                _position = p + 1 == _end ? _end :
+                    p[1] == '/' ? skipLineComment(p + 2) : skipDelimitedComment(p + 2);
+                _hasToken = !_token.empty();
+                return;
+            }
+
+            ++p;
+        }
+
+        _token = std::string_view(start, p - start);
+        _position = p;
+        _hasToken = true;
+    }
+
+    // Quoted token, the given pointer is right after the opening quote
+    void fetchQuotedToken(const char* p)
+    {
+        auto& scratch = _scratch[_currentScratch];
+        auto start = p;
+        auto materialised = false;
+
+        while (true)
+        {
+            while (p != _end && *p != '"' && *p != '\\') ++p;
+
+            if (p == _end)
+            {
+                // Unterminated quote, return what we have if not empty
+                setQuotedToken(start, p, materialised);
+                _position = _end;
+                _hasToken = !_token.empty();
+                return;
+            }
+
+            if (*p == '\\')
+            {
+                // Escape sequence, the token cannot point into the buffer anymore
+                if (!materialised)
+                {
+                    scratch.clear();
+                    materialised = true;
+                }
+
+                scratch.append(start, p);
+
+                if (++p != _end)
+                {
+                    switch (*p)
+                    {
+                    case 'n': scratch += '\n'; break;
+                    case 't': scratch += '\t'; break;
+                    case '"': scratch += '"'; break;
+                    default:
+                        // No special escape sequence, keep the backslash
+                        scratch += '\\';
+                        scratch += *p;
+                    }
+
+                    ++p;
+                }
+
+                start = p;
+                continue;
+            }
+
+            // Closing quote, check for a backslash continuing the string constant
+            auto closingQuote = p++;
+
+            while (p != _end && isDelim(*p)) ++p;
+
+            if (p != _end && *p == '\\')
+            {
+                ++p;
+                while (p != _end && isDelim(*p)) ++p;
+
+                if (!materialised)
+                {
+                    scratch.clear();
+                    materialised = true;
+                }
+
+                scratch.append(start, closingQuote);
+
+                if (p == _end)
+                {
+                    _token = scratch;
+                    _position = _end;
+                    _hasToken = !_token.empty();
+                    return;
+                }
+
+                if (*p != '"')
+                {
+                    throw ParseException("Could not find opening double quote after backslash.");
+                }
+
+                start = ++p;
+                continue;
+            }
+
+            // Even empty quoted strings are valid tokens
+            setQuotedToken(start, closingQuote, materialised);
+            _position = p;
+            _hasToken = true;
+            return;
+        }
+    }
+
+    void setQuotedToken(const char* start, const char* end, bool materialised)
+    {
+        if (materialised)
+        {
+            auto& scratch = _scratch[_currentScratch];
+            scratch.append(start, end);
+            _token = scratch;
+        }
+        else
+        {
+            _token = std::string_view(start, end - start);
+        }
+    }
+};
+
 } // namespace parser
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <memory>
+#include <sstream>
+#include <iterator>
 #include "ifilesystem.h"
 #include "itextstream.h"
 #include "idecltypes.h"
 #include "debugging/ScopedDebugTimer.h"
 #include "parser/ParseException.h"
 #include "parser/ThreadedDefLoader.h"
+#include "util/ParallelFor.h"
 
 namespace parser
 {
@@ -13,6 +17,14 @@ namespace parser
 /**
  * Threaded declaration parser, visiting all files associated to the given
  * decl type, processing the files in the correct order.
+ *
+ * The files are opened by several worker threads at once. Each file is passed
+ * to the thread-safe parseConcurrently() method, the functors it returns are
+ * then invoked on the parser thread in sorted file order, such that the results
+ * are merged in exactly the same order as in a sequential parse. The default
+ * implementation reads the file on the worker and defers the parse() call
+ * to the merge functor, subclasses can override it to do the actual parsing
+ * work on the worker threads.
  */
 template <typename ReturnType>
 class ThreadedDeclParser :
@@ -73,6 +85,21 @@ protected:
     // Parse all decls found in the given stream, to be implemented by subclasses
     virtual void parse(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir) = 0;
 
+    // Parses the given stream on a worker thread, must not modify any shared state.
+    // The returned functor is invoked in sorted file order to merge the parse result.
+    virtual std::function<void()> parseConcurrently(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir)
+    {
+        // Only read the file here, parse() is invoked when merging
+        auto contents = std::make_shared<std::string>(
+            std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+        return [this, contents, fileInfo, modDir]()
+        {
+            std::istringstream contentStream(*contents);
+            parse(contentStream, fileInfo, modDir);
+        };
+    }
+
     void processFiles()
     {
         ScopedDebugTimer timer("[DeclParser] Parsed " + decl::getTypeName(_declType) + " declarations");
@@ -92,24 +119,48 @@ protected:
             return a.name < b.name;
         });
 
-        // Dispatch the sorted list to the protected parse() method
-        for (const auto& fileInfo : _incomingFiles)
+        // Read and parse the files on the worker threads, merging the results in sorted order
+        processFilesConcurrently(_incomingFiles);
+    }
+
+private:
+    void processFilesConcurrently(const std::vector<vfs::FileInfo>& files)
+    {
+        // One merge functor per file, in the same order as the sorted file list
+        std::vector<std::function<void()>> results(files.size());
+
+        util::parallelForDynamic(files.size(), [&](std::size_t index)
         {
+            const auto& fileInfo = files[index];
             auto file = GlobalFileSystem().openTextFile(fileInfo.fullPath());
 
-            if (!file) continue;
+            if (!file) return;
 
             try
             {
-                // Parse entity defs from the file
                 std::istream stream(&file->getInputStream());
-                parse(stream, fileInfo, file->getModName());
+                results[index] = parseConcurrently(stream, fileInfo, file->getModName());
             }
             catch (ParseException& e)
             {
                 rError() << "[DeclParser] Failed to parse " << fileInfo.fullPath()
                     << " (" << e.what() << ")" << std::endl;
             }
+        });
+
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            if (!results[i]) continue;
+
+            try
+            {
+                results[i]();
+            }
+            catch (ParseException& e)
+            {
+                rError() << "[DeclParser] Failed to parse " << files[i].fullPath()
+                    << " (" << e.what() << ")" << std::endl;
+            }
         }
     }
 };
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <stack>
 #include <limits>
+#include <map>
+#include <tuple>
 #include <vector>
 #include "igeometrystore.h"
 #include "itextstream.h"
@@ -30,6 +32,11 @@ struct BufferTransaction
  *
  * Use the allocate/deallocate methods to acquire or release a chunk of
  * a certain size. The chunk size is fixed and cannot be changed.
+ *
+ * Free chunks are kept in an index sorted by size (and offset), allocations
+ * pick the smallest chunk that fits in O(log n). Every slot knows its
+ * neighbours in memory, a released chunk is merged with adjacent free
+ * chunks in constant time.
  */
 template<typename ElementType>
 class ContinuousBuffer
@@ -42,6 +49,8 @@ public:
 private:
     static constexpr std::size_t GrowthRate = 1; // 100% growth each time
 
+    static constexpr Handle InvalidHandle = std::numeric_limits<Handle>::max();
+
     std::vector<ElementType> _buffer;
 
     struct SlotInfo
@@ -50,19 +59,25 @@ private:
         std::size_t Offset; // The index to the first element within the buffer
         std::size_t Size;   // Number of allocated elements
         std::size_t Used;   // Number of used elements
+        Handle Previous;    // The slot located right before this one in the buffer
+        Handle Next;        // The slot located right after this one in the buffer
 
         SlotInfo() :
             Occupied(false),
             Offset(0),
             Size(0),
-            Used(0)
+            Used(0),
+            Previous(InvalidHandle),
+            Next(InvalidHandle)
         {}
 
         SlotInfo(std::size_t offset, std::size_t size, bool occupied) :
             Occupied(occupied),
             Offset(offset),
             Size(size),
-            Used(0)
+            Used(0),
+            Previous(InvalidHandle),
+            Next(InvalidHandle)
         {}
     };
 
@@ -71,6 +86,14 @@ private:
     // A stack of slots that can be re-used instead
     std::stack<Handle> _emptySlots;
 
+    // The free slots, ordered by size first and offset second. Zero-sized slots
+    // can share the same offset, the handle keeps their keys apart.
+    using FreeSlotKey = std::tuple<std::size_t, std::size_t, Handle>;
+    std::map<FreeSlotKey, Handle> _freeSlots;
+
+    // The slot located at the end of the buffer
+    Handle _lastSlot;
+
     // Last data size that was synced to the buffer object
     std::size_t _lastSyncedBufferSize;
 
@@ -95,7 +118,8 @@ public:
         _buffer.resize(initialSize == 0 ? 16 : initialSize);
 
         // The initial slot info which is going to be cut into pieces
-        createSlotInfo(0, _buffer.size());
+        _lastSlot = createSlotInfo(0, _buffer.size());
+        addFreeSlot(_lastSlot);
     }
 
     ContinuousBuffer(const ContinuousBuffer& other)
@@ -113,6 +137,8 @@ public:
         memcpy(_slots.data(), other._slots.data(), other._slots.size() * sizeof(SlotInfo));
 
         _emptySlots = other._emptySlots;
+        _freeSlots = other._freeSlots;
+        _lastSlot = other._lastSlot;
         _unsyncedModifications = other._unsyncedModifications;
         _allocatedElements = other._allocatedElements;
 
@@ -166,6 +192,7 @@ public:
         total += _buffer.capacity() * sizeof(ElementType);
         total += _slots.capacity() * sizeof(SlotInfo);
         total += _emptySlots.size() * sizeof(Handle);
+        total += _freeSlots.size() * (sizeof(typename decltype(_freeSlots)::value_type) + 4 * sizeof(void*)); // tree nodes
         total += _unsyncedModifications.capacity() * sizeof(ModifiedMemoryChunk);
         total += sizeof(ContinuousBuffer<ElementType>);
 
@@ -229,35 +256,49 @@ public:
 
         _allocatedElements -= releasedSlot.Size;
 
-        // Check if the slot can merge with an adjacent one
-        Handle slotIndexToMerge = std::numeric_limits<Handle>::max();
-        if (findLeftFreeSlot(releasedSlot, slotIndexToMerge))
+        // Check if the slot can merge with the adjacent ones
+        auto left = releasedSlot.Previous;
+
+        if (left != InvalidHandle && !_slots[left].Occupied)
         {
-            auto& slotToMerge = _slots[slotIndexToMerge];
+            auto& slotToMerge = _slots[left];
+            removeFreeSlot(left);
 
             releasedSlot.Offset = slotToMerge.Offset;
             releasedSlot.Size += slotToMerge.Size;
+            releasedSlot.Previous = slotToMerge.Previous;
 
-            // The merged handle goes to recycling, block it against future use
-            slotToMerge.Size = 0;
-            slotToMerge.Used = 0;
-            slotToMerge.Occupied = true;
-            _emptySlots.push(slotIndexToMerge);
+            if (releasedSlot.Previous != InvalidHandle)
+            {
+                _slots[releasedSlot.Previous].Next = handle;
+            }
+
+            recycleSlot(left);
         }
 
-        // Try to find an adjacent free slot to the right
-        if (findRightFreeSlot(releasedSlot, slotIndexToMerge))
+        auto right = releasedSlot.Next;
+
+        if (right != InvalidHandle && !_slots[right].Occupied)
         {
-            auto& slotToMerge = _slots[slotIndexToMerge];
+            auto& slotToMerge = _slots[right];
+            removeFreeSlot(right);
 
             releasedSlot.Size += slotToMerge.Size;
+            releasedSlot.Next = slotToMerge.Next;
 
-            // The merged handle goes to recycling, block it against future use
-            slotToMerge.Size = 0;
-            slotToMerge.Used = 0;
-            slotToMerge.Occupied = true;
-            _emptySlots.push(slotIndexToMerge);
+            if (releasedSlot.Next != InvalidHandle)
+            {
+                _slots[releasedSlot.Next].Previous = handle;
+            }
+            else
+            {
+                _lastSlot = handle;
+            }
+
+            recycleSlot(right);
         }
+
+        addFreeSlot(handle);
     }
 
     void applyTransactions(const std::vector<detail::BufferTransaction>& transactions, const ContinuousBuffer<ElementType>& other,
@@ -289,13 +330,22 @@ public:
             auto handle = getHandle(transaction.slot);
             auto& otherSlot = other._slots[handle];
 
+            // The slot might have been released or re-allocated with a smaller size
+            // since this transaction has been logged, only copy what is still in range
+            if (!otherSlot.Occupied || transaction.offset >= otherSlot.Size)
+            {
+                continue;
+            }
+
+            auto numElements = std::min(transaction.numChangedElements, otherSlot.Size - transaction.offset);
+
             memcpy(_buffer.data() + otherSlot.Offset + transaction.offset,
                 other._buffer.data() + otherSlot.Offset + transaction.offset,
-                transaction.numChangedElements * sizeof(ElementType));
+                numElements * sizeof(ElementType));
 
             // Remember this slot to be synced to the GPU
             _unsyncedModifications.emplace_back(ModifiedMemoryChunk{
-                    handle, transaction.offset, transaction.numChangedElements });
+                    handle, transaction.offset, numElements });
         }
 
         // Replicate the slot allocation data
@@ -304,6 +354,8 @@ public:
 
         _allocatedElements = other._allocatedElements;
         _emptySlots = other._emptySlots;
+        _freeSlots = other._freeSlots;
+        _lastSlot = other._lastSlot;
     }
 
     // Copies the updated memory to the given buffer object
@@ -385,132 +437,135 @@ public:
     }
 
 private:
-    bool findLeftFreeSlot(const SlotInfo& slotToTouch, Handle& found)
+    Handle getNextFreeSlotForSize(std::size_t requiredSize)
     {
-        auto numSlots = _slots.size();
+        // Pick the smallest free slot that is large enough, the leftmost one if there are several
+        auto candidate = _freeSlots.lower_bound(FreeSlotKey(requiredSize, 0, 0));
 
-        for (Handle slotIndex = 0; slotIndex < numSlots; ++slotIndex)
+        if (candidate == _freeSlots.end())
         {
-            const auto& candidate = _slots[slotIndex];
+            // No space wherever, we need to expand the buffer
+            expandBuffer(requiredSize);
 
-            if (candidate.Offset + candidate.Size == slotToTouch.Offset)
-            {
-                // The slot coordinates match, return true if this block is free
-                found = slotIndex;
-                return !candidate.Occupied;
-            }
+            // The free slot at the end of the buffer is large enough now
+            candidate = _freeSlots.lower_bound(FreeSlotKey(requiredSize, 0, 0));
+            assert(candidate != _freeSlots.end());
         }
 
-        return false;
-    }
+        auto handle = candidate->second;
+        _freeSlots.erase(candidate);
 
-    bool findRightFreeSlot(const SlotInfo& slotToTouch, Handle& found)
-    {
-        auto numSlots = _slots.size();
-        auto offsetToMatch = slotToTouch.Offset + slotToTouch.Size;
+        auto& slot = _slots[handle];
 
-        for (Handle slotIndex = 0; slotIndex < numSlots; ++slotIndex)
-        {
-            const auto& candidate = _slots[slotIndex];
+        // Calculate the remaining size before assignment
+        auto remainingSize = slot.Size - requiredSize;
+        slot.Size = requiredSize;
+        slot.Occupied = true;
 
-            if (candidate.Offset == offsetToMatch)
-            {
-                // The slot coordinates match, return true if this block is free
-                found = slotIndex;
-                return !candidate.Occupied;
-            }
+        if (remainingSize > 0)
+        {
+            // Allocate a new free slot with the remaining space
+            insertFreeSlotAfter(handle, remainingSize);
         }
 
-        return false;
+        return handle;
     }
 
-    Handle getNextFreeSlotForSize(std::size_t requiredSize)
+    void expandBuffer(std::size_t requiredSize)
     {
-        auto numSlots = _slots.size();
-        Handle rightmostFreeSlotIndex = static_cast<Handle>(numSlots);
-        std::size_t rightmostFreeOffset = 0;
-        std::size_t rightmostFreeSize = 0;
+        // Allocate more memory
+        auto oldBufferSize = _buffer.size();
+        auto additionalSize = std::max(oldBufferSize * GrowthRate, requiredSize);
+        _buffer.resize(oldBufferSize + additionalSize);
 
-        for (Handle slotIndex = 0; slotIndex < numSlots; ++slotIndex)
+        // Extend the slot at the end of the buffer if it's free, otherwise append a new one
+        if (!_slots[_lastSlot].Occupied)
         {
-            auto& slot = _slots[slotIndex];
-
-            if (slot.Occupied) continue;
-
-            // Keep track of the highest slot, we need that when re-allocating
-            if (slot.Offset > rightmostFreeOffset)
-            {
-                rightmostFreeOffset = slot.Offset;
-                rightmostFreeSize = slot.Size;
-                rightmostFreeSlotIndex = slotIndex;
-            }
+            removeFreeSlot(_lastSlot);
+            _slots[_lastSlot].Size += additionalSize;
+            addFreeSlot(_lastSlot);
+        }
+        else
+        {
+            insertFreeSlotAfter(_lastSlot, additionalSize);
+        }
+    }
 
-            if (slot.Size < requiredSize) continue; // this slot is no use for us
+    // Creates a free slot of the given size, following the given one in memory
+    void insertFreeSlotAfter(Handle handle, std::size_t size)
+    {
+        auto offset = _slots[handle].Offset + _slots[handle].Size;
+        auto newHandle = createSlotInfo(offset, size);
 
-            // Calculate the remaining size before assignment
-            auto remainingSize = slot.Size - requiredSize;
-            slot.Size = requiredSize;
-            slot.Occupied = true;
+        // Take the references after creation, the slot vector might have been reallocated
+        auto& slot = _slots[handle];
+        auto& newSlot = _slots[newHandle];
 
-            if (remainingSize > 0)
-            {
-                // Allocate a new free slot with the remaining space
-                createSlotInfo(slot.Offset + requiredSize, remainingSize);
-            }
+        newSlot.Previous = handle;
+        newSlot.Next = slot.Next;
+        slot.Next = newHandle;
 
-            return slotIndex;
+        if (newSlot.Next != InvalidHandle)
+        {
+            _slots[newSlot.Next].Previous = newHandle;
         }
-
-        // No space wherever, we need to expand the buffer
-
-        // Allocate more memory
-        auto oldBufferSize = _buffer.size();
-        auto additionalSize = std::max(oldBufferSize * GrowthRate, requiredSize);
-        auto newSize = oldBufferSize + additionalSize;
-        _buffer.resize(newSize);
-
-        // Ensure that the rightmost free slot is at the end of the buffer, otherwise allocate a new one
-        if (rightmostFreeSlotIndex == numSlots || rightmostFreeOffset + rightmostFreeSize != oldBufferSize)
+        else
         {
-            // Create a free slot with 0 size at the end of the storage
-            _slots.emplace_back(oldBufferSize, 0, false);
-
-            // Adjust rightMostFreeSlotIndex to always point at this new slot
-            rightmostFreeSlotIndex = static_cast<Handle>(numSlots);
+            _lastSlot = newHandle;
         }
 
-        // Use the right most slot for our requirement, then cut up the rest of the space
-        auto& rightmostFreeSlot = _slots[rightmostFreeSlotIndex];
+        addFreeSlot(newHandle);
+    }
 
-        assert(rightmostFreeSlot.Size < requiredSize); // otherwise we've run wrong above
+    void addFreeSlot(Handle handle)
+    {
+        const auto& slot = _slots[handle];
+        _freeSlots.emplace(FreeSlotKey(slot.Size, slot.Offset, handle), handle);
+    }
 
-        auto remainingSize = rightmostFreeSlot.Size + additionalSize - requiredSize;
+    void removeFreeSlot(Handle handle)
+    {
+        const auto& slot = _slots[handle];
+        _freeSlots.erase(FreeSlotKey(slot.Size, slot.Offset, handle));
+    }
 
-        rightmostFreeSlot.Occupied = true;
-        rightmostFreeSlot.Size = requiredSize;
+    // A slot that has been merged into a neighbour is kept for re-use
+    void recycleSlot(Handle handle)
+    {
+        auto& slot = _slots[handle];
 
-        createSlotInfo(rightmostFreeSlot.Offset + rightmostFreeSlot.Size, remainingSize);
+        // Block it against future use
+        slot.Size = 0;
+        slot.Used = 0;
+        slot.Occupied = true;
+        slot.Previous = InvalidHandle;
+        slot.Next = InvalidHandle;
 
-        return rightmostFreeSlotIndex;
+        _emptySlots.push(handle);
     }
 
-    SlotInfo& createSlotInfo(std::size_t offset, std::size_t size, bool occupied = false)
+    Handle createSlotInfo(std::size_t offset, std::size_t size, bool occupied = false)
     {
         if (_emptySlots.empty())
         {
-            return _slots.emplace_back(offset, size, occupied);
+            _slots.emplace_back(offset, size, occupied);
+            return static_cast<Handle>(_slots.size() - 1);
         }
 
         // Re-use an old slot
-        auto& slot = _slots.at(_emptySlots.top());
+        auto handle = _emptySlots.top();
         _emptySlots.pop();
 
+        auto& slot = _slots.at(handle);
+
         slot.Occupied = occupied;
         slot.Offset = offset;
         slot.Size = size;
         slot.Used = 0;
+        slot.Previous = InvalidHandle;
+        slot.Next = InvalidHandle;
 
-        return slot;
+        return handle;
     }
 };
 
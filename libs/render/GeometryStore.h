@@ -10,6 +10,16 @@
 namespace render
 {
 
+/**
+ * Geometry storage keeping a ring of frame buffers, each with its own copy of
+ * the vertex and index data and its own pair of buffer objects. The renderer
+ * is drawing from one buffer while the next ones are written to, a fence
+ * created at the end of every frame guards the buffer until it comes around again.
+ *
+ * Modifications are recorded in a per-buffer transaction log, which is replayed
+ * onto the next buffer at the start of a frame, such that only the changed
+ * ranges need to be copied and uploaded to the buffer objects.
+ */
 class GeometryStore final :
     public IGeometryStore
 {
@@ -17,6 +27,9 @@ public:
     // Slot ID handed out to client code
     using Slot = std::uint64_t;
 
+    // The number of frames that can be in flight at the same time
+    static constexpr std::size_t NumFrameBuffers = 3;
+
 private:
     enum class SlotType
     {
@@ -24,8 +37,6 @@ private:
         IndexRemap = 1,
     };
 
-    static constexpr auto NumFrameBuffers = 1;
-
     // Represents the storage for a single frame
     struct FrameBuffer
     {
@@ -297,7 +308,7 @@ public:
         rMessage() << "-- Geometry Store Memory --" << std::endl;
         rMessage() << "Number of Frame Buffers: " << NumFrameBuffers << std::endl;
 
-        for (auto i = 0; i < NumFrameBuffers; ++i)
+        for (std::size_t i = 0; i < NumFrameBuffers; ++i)
         {
             rMessage() << "Frame Buffer " << i << std::endl;
             rMessage() << "  Vertices: " << string::getFormattedByteSize(_frameBuffers[i].vertices.getBufferSizeInBytes()) << std::endl;
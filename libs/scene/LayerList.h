@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace scene
+{
+
+/**
+ * The set of layer IDs a node is a member of.
+ *
+ * Almost every node belongs to a single layer with a small ID, so the IDs
+ * [0..63] are stored in an inline bit mask without any heap allocation.
+ * Any other IDs go to a sorted overflow vector, which is usually empty.
+ *
+ * The interface mirrors the subset of std::set<int> used by the layer code,
+ * iteration visits the IDs in ascending order. Two LayerLists can be tested
+ * for common members using intersects(), which is the basis of the
+ * visibility check against the set of visible layers.
+ */
+class LayerList
+{
+public:
+    using value_type = int;
+    using size_type = std::size_t;
+
+    // Number of IDs stored in the inline bit mask
+    static constexpr int NumInlineLayers = 64;
+
+private:
+    std::uint64_t _bits;
+
+    // Sorted IDs outside the inline range
+    std::vector<int> _overflow;
+
+public:
+    class const_iterator
+    {
+    private:
+        const LayerList* _list;
+        int _value;
+        bool _atEnd;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        const_iterator() :
+            _list(nullptr),
+            _value(0),
+            _atEnd(true)
+        {}
+
+        const_iterator(const LayerList& list, bool atEnd) :
+            _list(&list),
+            _value(0),
+            _atEnd(atEnd)
+        {
+            if (!_atEnd)
+            {
+                _atEnd = !_list->findFirst(_value);
+            }
+        }
+
+        // Iterator pointing at an existing ID
+        const_iterator(const LayerList& list, int value) :
+            _list(&list),
+            _value(value),
+            _atEnd(false)
+        {}
+
+        int operator*() const
+        {
+            return _value;
+        }
+
+        const_iterator& operator++()
+        {
+            _atEnd = !_list->findNext(_value, _value);
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto previous = *this;
+            ++(*this);
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return _atEnd == other._atEnd && (_atEnd || _value == other._value);
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return !operator==(other);
+        }
+    };
+    using iterator = const_iterator;
+
+    LayerList() :
+        _bits(0)
+    {}
+
+    LayerList(std::initializer_list<int> ids) :
+        _bits(0)
+    {
+        for (auto id : ids)
+        {
+            insert(id);
+        }
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(*this, false);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(*this, true);
+    }
+
+    bool empty() const
+    {
+        return _bits == 0 && _overflow.empty();
+    }
+
+    size_type size() const
+    {
+        return countBits(_bits) + _overflow.size();
+    }
+
+    void clear()
+    {
+        _bits = 0;
+        _overflow.clear();
+    }
+
+    // Adds the given ID, returns true if it has not been present before
+    bool insert(int id)
+    {
+        if (isInline(id))
+        {
+            auto mask = getMask(id);
+            auto inserted = (_bits & mask) == 0;
+            _bits |= mask;
+            return inserted;
+        }
+
+        auto pos = std::lower_bound(_overflow.begin(), _overflow.end(), id);
+
+        if (pos != _overflow.end() && *pos == id) return false;
+
+        _overflow.insert(pos, id);
+        return true;
+    }
+
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    // Removes the given ID, returns the number of removed elements (0 or 1)
+    size_type erase(int id)
+    {
+        if (isInline(id))
+        {
+            auto mask = getMask(id);
+            auto present = (_bits & mask) != 0;
+            _bits &= ~mask;
+            return present ? 1 : 0;
+        }
+
+        auto pos = std::lower_bound(_overflow.begin(), _overflow.end(), id);
+
+        if (pos == _overflow.end() || *pos != id) return 0;
+
+        _overflow.erase(pos);
+        return 1;
+    }
+
+    size_type count(int id) const
+    {
+        if (isInline(id))
+        {
+            return (_bits & getMask(id)) != 0 ? 1 : 0;
+        }
+
+        return std::binary_search(_overflow.begin(), _overflow.end(), id) ? 1 : 0;
+    }
+
+    const_iterator find(int id) const
+    {
+        if (count(id) == 0) return end();
+
+        return const_iterator(*this, id);
+    }
+
+    // Returns true if both lists have at least one ID in common
+    bool intersects(const LayerList& other) const
+    {
+        if ((_bits & other._bits) != 0) return true;
+
+        // The overflow vectors are usually empty
+        if (_overflow.empty() || other._overflow.empty()) return false;
+
+        auto a = _overflow.begin();
+        auto b = other._overflow.begin();
+
+        while (a != _overflow.end() && b != other._overflow.end())
+        {
+            if (*a < *b) ++a;
+            else if (*b < *a) ++b;
+            else return true;
+        }
+
+        return false;
+    }
+
+    bool operator==(const LayerList& other) const
+    {
+        return _bits == other._bits && _overflow == other._overflow;
+    }
+
+    bool operator!=(const LayerList& other) const
+    {
+        return !operator==(other);
+    }
+
+private:
+    static bool isInline(int id)
+    {
+        return id >= 0 && id < NumInlineLayers;
+    }
+
+    static std::uint64_t getMask(int id)
+    {
+        return std::uint64_t(1) << id;
+    }
+
+    static std::size_t countBits(std::uint64_t bits)
+    {
+#if defined(_MSC_VER)
+        return static_cast<std::size_t>(__popcnt64(bits));
+#else
+        return static_cast<std::size_t>(__builtin_popcountll(bits));
+#endif
+    }
+
+    // Returns the index of the lowest set bit, bits must not be 0
+    static int lowestBit(std::uint64_t bits)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    // The iteration order is: negative overflow IDs, inline IDs, overflow IDs >= 64
+    bool findFirst(int& result) const
+    {
+        if (!_overflow.empty() && _overflow.front() < 0)
+        {
+            result = _overflow.front();
+            return true;
+        }
+
+        return findFrom(0, result);
+    }
+
+    bool findNext(int current, int& result) const
+    {
+        return current == std::numeric_limits<int>::max() ? false : findFrom(current + 1, result);
+    }
+
+    // Finds the smallest ID >= start
+    bool findFrom(int start, int& result) const
+    {
+        if (start < 0)
+        {
+            auto pos = std::lower_bound(_overflow.begin(), _overflow.end(), start);
+
+            if (pos != _overflow.end() && *pos < 0)
+            {
+                result = *pos;
+                return true;
+            }
+
+            start = 0;
+        }
+
+        if (start < NumInlineLayers)
+        {
+            auto remaining = _bits & (~std::uint64_t(0) << start);
+
+            if (remaining != 0)
+            {
+                result = lowestBit(remaining);
+                return true;
+            }
+
+            start = NumInlineLayers;
+        }
+
+        auto pos = std::lower_bound(_overflow.begin(), _overflow.end(), start);
+
+        if (pos != _overflow.end())
+        {
+            result = *pos;
+            return true;
+        }
+
+        return false;
+    }
+};
+
+}
@@ -137,12 +137,8 @@ void Node::moveToLayer(int layerId)
 
 void Node::removeFromLayer(int layerId)
 {
-	// Look up the layer ID and remove it from the list
-	LayerList::iterator found = _layers.find(layerId);
-
-	if (found != _layers.end()) {
-		_layers.erase(found);
-
+	// Remove the layer ID from the list
+	if (_layers.erase(layerId) > 0) {
 		// greebo: Make sure that every node is at least member of layer 0
 		if (_layers.empty()) {
 			_layers.insert(0);
@@ -555,6 +551,6 @@ void Node::setRenderState(RenderState state)
     }
 }
 
-unsigned long Node::_maxNodeId = 0;
+std::atomic<unsigned long> Node::_maxNodeId(0);
 
 } // namespace scene
@@ -10,6 +10,7 @@
 #include "scenelib.h"
 #include "string/string.h"
 #include "command/ExecutionNotPossible.h"
+#include "util/ParallelFor.h"
 #include "NodeUtils.h"
 
 namespace scene
@@ -22,6 +23,9 @@ ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, cons
 {
     auto result = std::make_shared<ComparisonResult>(source, base);
 
+    // Fingerprint the entities of both graphs in one go, the lookups below are using the cached values
+    NodeUtils::CalculateEntityFingerprints({ source, base });
+
     auto sourceEntities = NodeUtils::CollectEntityFingerprints(source);
     auto baseEntities = NodeUtils::CollectEntityFingerprints(base);
 
@@ -32,7 +36,28 @@ ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, cons
         throw cmd::ExecutionNotPossible(_("The source map doesn't contain any entities, cannot merge"));
     }
 
-    EntityMismatchByName sourceMismatches;
+    // The hash tables are unordered, mismatches are sorted by fingerprint before they are
+    // indexed by name, such that the same entity wins if an entity name is not unique
+    auto indexByName = [](std::vector<EntityMismatch>& mismatches)
+    {
+        std::sort(mismatches.begin(), mismatches.end(), [](const EntityMismatch& left, const EntityMismatch& right)
+        {
+            return left.fingerPrint < right.fingerPrint;
+        });
+
+        EntityMismatchByName mismatchesByName;
+
+        for (auto& mismatch : mismatches)
+        {
+            auto entityName = mismatch.entityName;
+            mismatchesByName.emplace(std::move(entityName), std::move(mismatch));
+        }
+
+        return mismatchesByName;
+    };
+
+    std::vector<EntityMismatch> sourceMismatches;
+    std::vector<ComparisonResult::Match> equivalentEntities;
 
     for (const auto& sourceEntity : sourceEntities)
     {
@@ -42,16 +67,23 @@ ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, cons
         if (matchingBaseNode != baseEntities.end())
         {
             // Found an equivalent node
-            result->equivalentEntities.emplace_back(ComparisonResult::Match{ sourceEntity.first, sourceEntity.second, matchingBaseNode->second });
+            equivalentEntities.emplace_back(ComparisonResult::Match{ sourceEntity.first, sourceEntity.second, matchingBaseNode->second });
         }
         else
         {
-            auto entityName = NodeUtils::GetEntityName(sourceEntity.second);
-            sourceMismatches.emplace(entityName, EntityMismatch{ sourceEntity.first, sourceEntity.second, entityName });
+            sourceMismatches.emplace_back(EntityMismatch{ sourceEntity.first, sourceEntity.second, NodeUtils::GetEntityName(sourceEntity.second) });
         }
     }
 
-    EntityMismatchByName baseMismatches;
+    // The hash tables are unordered, report the matches sorted by fingerprint
+    std::sort(equivalentEntities.begin(), equivalentEntities.end(), [](const ComparisonResult::Match& left, const ComparisonResult::Match& right)
+    {
+        return left.fingerPrint < right.fingerPrint;
+    });
+
+    result->equivalentEntities.assign(equivalentEntities.begin(), equivalentEntities.end());
+
+    std::vector<EntityMismatch> baseMismatches;
 
     for (const auto& baseEntity : baseEntities)
     {
@@ -59,13 +91,12 @@ ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, cons
         // Matching nodes have already been checked in the above loop
         if (sourceEntities.count(baseEntity.first) == 0)
         {
-            auto entityName = NodeUtils::GetEntityName(baseEntity.second);
-            baseMismatches.emplace(entityName, EntityMismatch{ baseEntity.first, baseEntity.second, entityName });
+            baseMismatches.emplace_back(EntityMismatch{ baseEntity.first, baseEntity.second, NodeUtils::GetEntityName(baseEntity.second) });
         }
     }
 
     // Enter the second stage and try to match entities and detailing diffs
-    processDifferingEntities(*result, sourceMismatches, baseMismatches);
+    processDifferingEntities(*result, indexByName(sourceMismatches), indexByName(baseMismatches));
 
     return result;
 }
@@ -93,10 +124,13 @@ void GraphComparer::processDifferingEntities(ComparisonResult& result, const Ent
     std::set_difference(baseMismatches.begin(), baseMismatches.end(), sourceMismatches.begin(), sourceMismatches.end(),
         std::back_inserter(missingInSource), compareEntityNames);
 
+    std::vector<ComparisonResult::EntityDifference*> entityDiffs;
+    entityDiffs.reserve(matchingByName.size());
+
     for (const auto& match : matchingByName)
     {
-        auto sourceMismatch = sourceMismatches.find(match.second.entityName)->second;
-        auto baseMismatch = baseMismatches.find(match.second.entityName)->second;
+        const auto& sourceMismatch = sourceMismatches.find(match.second.entityName)->second;
+        const auto& baseMismatch = baseMismatches.find(match.second.entityName)->second;
 
         auto& entityDiff = result.differingEntities.emplace_back(ComparisonResult::EntityDifference
         {
@@ -108,13 +142,19 @@ void GraphComparer::processDifferingEntities(ComparisonResult& result, const Ent
             ComparisonResult::EntityDifference::Type::EntityPresentButDifferent
         });
 
-        // Analyse the key values
-        entityDiff.differingKeyValues = compareKeyValues(sourceMismatch.node, baseMismatch.node);
-
-        // Analyse the child nodes
-        entityDiff.differingChildren = compareChildNodes(sourceMismatch.node, baseMismatch.node);
+        entityDiffs.push_back(&entityDiff);
     }
 
+    // Analyse the key values and child nodes of the differing entities in parallel,
+    // every task is filling in its own entry, so the order of the result is fixed
+    util::parallelForDynamic(entityDiffs.size(), [&](std::size_t index)
+    {
+        auto& entityDiff = *entityDiffs[index];
+
+        entityDiff.differingKeyValues = compareKeyValues(entityDiff.sourceNode, entityDiff.baseNode);
+        entityDiff.differingChildren = compareChildNodes(entityDiff.sourceNode, entityDiff.baseNode);
+    });
+
     for (const auto& mismatch : missingInSource)
     {
         result.differingEntities.emplace_back(ComparisonResult::EntityDifference
@@ -233,18 +273,35 @@ std::list<ComparisonResult::PrimitiveDifference> GraphComparer::compareChildNode
     auto sourceChildren = NodeUtils::CollectPrimitiveFingerprints(sourceNode);
     auto baseChildren = NodeUtils::CollectPrimitiveFingerprints(baseNode);
 
-    std::vector<Fingerprints::value_type> missingInSource;
-    std::vector<Fingerprints::value_type> missingInBase;
+    using FingerprintAndNode = std::pair<std::string, INodePtr>;
+
+    std::vector<FingerprintAndNode> missingInSource;
+    std::vector<FingerprintAndNode> missingInBase;
+
+    for (const auto& pair : sourceChildren)
+    {
+        if (baseChildren.count(pair.first) == 0)
+        {
+            missingInBase.push_back(pair);
+        }
+    }
+
+    for (const auto& pair : baseChildren)
+    {
+        if (sourceChildren.count(pair.first) == 0)
+        {
+            missingInSource.push_back(pair);
+        }
+    }
 
-    auto compareFingerprint = [](const Fingerprints::value_type& left, const Fingerprints::value_type& right)
+    // Report the differences sorted by fingerprint, independent of the hash table order
+    auto compareFingerprint = [](const FingerprintAndNode& left, const FingerprintAndNode& right)
     {
         return left.first < right.first;
     };
 
-    std::set_difference(sourceChildren.begin(), sourceChildren.end(),
-        baseChildren.begin(), baseChildren.end(), std::back_inserter(missingInBase), compareFingerprint);
-    std::set_difference(baseChildren.begin(), baseChildren.end(),
-        sourceChildren.begin(), sourceChildren.end(), std::back_inserter(missingInSource), compareFingerprint);
+    std::sort(missingInBase.begin(), missingInBase.end(), compareFingerprint);
+    std::sort(missingInSource.begin(), missingInSource.end(), compareFingerprint);
 
     for (const auto& pair : missingInBase)
     {
@@ -4,6 +4,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #include "inode.h"
 #include "imap.h"
@@ -25,7 +26,7 @@ namespace merge
 class GraphComparer
 {
 private:
-    using Fingerprints = std::map<std::string, INodePtr>;
+    using Fingerprints = std::unordered_map<std::string, INodePtr>;
 
 public:
     struct EntityMismatch
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <map>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 #include "inode.h"
 #include "icomparablenode.h"
 #include "ientity.h"
 #include "itextstream.h"
+#include "util/ParallelFor.h"
 
 namespace scene
 {
@@ -12,7 +16,8 @@ namespace scene
 namespace merge
 {
 
-using Fingerprints = std::map<std::string, INodePtr>;
+// Fingerprint to node lookup, for matching nodes of two graphs
+using Fingerprints = std::unordered_map<std::string, INodePtr>;
 
 class NodeUtils
 {
@@ -43,6 +48,39 @@ public:
         });
     }
 
+    // Calculates the fingerprints of all entities below the given root nodes in
+    // parallel. The nodes keep the results, such that the Collect* methods
+    // are only looking up the cached values afterwards.
+    static void CalculateEntityFingerprints(const std::vector<INodePtr>& roots)
+    {
+        std::vector<IComparableNode*> entities;
+
+        for (auto root = roots.begin(); root != roots.end(); ++root)
+        {
+            // Don't add the same entities twice, they'd be fingerprinted concurrently
+            if (std::find(roots.begin(), root, *root) != root) continue;
+
+            (*root)->foreachNode([&](const INodePtr& node)
+            {
+                auto comparable = dynamic_cast<IComparableNode*>(node.get());
+
+                if (comparable && node->getNodeType() == INode::Type::Entity)
+                {
+                    entities.push_back(comparable);
+                }
+
+                return true;
+            });
+        }
+
+        // Each entity is fingerprinting its own children, so no node is visited twice.
+        // The worldspawn usually has the most children, let the threads pick entities one by one.
+        util::parallelForDynamic(entities.size(), [&](std::size_t index)
+        {
+            entities[index]->getFingerprint();
+        });
+    }
+
     static Fingerprints CollectPrimitiveFingerprints(const INodePtr& parent)
     {
         return CollectNodeFingerprints(parent, [](const INodePtr& node)
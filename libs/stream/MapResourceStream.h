@@ -7,6 +7,8 @@
 #include "itextstream.h"
 #include "iarchive.h"
 #include "ifilesystem.h"
+#include "os/MappedFile.h"
+#include "MemoryStreamBuf.h"
 
 namespace stream
 {
@@ -73,6 +75,42 @@ public:
     }
 };
 
+/**
+ * Stream implementation serving a physical file through a read-only memory
+ * mapping. Readers can access the mapped contents directly through the
+ * MemoryStreamBuf of the returned stream.
+ */
+class MappedFileMapResourceStream :
+    public MapResourceStream
+{
+private:
+    os::MappedFile _mappedFile;
+    MemoryStreamBuf _buffer;
+    std::istream _stream;
+
+public:
+    MappedFileMapResourceStream(const std::string& path) :
+        _mappedFile(path),
+        _buffer(reinterpret_cast<const char*>(_mappedFile.data()), _mappedFile.size()),
+        _stream(&_buffer)
+    {
+        if (!_mappedFile.failed())
+        {
+            rMessage() << "Mapped file " << path << " into memory." << std::endl;
+        }
+    }
+
+    bool isOpen() const override
+    {
+        return !_mappedFile.failed() && _stream.good();
+    }
+
+    std::istream& getStream() override
+    {
+        return _stream;
+    }
+};
+
 /**
  * MapResourceStream implementation working with a PAK file.
  * Since deflated file streams are not seekable, the whole 
@@ -135,6 +173,14 @@ inline MapResourceStream::Ptr MapResourceStream::OpenFromPath(const std::string&
 {
     if (path_is_absolute(path.c_str()))
     {
+        // Prefer the memory mapping, empty or inaccessible files are opened the regular way
+        auto mappedStream = std::make_shared<detail::MappedFileMapResourceStream>(path);
+
+        if (mappedStream->isOpen())
+        {
+            return mappedStream;
+        }
+
         return std::make_shared<detail::FileMapResourceStream>(path);
     }
     else
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "idatastream.h"
+#include <algorithm>
+#include <cstring>
+
+namespace stream
+{
+
+/**
+ * Seekable input stream reading from a fixed block of memory,
+ * e.g. a memory-mapped file. The memory is not owned by the stream.
+ * Reads are bounds-checked, seeking beyond the end is clamped.
+ */
+class MemoryInputStream :
+    public SeekableInputStream
+{
+private:
+    const byte_type* _begin;
+    std::size_t _size;
+    std::size_t _position;
+
+public:
+    MemoryInputStream(const byte_type* data, std::size_t size) :
+        _begin(data),
+        _size(size),
+        _position(0)
+    {}
+
+    size_type read(byte_type* buffer, size_type length) override
+    {
+        auto count = std::min(length, _size - _position);
+
+        std::memcpy(buffer, _begin + _position, count);
+        _position += count;
+
+        return count;
+    }
+
+    position_type seek(position_type position) override
+    {
+        _position = std::min(position, _size);
+        return 0;
+    }
+
+    position_type seek(offset_type offset, seekdir direction) override
+    {
+        auto base = direction == beg ? 0 : direction == cur ? _position : _size;
+
+        if (offset < 0 && static_cast<std::size_t>(-offset) > base)
+        {
+            _position = 0;
+        }
+        else
+        {
+            _position = std::min(base + offset, _size);
+        }
+
+        return 0;
+    }
+
+    position_type tell() const override
+    {
+        return _position;
+    }
+
+    // Returns the memory at the current read position
+    const byte_type* getCurrentPointer() const
+    {
+        return _begin + _position;
+    }
+
+    // The number of bytes left to read
+    std::size_t getRemainingSize() const
+    {
+        return _size - _position;
+    }
+};
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <streambuf>
+#include <cstddef>
+
+namespace stream
+{
+
+/**
+ * Read-only, seekable std::streambuf serving a block of memory
+ * without copying it. The memory must stay valid as long as the buffer is used.
+ * Consumers can use dynamic_cast on an istream's rdbuf() to get direct
+ * access to the underlying memory block.
+ */
+class MemoryStreamBuf :
+    public std::streambuf
+{
+public:
+    MemoryStreamBuf(const char* data, std::size_t size)
+    {
+        auto begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+
+    // The start of the memory block
+    const char* data() const
+    {
+        return eback();
+    }
+
+    // The size of the memory block in bytes
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(egptr() - eback());
+    }
+
+protected:
+    pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        if (!(which & std::ios_base::in))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        off_type base = dir == std::ios_base::beg ? 0 :
+            dir == std::ios_base::cur ? static_cast<off_type>(gptr() - eback()) : static_cast<off_type>(size());
+
+        return seekpos(pos_type(base + offset), which);
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+    {
+        auto offset = static_cast<off_type>(position);
+
+        if (!(which & std::ios_base::in) || offset < 0 || offset > static_cast<off_type>(size()))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        setg(eback(), eback() + offset, egptr());
+        return position;
+    }
+
+    std::streamsize showmanyc() override
+    {
+        auto remaining = egptr() - gptr();
+        return remaining > 0 ? static_cast<std::streamsize>(remaining) : -1;
+    }
+};
+
+}
@@ -4,7 +4,9 @@
 #include <cstdint>
 
 #include "idatastream.h"
+#include <istream>
 #include <ostream>
+#include <string>
 #include <algorithm>
 
 namespace stream
@@ -72,4 +74,21 @@ inline InputStream::byte_type readByte(InputStream& stream)
 	return value;
 }
 
+/**
+ * Reads the remaining contents of the given std::istream into a string,
+ * e.g. to hand a whole file to a buffer-based tokeniser.
+ */
+inline std::string readAll(std::istream& stream)
+{
+	std::string result;
+	char buffer[65536];
+
+	while (stream.read(buffer, sizeof(buffer)) || stream.gcount() > 0)
+	{
+		result.append(buffer, static_cast<std::size_t>(stream.gcount()));
+	}
+
+	return result;
+}
+
 }
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace string
+{
+
+/**
+ * Converts the leading number of the given string to a double, like std::atof(),
+ * but without requiring a null-terminated string or a std::string instance.
+ * Returns 0 if the string doesn't start with a number.
+ *
+ * Uses std::from_chars() if the standard library supports floating point
+ * conversions, which is considerably faster than strtod() and locale-independent.
+ */
+inline double to_double(std::string_view str)
+{
+    // from_chars doesn't accept a leading plus sign
+    if (!str.empty() && str.front() == '+')
+    {
+        str.remove_prefix(1);
+    }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    double value = 0;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+
+    if (result.ec == std::errc())
+    {
+        return value;
+    }
+
+    if (result.ec == std::errc::invalid_argument)
+    {
+        return 0;
+    }
+
+    // Out of range, let strtod() decide about the value below
+#endif
+
+    // strtod needs a null-terminated string, tokens are usually short
+    char buffer[64];
+
+    if (str.size() < sizeof(buffer))
+    {
+        str.copy(buffer, str.size());
+        buffer[str.size()] = '\0';
+
+        return std::strtod(buffer, nullptr);
+    }
+
+    return std::strtod(std::string(str).c_str(), nullptr);
+}
+
+/**
+ * Converts the given string to an unsigned integer, returning the
+ * default value if the string doesn't start with a number.
+ */
+inline std::size_t to_unsigned(std::string_view str, std::size_t defaultVal = 0)
+{
+    if (!str.empty() && str.front() == '+')
+    {
+        str.remove_prefix(1);
+    }
+
+    std::size_t value = 0;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+
+    return result.ec == std::errc() ? value : defaultVal;
+}
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+
+/**
+ * Returns the number of threads data-parallel work should be distributed
+ * over, which is the number of hardware threads (at least 1).
+ */
+inline std::size_t getNumWorkerThreads()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/**
+ * Invokes func(begin, end) for consecutive index ranges covering [0, count).
+ * The ranges are processed concurrently by means of std::async, one of them
+ * on the calling thread. Ranges contain at least minRangeSize elements (except
+ * for the last one), small workloads are therefore processed synchronously.
+ *
+ * Blocks until all ranges are done. Exceptions thrown by the functor are
+ * re-thrown on the calling thread after all tasks have finished.
+ */
+template<typename RangeFunc>
+void parallelForRange(std::size_t count, const RangeFunc& func, std::size_t minRangeSize = 1)
+{
+    if (count == 0) return;
+
+    auto numRanges = std::min(getNumWorkerThreads(), (count + minRangeSize - 1) / std::max<std::size_t>(minRangeSize, 1));
+
+    if (numRanges <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    auto rangeSize = (count + numRanges - 1) / numRanges;
+
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(numRanges - 1);
+
+    for (std::size_t begin = rangeSize; begin < count; begin += rangeSize)
+    {
+        auto end = std::min(begin + rangeSize, count);
+        tasks.emplace_back(std::async(std::launch::async, [&func, begin, end]() { func(begin, end); }));
+    }
+
+    // The first range is processed on this thread
+    std::exception_ptr exception;
+
+    try
+    {
+        func(0, std::min(rangeSize, count));
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    for (auto& task : tasks)
+    {
+        try
+        {
+            task.get();
+        }
+        catch (...)
+        {
+            if (!exception) exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+/**
+ * Invokes func(index) for each index in [0, count), distributing the
+ * work over several threads. See parallelForRange() for details.
+ */
+template<typename IndexFunc>
+void parallelFor(std::size_t count, const IndexFunc& func, std::size_t minRangeSize = 1)
+{
+    parallelForRange(count, [&](std::size_t begin, std::size_t end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            func(i);
+        }
+    }, minRangeSize);
+}
+
+/**
+ * Invokes func(index) for each index in [0, count), with the worker threads
+ * fetching the next index one at a time. Unlike parallelFor() this balances
+ * workloads of very uneven item costs, at the expense of an atomic increment
+ * per item. Blocks until all items are done, exceptions are handled like
+ * in parallelForRange().
+ */
+template<typename IndexFunc>
+void parallelForDynamic(std::size_t count, const IndexFunc& func)
+{
+    std::atomic<std::size_t> nextIndex(0);
+
+    parallelForRange(std::min(getNumWorkerThreads(), count), [&](std::size_t, std::size_t)
+    {
+        for (auto i = nextIndex++; i < count; i = nextIndex++)
+        {
+            func(i);
+        }
+    });
+}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+
+/**
+ * A fixed number of worker threads processing queued tasks in the order
+ * they have been submitted. Tasks are expected to handle their own errors,
+ * exceptions must not leave the task function.
+ *
+ * Destroying the pool discards all tasks that have not been started yet
+ * and blocks until the running ones are done.
+ */
+class ThreadPool
+{
+private:
+    std::mutex _lock;
+    std::condition_variable _taskAvailable;
+
+    std::deque<std::function<void()>> _tasks;
+    bool _shutdown;
+
+    std::vector<std::thread> _workers;
+
+public:
+    ThreadPool(std::size_t numThreads = std::max(std::thread::hardware_concurrency(), 1u)) :
+        _shutdown(false)
+    {
+        for (std::size_t i = 0; i < std::max<std::size_t>(numThreads, 1); ++i)
+        {
+            _workers.emplace_back([this]() { processTasks(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _shutdown = true;
+            _tasks.clear();
+        }
+
+        _taskAvailable.notify_all();
+
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Queues the given task, it will be picked up by the next idle worker
+    void enqueue(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _tasks.emplace_back(std::move(task));
+        }
+
+        _taskAvailable.notify_one();
+    }
+
+    // Removes all tasks that have not been started yet
+    void clearPendingTasks()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _tasks.clear();
+    }
+
+private:
+    void processTasks()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(_lock);
+                _taskAvailable.wait(lock, [this]() { return _shutdown || !_tasks.empty(); });
+
+                if (_shutdown) return;
+
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "igl.h"
 #include "iclipper.h"
+#include "ishaders.h"
 #include "icolourscheme.h"
 #include "itextstream.h"
 #include "icameraview.h"
@@ -859,6 +860,14 @@ void CamWnd::Cam_Draw()
         GlobalRenderSystem().endFrame();
     }
 
+    // Keep redrawing until the textures loaded in the background have been swapped in
+    _renderStats.setPendingTextureLoads(GlobalMaterialManager().getNumPendingTextureLoads());
+
+    if (_renderStats.hasPendingTextureLoads())
+    {
+        queueDraw();
+    }
+
     // greebo: Draw the clipper's points (skipping the depth-test)
     {
         glDisable(GL_DEPTH_TEST);
@@ -932,6 +941,8 @@ void CamWnd::Cam_Draw()
         statString += _renderStats.getStatString();
     }
 
+    statString += _renderStats.getTextureLoadString();
+
     _glFont->drawString(statString);
 
     drawTime();
@@ -12,6 +12,8 @@ namespace
 {
     constexpr const char* const RKEY_AUTOSAVE_INTERVAL = "user/ui/map/autoSaveInterval";
     constexpr const char* const RKEY_AUTOSAVE_ENABLED = "user/ui/map/autoSaveEnabled";
+
+    constexpr int PENDING_SAVE_CHECK_INTERVAL_MSEC = 250;
 }
 
 AutoSaveTimer::AutoSaveTimer() :
@@ -24,8 +26,14 @@ AutoSaveTimer::~AutoSaveTimer()
     _enabled = false;
     stopTimer();
 
-    // Destroy the timer
+    if (_pendingSaveTimer)
+    {
+        _pendingSaveTimer->Stop();
+    }
+
+    // Destroy the timers
     _timer.reset();
+    _pendingSaveTimer.reset();
 }
 
 void AutoSaveTimer::initialise()
@@ -38,8 +46,10 @@ void AutoSaveTimer::initialise()
     page.appendSlider(_("Autosave Interval (in minutes)"), RKEY_AUTOSAVE_INTERVAL, 1, 61, 1, 1);
 
     _timer.reset(new wxTimer(this));
+    _pendingSaveTimer.reset(new wxTimer(this));
 
-    Bind(wxEVT_TIMER, &AutoSaveTimer::onIntervalReached, this);
+    Bind(wxEVT_TIMER, &AutoSaveTimer::onIntervalReached, this, _timer->GetId());
+    Bind(wxEVT_TIMER, &AutoSaveTimer::onPendingSaveCheck, this, _pendingSaveTimer->GetId());
 
     GlobalRegistry().signalForKey(RKEY_AUTOSAVE_INTERVAL).connect(
         sigc::mem_fun(this, &AutoSaveTimer::registryKeyChanged)
@@ -92,6 +102,21 @@ void AutoSaveTimer::onIntervalReached(wxTimerEvent& ev)
 
         // Re-start the timer after saving has finished
         startTimer();
+
+        // The files might still be written in the background, keep an eye on it
+        if (GlobalAutoSaver().checkPendingSave())
+        {
+            _pendingSaveTimer->Start(PENDING_SAVE_CHECK_INTERVAL_MSEC);
+        }
+    }
+}
+
+void AutoSaveTimer::onPendingSaveCheck(wxTimerEvent& ev)
+{
+    // Errors of the background write are reported from here, on the UI thread
+    if (!GlobalAutoSaver().checkPendingSave())
+    {
+        _pendingSaveTimer->Stop();
     }
 }
 
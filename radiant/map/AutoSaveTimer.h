@@ -25,6 +25,9 @@ private:
     // The timer object that triggers the callback
     wxSharedPtr<wxTimer> _timer;
 
+    // Polls the outcome of autosaves written in the background
+    wxSharedPtr<wxTimer> _pendingSaveTimer;
+
 public:
     AutoSaveTimer();
     ~AutoSaveTimer();
@@ -38,6 +41,7 @@ public:
 private:
     void registryKeyChanged();
     void onIntervalReached(wxTimerEvent& ev);
+    void onPendingSaveCheck(wxTimerEvent& ev);
 };
 
 }
@@ -30,7 +30,8 @@ void StartupMapLoader::onMainFrameReady()
     for (const std::string& candidate : args)
     {
 		if (os::getExtension(candidate) != "map" &&
-			os::getExtension(candidate) != "mapx") continue;
+			os::getExtension(candidate) != "mapx" &&
+			os::getExtension(candidate) != "mapb") continue;
 
 		// We have a map file, check if it exists (and where)
 
@@ -15,6 +15,9 @@ class RenderStatistics
     // Time for the render front-end only
     long _feTime = 0;
 
+    // Number of textures still being loaded in the background
+    std::size_t _pendingTextureLoads = 0;
+
 public:
 
     /// Return the constructed string for display
@@ -30,6 +33,25 @@ public:
              + " | fps: " + (totTime > 0 ? std::to_string(1000 / totTime) : "-");
     }
 
+    /// Return the text for the outstanding texture loads, empty if there are none
+    std::string getTextureLoadString()
+    {
+        return hasPendingTextureLoads()
+            ? " | tex loads: " + std::to_string(_pendingTextureLoads)
+            : std::string();
+    }
+
+    /// Store the number of textures which are still showing a placeholder
+    void setPendingTextureLoads(std::size_t count)
+    {
+        _pendingTextureLoads = count;
+    }
+
+    bool hasPendingTextureLoads() const
+    {
+        return _pendingTextureLoads > 0;
+    }
+
     /// Mark the front-end render stage as completed, storing the time internally
     void frontEndComplete()
     {
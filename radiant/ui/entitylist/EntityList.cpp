@@ -190,6 +190,25 @@ void EntityList::selectionChanged(const scene::INodePtr& node, bool isComponent)
     requestIdleCallback();
 }
 
+void EntityList::selectionBatchChanged(const std::vector<scene::INodePtr>& nodes, bool isComponent)
+{
+    if (_callbackActive || isComponent) return;
+
+    for (const auto& node : nodes)
+    {
+        if (node->getNodeType() == scene::INode::Type::Entity)
+        {
+            _nodesToUpdate.push_back(node);
+        }
+    }
+
+    // The tree items are updated during idle processing, all at once
+    if (!_nodesToUpdate.empty())
+    {
+        requestIdleCallback();
+    }
+}
+
 void EntityList::onFilterConfigChanged()
 {
     // Only react to filter changes if we display visible nodes only otherwise
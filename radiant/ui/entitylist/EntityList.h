@@ -68,6 +68,7 @@ private:
 	 * Gets notified as soon as the selection is changed.
 	 */
 	void selectionChanged(const scene::INodePtr& node, bool isComponent) override;
+	void selectionBatchChanged(const std::vector<scene::INodePtr>& nodes, bool isComponent) override;
 
 	// Called by the graph tree model
 	void onTreeViewSelection(const wxDataViewItem& item, bool selected);
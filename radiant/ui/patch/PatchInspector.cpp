@@ -250,6 +250,15 @@ void PatchInspector::selectionChanged(const scene::INodePtr& node, bool isCompon
 	}
 }
 
+void PatchInspector::selectionBatchChanged(const std::vector<scene::INodePtr>& nodes, bool isComponent)
+{
+	// One rescan is enough for the whole batch
+	if (!isComponent)
+	{
+		rescanSelection();
+	}
+}
+
 void PatchInspector::clearVertexChooser()
 {
 	_updateActive = true;
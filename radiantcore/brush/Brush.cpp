@@ -2,6 +2,7 @@
 
 #include "math/Frustum.h"
 #include "irenderable.h"
+#include "ichangetrackednode.h"
 #include "itextstream.h"
 #include "shaderlib.h"
 
@@ -40,7 +41,10 @@ Brush::Brush(BrushNode& owner) :
     _undoStateSaver(nullptr),
     m_planeChanged(false),
     m_transformChanged(false),
-	_detailFlag(Structural)
+    _windingsPrepared(false),
+    _preparedWindingsDegenerate(false),
+	_detailFlag(Structural),
+    _changeStamp(scene::getNextChangeStamp())
 {
     // Make some space for a few faces
     reserve(6);
@@ -52,7 +56,10 @@ Brush::Brush(BrushNode& owner, const Brush& other) :
     _undoStateSaver(nullptr),
     m_planeChanged(false),
     m_transformChanged(false),
-	_detailFlag(Structural)
+    _windingsPrepared(false),
+    _preparedWindingsDegenerate(false),
+	_detailFlag(Structural),
+    _changeStamp(scene::getNextChangeStamp())
 {
     copy(other);
 }
@@ -211,6 +218,7 @@ void Brush::setDetailFlag(DetailFlag newValue)
 	undoSave();
 
 	_detailFlag = newValue;
+	_changeStamp = scene::getNextChangeStamp();
 }
 
 BrushSplitType Brush::classifyPlane(const Plane3& plane) const
@@ -237,6 +245,16 @@ void Brush::evaluateBRep() const {
     }
 }
 
+void Brush::prepareBRep() const
+{
+    // Pending transforms are evaluated through the owning node, leave those to evaluateBRep()
+    if (m_planeChanged && !_windingsPrepared && !m_transformChanged)
+    {
+        _preparedWindingsDegenerate = const_cast<Brush*>(this)->buildWindings();
+        _windingsPrepared = true;
+    }
+}
+
 void Brush::transformChanged() {
     m_transformChanged = true;
     onFacePlaneChanged();
@@ -397,6 +415,7 @@ void Brush::reserve(std::size_t count) {
 
 void Brush::push_back(Faces::value_type face) {
     m_faces.push_back(face);
+    _changeStamp = scene::getNextChangeStamp();
 
     if (_undoStateSaver)
     {
@@ -417,6 +436,8 @@ void Brush::pop_back()
     }
 
     m_faces.pop_back();
+    _changeStamp = scene::getNextChangeStamp();
+
     for (Observers::iterator i = m_observers.begin(); i != m_observers.end(); ++i) {
         (*i)->pop_back();
         (*i)->DEBUG_verify();
@@ -431,6 +452,8 @@ void Brush::erase(std::size_t index)
     }
 
     m_faces.erase(m_faces.begin() + index);
+    _changeStamp = scene::getNextChangeStamp();
+
     for (Observers::iterator i = m_observers.begin(); i != m_observers.end(); ++i) {
         (*i)->erase(index);
         (*i)->DEBUG_verify();
@@ -440,6 +463,8 @@ void Brush::erase(std::size_t index)
 void Brush::onFacePlaneChanged()
 {
     m_planeChanged = true;
+    _windingsPrepared = false;
+    _changeStamp = scene::getNextChangeStamp();
     aabbChanged();
 }
 
@@ -448,8 +473,14 @@ void Brush::onFaceShaderChanged()
     // When the face shader changes, no geometry change is happening
     // therefore no call to onFacePlaneChanged() is necessary
 
+    _changeStamp = scene::getNextChangeStamp();
+
     // Queue an UI update of the texture tools if any of them is listening
-	signal_faceShaderChanged().emit();
+    // Brushes are constructed off-scene by the map loader threads, don't emit for them
+    if (_owner.inScene())
+    {
+        signal_faceShaderChanged().emit();
+    }
 }
 
 void Brush::onFaceConnectivityChanged()
@@ -465,6 +496,16 @@ void Brush::onFaceEvaluateTransform()
     evaluateTransform();
 }
 
+void Brush::onFaceTexdefChanged()
+{
+    _changeStamp = scene::getNextChangeStamp();
+}
+
+std::size_t Brush::getChangeStamp() const
+{
+    return _changeStamp;
+}
+
 void Brush::clear()
 {
     undoSave();
@@ -474,6 +515,7 @@ void Brush::clear()
     }
 
     m_faces.clear();
+    _changeStamp = scene::getNextChangeStamp();
 
     for(Observers::iterator i = m_observers.begin(); i != m_observers.end(); ++i) {
         (*i)->clear();
@@ -534,9 +576,17 @@ void Brush::removeRedundantFaces()
 
 /// \brief Constructs \p winding from the intersection of \p plane with the other planes of the brush.
 void Brush::windingForClipPlane(Winding& winding, const Plane3& plane) const {
-    FixedWinding buffer[2];
+    windingForClipPlane(winding, plane, getUniquePlanes());
+}
+
+void Brush::windingForClipPlane(Winding& winding, const Plane3& plane, const std::vector<bool>& uniquePlanes) const {
+    // The buffers are reused to avoid allocations, one pair per thread
+    thread_local FixedWinding buffer[2];
     bool swap = false;
 
+    buffer[0].clear();
+    buffer[1].clear();
+
     // get a poly that covers an effectively infinite area
     buffer[swap].createInfinite(plane, m_maxWorldCoord + 1);
 
@@ -545,8 +595,8 @@ void Brush::windingForClipPlane(Winding& winding, const Plane3& plane) const {
         for (std::size_t i = 0;  i < m_faces.size(); ++i) {
             const Face& clip = *m_faces[i];
 
-            if (clip.plane3() == plane
-                || !clip.plane3().isValid() || !plane_unique(i)
+            if (!uniquePlanes[i] || clip.plane3() == plane
+                || !clip.plane3().isValid()
                 || plane == -clip.plane3())
             {
                 continue;
@@ -554,13 +604,14 @@ void Brush::windingForClipPlane(Winding& winding, const Plane3& plane) const {
 
             buffer[!swap].clear();
 
+            // flip the plane, because we want to keep the back side
+            Plane3 clipPlane(-clip.plane3().normal(), -clip.plane3().dist());
+
+            // A winding entirely in front of the clip plane stays as it is
+            if (buffer[swap].clip(plane, clipPlane, i, buffer[!swap]))
             {
-                // flip the plane, because we want to keep the back side
-                Plane3 clipPlane(-clip.plane3().normal(), -clip.plane3().dist());
-                buffer[swap].clip(plane, clipPlane, i, buffer[!swap]);
+                swap = !swap;
             }
-
-            swap = !swap;
         }
     }
 
@@ -925,6 +976,18 @@ bool Brush::plane_unique(std::size_t index) const {
     return true;
 }
 
+std::vector<bool> Brush::getUniquePlanes() const
+{
+    std::vector<bool> uniquePlanes(m_faces.size());
+
+    for (std::size_t i = 0; i < m_faces.size(); ++i)
+    {
+        uniquePlanes[i] = plane_unique(i);
+    }
+
+    return uniquePlanes;
+}
+
 bool Brush::planeAlreadyDefined(std::size_t index) const
 {
     for (std::size_t i = 0; index < m_faces.size() && i < index; ++i)
@@ -1070,17 +1133,20 @@ bool Brush::buildWindings()
 {
     m_aabb_local = AABB();
 
+    // Determine the unique planes once, they are needed for every face
+    auto uniquePlanes = getUniquePlanes();
+
     for (std::size_t i = 0;  i < m_faces.size(); ++i)
     {
         auto& face = *m_faces[i];
 
-        if (!face.plane3().isValid() || !plane_unique(i))
+        if (!face.plane3().isValid() || !uniquePlanes[i])
         {
             face.getWinding().resize(0);
         }
         else
         {
-            windingForClipPlane(face.getWinding(), face.plane3());
+            windingForClipPlane(face.getWinding(), face.plane3(), uniquePlanes);
 
             // update brush bounds
             const auto& winding = face.getWinding();
@@ -1094,8 +1160,7 @@ bool Brush::buildWindings()
             face.emitTextureCoordinates();
         }
 
-        // greebo: Update the winding, now that it's constructed
-        face.updateWinding();
+        face.updateWindingNormals();
     }
 
     bool degenerate = !isBounded();
@@ -1158,7 +1223,15 @@ std::size_t ProximalVertexArray_index(const ProximalVertexArray& array, const Pr
 
 /// \brief Constructs the face windings and updates anything that depends on them.
 void Brush::buildBRep() {
-  bool degenerate = buildWindings();
+  // The windings might have been built by prepareBRep() already
+  bool degenerate = _windingsPrepared ? _preparedWindingsDegenerate : buildWindings();
+  _windingsPrepared = false;
+
+  // greebo: Update the windings, now that they're constructed
+  for (const auto& face : m_faces)
+  {
+    face->updateRenderables();
+  }
 
   static const Vector3& colourVertexVec = GlobalBrush().getSettings().getVertexColour();
   const Colour4b colour_vertex(int(colourVertexVec[0]*255), int(colourVertexVec[1]*255),
@@ -136,10 +136,17 @@ private:
 
 	mutable bool m_planeChanged; // b-rep evaluation required
 	mutable bool m_transformChanged; // transform evaluation required
+
+	// Set by prepareBRep(), the windings are built but not published yet
+	mutable bool _windingsPrepared;
+	mutable bool _preparedWindingsDegenerate;
 	// ----
 
 	DetailFlag _detailFlag;
 
+	// Renewed whenever the faces, their planes, textures or materials change
+	std::size_t _changeStamp;
+
 public:
 	/// \brief The undo memento for a brush stores only the list of face references - the faces are not copied.
 	class BrushUndoMemento :
@@ -153,6 +160,12 @@ public:
 
 		virtual ~BrushUndoMemento() {}
 
+		std::size_t getMemoryUsage() const override
+		{
+			// The faces themselves are shared with the brush
+			return sizeof(BrushUndoMemento) + _faces.capacity() * sizeof(FacePtr);
+		}
+
 		Faces _faces;
 		DetailFlag _detailFlag;
 	};
@@ -196,6 +209,10 @@ public:
     void onFaceConnectivityChanged();
     void onFaceEvaluateTransform();
     void onFaceNeedsRenderableUpdate();
+    void onFaceTexdefChanged();
+
+    // Returns the change stamp of this brush, see scene::IChangeTrackedNode
+    std::size_t getChangeStamp() const;
 
 	// Sets the shader of all faces to the given name
 	void setShader(const std::string& newShader) override;
@@ -215,6 +232,7 @@ public:
 	BrushSplitType classifyPlane(const Plane3& plane) const override;
 
 	void evaluateBRep() const override;
+	void prepareBRep() const override;
 
     void transformChanged();
     void evaluateTransform();
@@ -318,6 +336,12 @@ private:
 	/// \brief Returns true if the face identified by \p index is preceded by another plane that takes priority over it.
 	bool plane_unique(std::size_t index) const;
 
+	// Returns the plane_unique() flag for every face
+	std::vector<bool> getUniquePlanes() const;
+
+	// windingForClipPlane() variant using the given plane_unique() flags
+	void windingForClipPlane(Winding& winding, const Plane3& plane, const std::vector<bool>& uniquePlanes) const;
+
     // Returns true if the plane with the given index has already been defined. Only faces in the range [0..i-1) will be checked
 	bool planeAlreadyDefined(std::size_t index) const;
 
@@ -337,6 +361,7 @@ private:
 	bool isBounded();
 
 	/// \brief Constructs the polygon windings for each face of the brush. Also updates the brush bounding-box and face texture-coordinates.
+	/// Only the state of this brush is changed, the faces and observers are not notified.
 	bool buildWindings();
 
 	/// \brief Constructs the face windings and updates anything that depends on them.
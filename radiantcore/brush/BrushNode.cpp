@@ -60,6 +60,19 @@ const AABB& BrushNode::localAABB() const {
 }
 
 std::string BrushNode::getFingerprint()
+{
+    auto changeStamp = _brush.getChangeStamp();
+
+    if (_fingerprintCache.changeStamp != changeStamp)
+    {
+        _fingerprintCache.fingerprint = calculateFingerprint();
+        _fingerprintCache.changeStamp = changeStamp;
+    }
+
+    return _fingerprintCache.fingerprint;
+}
+
+std::string BrushNode::calculateFingerprint()
 {
     constexpr std::size_t SignificantDigits = scene::SignificantFingerprintDoubleDigits;
 
@@ -97,6 +110,16 @@ std::string BrushNode::getFingerprint()
     return hash;
 }
 
+std::size_t BrushNode::getChangeStamp() const
+{
+    return _brush.getChangeStamp();
+}
+
+scene::SerialisationCache& BrushNode::getSerialisationCache()
+{
+    return _serialisationCache;
+}
+
 // Snappable implementation
 void BrushNode::snapto(float snap) {
 	_brush.snapto(snap);
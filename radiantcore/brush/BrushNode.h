@@ -4,6 +4,7 @@
 #include "itraceable.h"
 #include "iscenegraph.h"
 #include "icomparablenode.h"
+#include "ichangetrackednode.h"
 
 #include "Brush.h"
 #include "scene/SelectableNode.h"
@@ -30,7 +31,8 @@ class BrushNode final :
 	public PlaneSelectable,
 	public Transformable,
 	public ITraceable,
-    public scene::IComparableNode
+    public scene::IComparableNode,
+    public scene::IChangeTrackedNode
 {
 	// The actual contained brush (NO reference)
 	Brush _brush;
@@ -62,6 +64,12 @@ class BrushNode final :
 
     bool _facesNeedRenderableUpdate;
 
+    // The text of the last map export, not copied along with the brush
+    scene::SerialisationCache _serialisationCache;
+
+    // Fingerprint of the brush, recalculated after the brush has changed
+    scene::FingerprintCache _fingerprintCache;
+
 public:
 	BrushNode();
 
@@ -84,6 +92,10 @@ public:
     // IComparable implementation
     std::string getFingerprint() override;
 
+    // IChangeTrackedNode implementation
+    std::size_t getChangeStamp() const override;
+    scene::SerialisationCache& getSerialisationCache() override;
+
 	// Bounded implementation
 	const AABB& localAABB() const override;
 
@@ -184,5 +196,7 @@ private:
 
 	void updateSelectedPointsArray();
 
+    std::string calculateFingerprint();
+
 };
 typedef std::shared_ptr<BrushNode> BrushNodePtr;
@@ -15,20 +15,47 @@
 #include "BrushNode.h"
 #include "BrushModule.h"
 
-// The structure that is saved in the undostack
+// The structure that is saved in the undostack. Most operations only change
+// the plane of a face, so the texture projection and the material name are
+// shared with the previously saved state of the same face if they are unchanged.
 class Face::SavedState final :
     public IUndoMemento
 {
 public:
     FacePlane::SavedState _planeState;
-    TextureProjection _texdefState;
-    std::string _materialName;
-
-    SavedState(const Face& face) :
-        _planeState(face.getPlane()),
-        _texdefState(face.getProjection()),
-        _materialName(face.getShader())
-    {}
+    std::shared_ptr<const TextureProjection> _texdefState;
+    std::shared_ptr<const std::string> _materialName;
+
+    SavedState(const Face& face, const std::shared_ptr<SavedState>& previous) :
+        _planeState(face.getPlane())
+    {
+        if (previous && previous->_texdefState->getMatrix() == face.getProjection().getMatrix())
+        {
+            _texdefState = previous->_texdefState;
+        }
+        else
+        {
+            _texdefState = std::make_shared<TextureProjection>(face.getProjection());
+        }
+
+        if (previous && *previous->_materialName == face.getShader())
+        {
+            _materialName = previous->_materialName;
+        }
+        else
+        {
+            _materialName = std::make_shared<std::string>(face.getShader());
+        }
+    }
+
+    std::size_t getMemoryUsage() const override
+    {
+        // Shared parts are counted by every state referencing them. This overestimates
+        // the actual usage, but the undo system can discard the state that allocated
+        // them while newer states still keep them alive.
+        return sizeof(SavedState) + sizeof(TextureProjection) +
+            sizeof(std::string) + _materialName->capacity();
+    }
 };
 
 Face::Face(Brush& owner) :
@@ -201,7 +228,10 @@ void Face::undoSave()
 // undoable
 IUndoMementoPtr Face::exportState() const
 {
-    return std::make_shared<SavedState>(*this);
+    auto state = std::make_shared<SavedState>(*this, _lastSavedState.lock());
+    _lastSavedState = state;
+
+    return state;
 }
 
 void Face::importState(const IUndoMementoPtr& data)
@@ -211,8 +241,8 @@ void Face::importState(const IUndoMementoPtr& data)
     auto state = std::static_pointer_cast<SavedState>(data);
 
     state->_planeState.exportState(getPlane());
-    setShader(state->_materialName);
-    _texdef = state->_texdefState;
+    setShader(*state->_materialName);
+    _texdef = *state->_texdefState;
 
     planeChanged();
     _owner.onFaceConnectivityChanged();
@@ -341,6 +371,7 @@ void Face::freezeTransform()
     m_plane = m_planeTransformed;
     planepts_assign(m_move_planepts, m_move_planeptsTransformed);
     _texdef = m_texdefTransformed;
+    _owner.onFaceTexdefChanged();
     updateWinding();
 }
 
@@ -361,6 +392,11 @@ void Face::updateRenderables()
 void Face::updateWinding()
 {
     updateRenderables();
+    updateWindingNormals();
+}
+
+void Face::updateWindingNormals()
+{
     m_winding.updateNormals(m_plane.getPlane().normal());
 }
 
@@ -411,7 +447,12 @@ void Face::shaderChanged()
     _faceIsVisible = shader && shader->getMaterial()->isVisible();
 
     planeChanged(); // updates renderables too
-    SceneChangeNotify();
+
+    // Brushes outside the scene (e.g. during map loading) don't need to notify anyone
+    if (_owner.getBrushNode().inScene())
+    {
+        SceneChangeNotify();
+    }
 }
 
 const std::string& Face::getShader() const
@@ -448,6 +489,7 @@ void Face::texdefChanged()
     revertTexdef();
     emitTextureCoordinates();
     updateRenderables();
+    _owner.onFaceTexdefChanged();
 
     // Fire the signal to update the Texture Tools
     signal_texdefChanged().emit();
@@ -610,6 +652,7 @@ void Face::applyShaderFromFace(const Face& other)
 
         setTexDefFromPoints(vertices, texcoords);
         _texdef = m_texdefTransformed; // freeze that matrix
+        _owner.onFaceTexdefChanged();
         return;
     }
     else
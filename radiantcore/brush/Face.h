@@ -55,6 +55,9 @@ private:
 
 	IUndoStateSaver* _undoStateSaver;
 
+    // The state exported last, its unchanged parts are shared with the next one
+    mutable std::weak_ptr<SavedState> _lastSavedState;
+
 	// Cached visibility flag, queried during front end rendering
 	bool _faceIsVisible;
 
@@ -91,6 +94,12 @@ public:
 	// greebo: Emits the updated normals to the Winding class.
 	void updateWinding();
 
+	// Updates the winding normals from the face plane, without queueing a renderable update
+	void updateWindingNormals();
+
+	// Queues an update of the renderables after the winding has changed
+	void updateRenderables();
+
     void connectUndoSystem(IUndoSystem& undoSystem);
     void disconnectUndoSystem(IUndoSystem& undoSystem);
 
@@ -232,5 +241,4 @@ private:
     void transformTexDefLocked(const Matrix4& transform);
 
     void clearRenderables();
-    void updateRenderables();
 };
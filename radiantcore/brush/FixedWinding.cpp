@@ -4,7 +4,30 @@
 #include "Winding.h"
 #include "itextstream.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define FIXEDWINDING_USE_SSE2
+#endif
+
 namespace {
+	/// \brief Stores the classification of \p count vertices given the bit masks of the
+	/// vertices in front and in back of the plane. Returns the number of vertices in front.
+	inline std::size_t storeClassification(PlaneClassification* target, int frontMask, int backMask, std::size_t count) {
+		std::size_t numFront = 0;
+
+		for (std::size_t i = 0; i < count; ++i) {
+			if (frontMask & (1 << i)) {
+				target[i] = ePlaneFront;
+				++numFront;
+			}
+			else {
+				target[i] = (backMask & (1 << i)) ? ePlaneBack : ePlaneOn;
+			}
+		}
+
+		return numFront;
+	}
+
 	inline bool float_is_largest_absolute(double axis, double other) {
 		return fabs(axis) > fabs(other);
 	}
@@ -57,10 +80,12 @@ void FixedWinding::writeToWinding(Winding& winding)
 	// Now copy stuff from this to the target winding
 	for (std::size_t i = 0; i < size(); ++i)
 	{
-		winding[i].vertex[0] = (*this)[i].vertex[0];
-		winding[i].vertex[1] = (*this)[i].vertex[1];
-		winding[i].vertex[2] = (*this)[i].vertex[2];
-		winding[i].adjacent = (*this)[i].adjacent;
+		const auto& vertex = (*this)[getStorageIndex(i)];
+
+		winding[i].vertex[0] = vertex.vertex[0];
+		winding[i].vertex[1] = vertex.vertex[1];
+		winding[i].vertex[2] = vertex.vertex[2];
+		winding[i].adjacent = vertex.adjacent;
 	}
 }
 
@@ -122,17 +147,75 @@ void FixedWinding::createInfinite(const Plane3& plane, double infinity) {
 	push_back(FixedWindingVertex(r4.origin, r4, brush::c_brush_maxFaces));
 }
 
+bool FixedWinding::classifyVertices(const Plane3& clipPlane)
+{
+	const auto count = size();
+	_classification.resize(count);
+
+	const auto* vertices = data();
+	auto* classification = _classification.data();
+
+	std::size_t numFront = 0;
+	std::size_t i = 0;
+
+	// Two vertices at a time. The distances are calculated in the same order as
+	// Plane3::distanceToPoint(), such that the result matches the scalar path.
+#if defined(FIXEDWINDING_USE_SSE2)
+	{
+		const auto nx = _mm_set1_pd(clipPlane.normal().x());
+		const auto ny = _mm_set1_pd(clipPlane.normal().y());
+		const auto nz = _mm_set1_pd(clipPlane.normal().z());
+		const auto dist = _mm_set1_pd(clipPlane.dist());
+		const auto epsilon = _mm_set1_pd(ON_EPSILON);
+		const auto negEpsilon = _mm_set1_pd(-ON_EPSILON);
+
+		for (; i + 2 <= count; i += 2) {
+			const auto* v = vertices + i;
+
+			auto x = _mm_set_pd(v[1].vertex.x(), v[0].vertex.x());
+			auto y = _mm_set_pd(v[1].vertex.y(), v[0].vertex.y());
+			auto z = _mm_set_pd(v[1].vertex.z(), v[0].vertex.z());
+
+			auto distance = _mm_sub_pd(_mm_add_pd(_mm_add_pd(
+				_mm_mul_pd(x, nx), _mm_mul_pd(y, ny)), _mm_mul_pd(z, nz)), dist);
+
+			numFront += storeClassification(classification + i,
+				_mm_movemask_pd(_mm_cmpgt_pd(distance, epsilon)),
+				_mm_movemask_pd(_mm_cmplt_pd(distance, negEpsilon)), 2);
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		classification[i] = Winding::classifyDistance(clipPlane.distanceToPoint(vertices[i].vertex), ON_EPSILON);
+
+		if (classification[i] == ePlaneFront) {
+			++numFront;
+		}
+	}
+
+	return numFront == count;
+}
+
 /// \brief Clip \p winding which lies on \p plane by \p clipPlane, resulting in \p clipped.
-/// If \p winding is completely in front of the plane, \p clipped will be identical to \p winding.
+/// If \p winding is completely in front of the plane, \p clipped is left untouched and false is returned,
+/// the start vertex of this winding is moved to match the vertex order of a full clip instead.
 /// If \p winding is completely in back of the plane, \p clipped will be empty.
 /// If \p winding intersects the plane, the edge of \p clipped which lies on \p clipPlane will store the value of \p adjacent.
-void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped)
+bool FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped)
 {
 	if (size() == 0) {
-		return; // Degenerate winding, exit
+		return true; // Degenerate winding, exit
 	}
 
-	PlaneClassification classification = Winding::classifyDistance(clipPlane.distanceToPoint(back().vertex), ON_EPSILON);
+	if (classifyVertices(clipPlane)) {
+		// Nothing to clip, the result would be a copy of this winding starting at its last vertex.
+		// Moving the start index to the last vertex keeps the vertex order identical to a full clip.
+		_start = getStorageIndex(size() - 1);
+		return false;
+	}
+
+	PlaneClassification classification = _classification[getStorageIndex(size() - 1)];
 	PlaneClassification nextClassification;
 
 	// for each edge
@@ -140,8 +223,8 @@ void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_
 		 next != size();
 		 i = next, ++next, classification = nextClassification)
 	{
-		nextClassification = Winding::classifyDistance(clipPlane.distanceToPoint((*this)[next].vertex), ON_EPSILON);
-		const FixedWindingVertex& vertex = (*this)[i];
+		nextClassification = _classification[getStorageIndex(next)];
+		const FixedWindingVertex& vertex = (*this)[getStorageIndex(i)];
 
 		// if first vertex of edge is ON
 		if (classification == ePlaneOn) {
@@ -191,4 +274,6 @@ void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_
 			}
 		}
 	}
+
+	return true;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "iclipper.h"
 #include "math/Vector3.h"
 #include "math/Plane3.h"
 
@@ -32,23 +33,39 @@ public:
 		edge(edge_),
 		adjacent(adjacent_)
 	{}
-
-	virtual ~FixedWindingVertex() {}
 };
 
 /**
  * greebo: A FixedWinding is a vector of FixedWindingVertices
  *         with a pre-allocated size of MAX_POINTS_ON_WINDING.
+ *
+ * The vertices are classified against the clip plane in a separate pass,
+ * which is using SSE2 instructions where available. Instances are meant
+ * to be reused, such that the allocated buffers are kept between clips.
  */
 class FixedWinding :
 	public std::vector<FixedWindingVertex>
 {
+private:
+	// The classification of each vertex against the last clip plane
+	std::vector<PlaneClassification> _classification;
+
+	// The storage index of the first vertex. Clips that don't change the winding
+	// move the start index instead of copying the vertices.
+	std::size_t _start;
+
 public:
-	FixedWinding() {
+	FixedWinding() :
+		_start(0)
+	{
 		reserve(MAX_POINTS_ON_WINDING);
+		_classification.reserve(MAX_POINTS_ON_WINDING);
 	}
 
-	virtual ~FixedWinding() {}
+	void clear() {
+		std::vector<FixedWindingVertex>::clear();
+		_start = 0;
+	}
 
 	// Writes the FixedWinding data into the given Winding
 	void writeToWinding(Winding& winding);
@@ -57,8 +74,19 @@ public:
 	void createInfinite(const Plane3& plane, double infinity);
 
 	/// \brief Clip this winding which lies on \p plane by \p clipPlane, resulting in \p clipped.
-	/// If \p winding is completely in front of the plane, \p clipped will be identical to \p winding.
+	/// If \p winding is completely in front of the plane, \p clipped is left untouched and false is returned,
+	/// the start vertex of this winding is moved to match the result of a full clip instead.
 	/// If \p winding is completely in back of the plane, \p clipped will be empty.
 	/// If \p winding intersects the plane, the edge of \p clipped which lies on \p clipPlane will store the value of \p adjacent.
-	void clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped);
+	bool clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped);
+
+private:
+	// Returns the storage index of the vertex with the given index
+	std::size_t getStorageIndex(std::size_t index) const {
+		index += _start;
+		return index < size() ? index : index - size();
+	}
+
+	// Classifies all vertices against the given plane, returns true if all of them are in front of it
+	bool classifyVertices(const Plane3& clipPlane);
 };
@@ -1,5 +1,6 @@
 #include "DeclarationFolderParser.h"
 
+#include <iterator>
 #include "DeclarationManager.h"
 #include "parser/DefBlockSyntaxParser.h"
 #include "string/trim.h"
@@ -9,37 +10,87 @@ namespace decl
 
 namespace
 {
-    DeclarationBlockSyntax createBlock(const parser::DefBlockSyntax& block,
-        const vfs::FileInfo& fileInfo, const std::string& modName)
+    DeclarationParseCache::Block createBlock(const parser::DefBlockSyntax& block)
     {
-        DeclarationBlockSyntax syntax;
-
         const auto& nameSyntax = block.getName();
         const auto& typeSyntax = block.getType();
 
-        syntax.typeName = typeSyntax ? typeSyntax->getToken().value : "";
-        syntax.name = nameSyntax ? nameSyntax->getToken().value : "";
-        syntax.contents = block.getBlockContents();
-        syntax.modName = modName;
-        syntax.fileInfo = fileInfo;
-
-        return syntax;
+        return DeclarationParseCache::Block
+        {
+            typeSyntax ? typeSyntax->getToken().value : "",
+            nameSyntax ? nameSyntax->getToken().value : "",
+            block.getBlockContents()
+        };
     }
 }
 
 DeclarationFolderParser::DeclarationFolderParser(DeclarationManager& owner, Type declType, 
     const std::string& baseDir, const std::string& extension,
-    const std::map<std::string, Type, string::ILess>& typeMapping) :
+    const std::map<std::string, Type, string::ILess>& typeMapping,
+    const std::string& cacheFilePath) :
     ThreadedDeclParser<void>(declType, baseDir, extension, 1),
     _owner(owner),
     _typeMapping(typeMapping),
     _defaultDeclType(declType)
-{}
+{
+    if (!cacheFilePath.empty())
+    {
+        _parseCache = std::make_unique<DeclarationParseCache>(cacheFilePath);
+    }
+}
+
+void DeclarationFolderParser::onBeginParsing()
+{
+    if (_parseCache)
+    {
+        _parseCache->load();
+    }
+}
 
 void DeclarationFolderParser::parse(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir)
 {
-    // Parse the incoming stream into syntax blocks
-    parser::DefBlockSyntaxParser<std::istream> parser(stream);
+    parseConcurrently(stream, fileInfo, modDir)();
+}
+
+std::function<void()> DeclarationFolderParser::parseConcurrently(std::istream& stream,
+    const vfs::FileInfo& fileInfo, const std::string& modDir)
+{
+    std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    auto blocks = std::make_shared<std::vector<DeclarationParseCache::Block>>();
+
+    if (!_parseCache)
+    {
+        parseBlocks(contents, *blocks);
+    }
+    else
+    {
+        auto vfsPath = fileInfo.fullPath();
+        auto archivePath = fileInfo.getArchivePath();
+        auto fileSize = fileInfo.getSize();
+        auto crc = DeclarationParseCache::calculateCrc(contents);
+
+        // Unchanged files don't need to be tokenised again
+        if (!_parseCache->findBlocks(vfsPath, archivePath, fileSize, crc, *blocks))
+        {
+            parseBlocks(contents, *blocks);
+            _parseCache->storeBlocks(vfsPath, archivePath, fileSize, crc, std::vector<DeclarationParseCache::Block>(*blocks));
+        }
+    }
+
+    // Sorting the blocks into the buckets is left to the parser thread
+    return [this, blocks, fileInfo, modDir]()
+    {
+        for (auto& block : *blocks)
+        {
+            addBlock(std::move(block), fileInfo, modDir);
+        }
+    };
+}
+
+void DeclarationFolderParser::parseBlocks(const std::string& contents, std::vector<DeclarationParseCache::Block>& blocks)
+{
+    // Parse the file contents into syntax blocks
+    parser::DefBlockSyntaxParser<const std::string> parser(contents);
 
     auto syntaxTree = parser.parse();
 
@@ -50,20 +101,37 @@ void DeclarationFolderParser::parse(std::istream& stream, const vfs::FileInfo& f
             continue;
         }
 
-        const auto& blockNode = static_cast<const parser::DefBlockSyntax&>(*node);
-
-        // Convert the incoming block to a DeclarationBlockSyntax
-        auto blockSyntax = createBlock(blockNode, fileInfo, modDir);
-
-        // Move the block in the correct bucket
-        auto declType = determineBlockType(blockSyntax);
-        auto& blockList = _parsedBlocks.try_emplace(declType).first->second;
-        blockList.emplace_back(std::move(blockSyntax));
+        blocks.emplace_back(createBlock(static_cast<const parser::DefBlockSyntax&>(*node)));
     }
 }
 
+void DeclarationFolderParser::addBlock(DeclarationParseCache::Block block, const vfs::FileInfo& fileInfo, const std::string& modDir)
+{
+    // Convert the incoming block to a DeclarationBlockSyntax
+    DeclarationBlockSyntax blockSyntax;
+
+    blockSyntax.typeName = std::move(block.typeName);
+    blockSyntax.name = std::move(block.name);
+    blockSyntax.contents = std::move(block.contents);
+    blockSyntax.modName = modDir;
+    blockSyntax.fileInfo = fileInfo;
+
+    // Move the block in the correct bucket
+    auto declType = determineBlockType(blockSyntax);
+    auto& blockList = _parsedBlocks.try_emplace(declType).first->second;
+    blockList.emplace_back(std::move(blockSyntax));
+}
+
 void DeclarationFolderParser::onFinishParsing()
 {
+    if (_parseCache)
+    {
+        rMessage() << "[DeclParser] " << getTypeName(_defaultDeclType) << ": " << _parseCache->getNumHits() <<
+            " files taken from the parse cache, " << _parseCache->getNumMisses() << " files parsed" << std::endl;
+
+        _parseCache->save();
+    }
+
     // Submit all parsed declarations to the decl manager
     _owner.onParserFinished(_defaultDeclType, _parsedBlocks);
 }
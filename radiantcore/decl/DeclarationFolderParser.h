@@ -3,6 +3,7 @@
 #include <map>
 #include "ideclmanager.h"
 #include "DeclarationFile.h"
+#include "DeclarationParseCache.h"
 
 #include "parser/ThreadedDeclParser.h"
 #include "string/string.h"
@@ -31,10 +32,15 @@ private:
     // The default type to assign to untyped blocks
     Type _defaultDeclType;
 
+    // Optional, null if the parse cache is disabled
+    std::unique_ptr<DeclarationParseCache> _parseCache;
+
 public:
+    // If cacheFilePath is not empty, the parsed blocks are cached in this file
     DeclarationFolderParser(DeclarationManager& owner, Type declType,
         const std::string& baseDir, const std::string& extension,
-        const std::map<std::string, Type, string::ILess>& typeMapping);
+        const std::map<std::string, Type, string::ILess>& typeMapping,
+        const std::string& cacheFilePath = std::string());
 
     ~DeclarationFolderParser() override
     {
@@ -43,10 +49,17 @@ public:
     }
 
 protected:
+    void onBeginParsing() override;
     void parse(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir) override;
+    std::function<void()> parseConcurrently(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir) override;
     void onFinishParsing() override;
 
 private:
+    // Tokenises the given file contents, appending the decl blocks to the given list
+    void parseBlocks(const std::string& contents, std::vector<DeclarationParseCache::Block>& blocks);
+
+    void addBlock(DeclarationParseCache::Block block, const vfs::FileInfo& fileInfo, const std::string& modDir);
+
     Type determineBlockType(const DeclarationBlockSyntax& block);
 };
 
@@ -9,8 +9,11 @@
 #include "DeclarationFolderParser.h"
 #include "parser/DefBlockSyntaxParser.h"
 #include "ifilesystem.h"
+#include "iregistry.h"
 #include "module/StaticModule.h"
+#include "registry/registry.h"
 #include "string/trim.h"
+#include "string/replace.h"
 #include "os/path.h"
 #include "os/file.h"
 #include "fmt/format.h"
@@ -69,10 +72,24 @@ void DeclarationManager::registerDeclFolder(Type defaultType, const std::string&
     auto& decls = _declarationsByType.try_emplace(defaultType, Declarations()).first->second;
 
     // Start the parser thread
-    decls.parser = std::make_unique<DeclarationFolderParser>(*this, defaultType, vfsPath, extension, getTypenameMapping());
+    decls.parser = std::make_unique<DeclarationFolderParser>(*this, defaultType, vfsPath, extension,
+        getTypenameMapping(), getParseCacheFilePath(vfsPath, extension));
     decls.parser->start();
 }
 
+std::string DeclarationManager::getParseCacheFilePath(const std::string& folder, const std::string& extension)
+{
+    if (_parseCacheFolder.empty() || !registry::getValue<bool>(RKEY_DECL_PARSE_CACHE))
+    {
+        return std::string();
+    }
+
+    // One file per registered folder, e.g. "materials_mtr.cache"
+    auto folderName = string::replace_all_copy(string::trim_right_copy(folder, "/"), "/", "_");
+
+    return _parseCacheFolder + folderName + "_" + extension + ".cache";
+}
+
 std::map<std::string, Type, string::ILess> DeclarationManager::getTypenameMapping()
 {
     std::map<std::string, Type, string::ILess> result;
@@ -363,7 +380,8 @@ void DeclarationManager::runParsersForAllFolders()
         for (const auto& folder : _registeredFolders)
         {
             auto& parser = parsers.emplace_back(
-                std::make_unique<DeclarationFolderParser>(*this, folder.defaultType, folder.folder, folder.extension, typeMapping)
+                std::make_unique<DeclarationFolderParser>(*this, folder.defaultType, folder.folder, folder.extension,
+                    typeMapping, getParseCacheFilePath(folder.folder, folder.extension))
             );
             parser->start();
         }
@@ -960,6 +978,7 @@ const StringSet& DeclarationManager::getDependencies() const
     {
         MODULE_VIRTUALFILESYSTEM,
         MODULE_COMMANDSYSTEM,
+        MODULE_XMLREGISTRY,
     };
 
     return _dependencies;
@@ -970,6 +989,8 @@ void DeclarationManager::initialiseModule(const IApplicationContext& ctx)
     GlobalCommandSystem().addCommand("ReloadDecls",
         std::bind(&DeclarationManager::reloadDeclsCmd, this, std::placeholders::_1));
 
+    _parseCacheFolder = ctx.getCacheDataPath() + "declcache/";
+
     // After the initial parsing, all decls will have a parseStamp of 0
     _parseStamp = 0;
     _reparseInProgress = false;
@@ -73,6 +73,9 @@ private:
 
     sigc::connection _vfsInitialisedConn;
 
+    // Folder containing the decl parse cache files
+    std::string _parseCacheFolder;
+
     // Access allowed if the _declarationAndCreatorLock is owned
     std::vector<std::shared_ptr<std::shared_future<void>>> _parserCleanupTasks;
 
@@ -104,6 +107,9 @@ public:
 private:
     void processParseResult(Type parserType, ParseResult& parsedBlocks);
     void runParsersForAllFolders();
+
+    // Returns the cache file for the given decl folder, or an empty string if caching is disabled
+    std::string getParseCacheFilePath(const std::string& folder, const std::string& extension);
     void waitForTypedParsersToFinish();
     void waitForCleanupTasksToFinish();
     void waitForSignalInvokersToFinish();
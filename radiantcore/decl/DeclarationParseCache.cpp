@@ -0,0 +1,295 @@
+#include "DeclarationParseCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <zlib.h>
+
+#include "itextstream.h"
+#include "os/fs.h"
+#include "os/dir.h"
+#include "debugging/ScopedDebugTimer.h"
+
+namespace decl
+{
+
+namespace
+{
+    constexpr const char* const CACHE_FILE_MAGIC = "DRDC";
+
+    // Increase this number whenever the file format or the block syntax parser changes
+    constexpr std::uint32_t CACHE_FILE_VERSION = 1;
+
+    // Appends values to the serialised cache data
+    class Writer
+    {
+    private:
+        std::string& _buffer;
+
+    public:
+        Writer(std::string& buffer) :
+            _buffer(buffer)
+        {}
+
+        template<typename ValueType>
+        void write(ValueType value)
+        {
+            static_assert(std::is_integral_v<ValueType>, "Only integral types supported");
+
+            // Little endian byte order
+            for (std::size_t i = 0; i < sizeof(ValueType); ++i)
+            {
+                _buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+            }
+        }
+
+        void write(const std::string& str)
+        {
+            write(static_cast<std::uint32_t>(str.size()));
+            _buffer.append(str);
+        }
+    };
+
+    // Reads values from the serialised cache data, with bounds checking
+    class Reader
+    {
+    private:
+        const std::string& _buffer;
+        std::size_t _position;
+        bool _failed;
+
+    public:
+        Reader(const std::string& buffer, std::size_t position) :
+            _buffer(buffer),
+            _position(position),
+            _failed(false)
+        {}
+
+        bool failed() const
+        {
+            return _failed;
+        }
+
+        template<typename ValueType>
+        ValueType read()
+        {
+            static_assert(std::is_integral_v<ValueType>, "Only integral types supported");
+
+            if (_failed || _buffer.size() - _position < sizeof(ValueType))
+            {
+                _failed = true;
+                return 0;
+            }
+
+            ValueType value = 0;
+
+            for (std::size_t i = 0; i < sizeof(ValueType); ++i)
+            {
+                value |= static_cast<ValueType>(static_cast<unsigned char>(_buffer[_position++])) << (i * 8);
+            }
+
+            return value;
+        }
+
+        std::string readString()
+        {
+            auto length = read<std::uint32_t>();
+
+            if (_failed || _buffer.size() - _position < length)
+            {
+                _failed = true;
+                return std::string();
+            }
+
+            auto result = _buffer.substr(_position, length);
+            _position += length;
+
+            return result;
+        }
+    };
+}
+
+DeclarationParseCache::DeclarationParseCache(const std::string& cacheFilePath) :
+    _cacheFilePath(cacheFilePath),
+    _numHits(0),
+    _numMisses(0)
+{}
+
+void DeclarationParseCache::load()
+{
+    _loadedEntries.clear();
+
+    std::ifstream file(_cacheFilePath, std::ios::binary);
+
+    if (!file) return; // no cache file yet
+
+    ScopedDebugTimer timer("[DeclParser] Loaded parse cache " + _cacheFilePath);
+
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // The last four bytes hold the checksum of the preceding data
+    auto headerSize = std::strlen(CACHE_FILE_MAGIC) + sizeof(std::uint32_t);
+
+    if (buffer.size() < headerSize + sizeof(std::uint32_t) ||
+        buffer.compare(0, std::strlen(CACHE_FILE_MAGIC), CACHE_FILE_MAGIC) != 0)
+    {
+        rWarning() << "[DeclParser] Ignoring invalid parse cache " << _cacheFilePath << std::endl;
+        return;
+    }
+
+    auto payloadSize = buffer.size() - sizeof(std::uint32_t);
+
+    Reader trailer(buffer, payloadSize);
+    auto checksum = trailer.read<std::uint32_t>();
+
+    if (checksum != calculateCrc(std::string_view(buffer.data(), payloadSize)))
+    {
+        rWarning() << "[DeclParser] Ignoring corrupt parse cache " << _cacheFilePath << std::endl;
+        return;
+    }
+
+    Reader reader(buffer, std::strlen(CACHE_FILE_MAGIC));
+
+    if (reader.read<std::uint32_t>() != CACHE_FILE_VERSION)
+    {
+        return; // written by a different version, will be replaced
+    }
+
+    auto numEntries = reader.read<std::uint32_t>();
+
+    for (std::uint32_t i = 0; i < numEntries && !reader.failed(); ++i)
+    {
+        auto vfsPath = reader.readString();
+
+        Entry entry;
+        entry.archivePath = reader.readString();
+        entry.fileSize = reader.read<std::uint64_t>();
+        entry.crc = reader.read<std::uint32_t>();
+
+        auto numBlocks = reader.read<std::uint32_t>();
+
+        for (std::uint32_t b = 0; b < numBlocks && !reader.failed(); ++b)
+        {
+            auto& block = entry.blocks.emplace_back();
+            block.typeName = reader.readString();
+            block.name = reader.readString();
+            block.contents = reader.readString();
+        }
+
+        _loadedEntries.emplace(std::move(vfsPath), std::move(entry));
+    }
+
+    if (reader.failed())
+    {
+        rWarning() << "[DeclParser] Ignoring truncated parse cache " << _cacheFilePath << std::endl;
+        _loadedEntries.clear();
+    }
+}
+
+void DeclarationParseCache::save()
+{
+    // Nothing to do if every file has been found in the cache and no file has been removed
+    // (valid entries are moved out of the loaded set on lookup)
+    if (_numMisses == 0 && _loadedEntries.empty())
+    {
+        return;
+    }
+
+    std::string buffer(CACHE_FILE_MAGIC);
+    Writer writer(buffer);
+
+    writer.write(CACHE_FILE_VERSION);
+    writer.write(static_cast<std::uint32_t>(_currentEntries.size()));
+
+    for (const auto& [vfsPath, entry] : _currentEntries)
+    {
+        writer.write(vfsPath);
+        writer.write(entry.archivePath);
+        writer.write(entry.fileSize);
+        writer.write(entry.crc);
+        writer.write(static_cast<std::uint32_t>(entry.blocks.size()));
+
+        for (const auto& block : entry.blocks)
+        {
+            writer.write(block.typeName);
+            writer.write(block.name);
+            writer.write(block.contents);
+        }
+    }
+
+    writer.write(calculateCrc(buffer));
+
+    try
+    {
+        fs::path cacheFile(_cacheFilePath);
+        os::makeDirectory(cacheFile.parent_path().string());
+
+        // Write to a temporary file first, to not leave a half-written cache behind
+        auto tempFile = cacheFile;
+        tempFile += ".tmp";
+
+        {
+            std::ofstream stream(tempFile.string(), std::ios::binary | std::ios::trunc);
+            stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+            if (!stream)
+            {
+                throw std::runtime_error("Failed to write " + tempFile.string());
+            }
+        }
+
+        fs::rename(tempFile, cacheFile);
+    }
+    catch (const std::exception& ex)
+    {
+        rWarning() << "[DeclParser] Could not save parse cache: " << ex.what() << std::endl;
+    }
+}
+
+std::uint32_t DeclarationParseCache::calculateCrc(std::string_view contents)
+{
+    auto crc = crc32(0L, Z_NULL, 0);
+    return static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<const Bytef*>(contents.data()), static_cast<uInt>(contents.size())));
+}
+
+bool DeclarationParseCache::findBlocks(const std::string& vfsPath, const std::string& archivePath,
+    std::uint64_t fileSize, std::uint32_t crc, std::vector<Block>& blocks)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto loaded = _loadedEntries.find(vfsPath);
+
+    if (loaded == _loadedEntries.end() || loaded->second.archivePath != archivePath ||
+        loaded->second.fileSize != fileSize || loaded->second.crc != crc)
+    {
+        ++_numMisses;
+        return false;
+    }
+
+    ++_numHits;
+
+    auto& entry = _currentEntries[vfsPath] = std::move(loaded->second);
+    _loadedEntries.erase(loaded);
+
+    blocks = entry.blocks;
+    return true;
+}
+
+void DeclarationParseCache::storeBlocks(const std::string& vfsPath, const std::string& archivePath,
+    std::uint64_t fileSize, std::uint32_t crc, std::vector<Block>&& blocks)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _currentEntries[vfsPath] = Entry{ archivePath, fileSize, crc, std::move(blocks) };
+}
+
+std::size_t DeclarationParseCache::getNumHits() const
+{
+    return _numHits;
+}
+
+std::size_t DeclarationParseCache::getNumMisses() const
+{
+    return _numMisses;
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ideclmanager.h"
+
+namespace decl
+{
+
+/**
+ * Persistent cache of the block syntax parsed from declaration files,
+ * stored in a binary file in the user's cache folder.
+ *
+ * Entries are keyed by the VFS path and the path of the containing archive,
+ * an entry is only valid if both the file size and the CRC of the file contents
+ * still match, in which case the file doesn't need to be tokenised again.
+ *
+ * Each DeclarationFolderParser owns its own cache instance (and file).
+ * Lookups and stores are thread-safe, since the parser is processing
+ * several files concurrently. Entries not looked up during a parser
+ * run are dropped when the cache is saved.
+ */
+class DeclarationParseCache
+{
+public:
+    // The cached part of a DeclarationBlockSyntax, the rest is taken from the live file
+    struct Block
+    {
+        std::string typeName;
+        std::string name;
+        std::string contents;
+    };
+
+private:
+    struct Entry
+    {
+        std::string archivePath;
+        std::uint64_t fileSize;
+        std::uint32_t crc;
+        std::vector<Block> blocks;
+    };
+
+    std::string _cacheFilePath;
+
+    // The entries loaded from disk
+    std::map<std::string, Entry> _loadedEntries;
+
+    // The entries visited in this run, these will be written to disk
+    std::map<std::string, Entry> _currentEntries;
+
+    std::mutex _lock;
+
+    std::size_t _numHits;
+    std::size_t _numMisses;
+
+public:
+    DeclarationParseCache(const std::string& cacheFilePath);
+
+    // Loads the cache file from disk, an invalid or outdated file is ignored
+    void load();
+
+    // Writes the entries of this run to disk, if anything changed
+    void save();
+
+    // Calculates the checksum of the given file contents
+    static std::uint32_t calculateCrc(std::string_view contents);
+
+    // Copies the blocks of the given file to the given vector, returns false if there is no valid entry.
+    // A valid entry is transferred to the set of entries to be saved.
+    bool findBlocks(const std::string& vfsPath, const std::string& archivePath,
+        std::uint64_t fileSize, std::uint32_t crc, std::vector<Block>& blocks);
+
+    // Stores the blocks parsed from the given file
+    void storeBlocks(const std::string& vfsPath, const std::string& archivePath,
+        std::uint64_t fileSize, std::uint32_t crc, std::vector<Block>&& blocks);
+
+    std::size_t getNumHits() const;
+    std::size_t getNumMisses() const;
+};
+
+}
@@ -253,6 +253,44 @@ bool EntityNode::isShadowCasting() const
 }
 
 std::string EntityNode::getFingerprint()
+{
+    std::vector<scene::IComparableNode*> children;
+    std::vector<std::size_t> childStamps;
+    bool childrenAreTracked = true;
+
+    foreachNode([&](const scene::INodePtr& child)
+    {
+        auto comparable = dynamic_cast<scene::IComparableNode*>(child.get());
+
+        if (comparable)
+        {
+            auto changeTracked = dynamic_cast<scene::IChangeTrackedNode*>(child.get());
+
+            children.push_back(comparable);
+            childStamps.push_back(changeTracked ? changeTracked->getChangeStamp() : 0);
+            childrenAreTracked &= changeTracked != nullptr;
+        }
+
+        return true;
+    });
+
+    // The cached value is valid as long as neither the keyvalues nor the set
+    // of children (or their state) has changed since the last calculation
+    auto changeStamp = _spawnArgs.getChangeStamp();
+
+    if (childrenAreTracked && _fingerprintCache.changeStamp == changeStamp && _fingerprintChildStamps == childStamps)
+    {
+        return _fingerprintCache.fingerprint;
+    }
+
+    _fingerprintCache.fingerprint = calculateFingerprint(children);
+    _fingerprintCache.changeStamp = childrenAreTracked ? changeStamp : 0;
+    _fingerprintChildStamps = std::move(childStamps);
+
+    return _fingerprintCache.fingerprint;
+}
+
+std::string EntityNode::calculateFingerprint(const std::vector<scene::IComparableNode*>& children)
 {
     std::map<std::string, std::string> sortedKeyValues;
 
@@ -274,17 +312,10 @@ std::string EntityNode::getFingerprint()
     // Entities need to include any child hashes, but be insensitive to their order
     std::set<std::string> childFingerprints;
 
-    foreachNode([&](const scene::INodePtr& child)
+    for (auto child : children)
     {
-        auto comparable = std::dynamic_pointer_cast<scene::IComparableNode>(child);
-
-        if (comparable)
-        {
-            childFingerprints.insert(comparable->getFingerprint());
-        }
-
-        return true;
-    });
+        childFingerprints.insert(child->getFingerprint());
+    }
 
     for (auto childFingerprint : childFingerprints)
     {
@@ -294,6 +325,16 @@ std::string EntityNode::getFingerprint()
     return hash;
 }
 
+std::size_t EntityNode::getChangeStamp() const
+{
+    return _spawnArgs.getChangeStamp();
+}
+
+scene::SerialisationCache& EntityNode::getSerialisationCache()
+{
+    return _serialisationCache;
+}
+
 void EntityNode::testSelect(Selector& selector, SelectionTest& test)
 {
 	test.BeginMesh(localToWorld());
@@ -4,6 +4,7 @@
 #include "ientity.h"
 #include "inamespace.h"
 #include "icomparablenode.h"
+#include "ichangetrackednode.h"
 #include "Bounded.h"
 
 #include "scene/SelectableNode.h"
@@ -39,7 +40,8 @@ class EntityNode :
 	public Namespaced,
 	public TargetableNode,
 	public Transformable,
-    public scene::IComparableNode
+    public scene::IComparableNode,
+    public scene::IChangeTrackedNode
 {
 protected:
 	// The entity class
@@ -116,6 +118,14 @@ protected:
 
     bool _isShadowCasting;
 
+    // The text of the last map export, not copied along with the entity
+    scene::SerialisationCache _serialisationCache;
+
+    // Fingerprint of the keyvalues and child primitives, valid as long as the
+    // spawnargs and the children listed in _fingerprintChildStamps are unchanged
+    scene::FingerprintCache _fingerprintCache;
+    std::vector<std::size_t> _fingerprintChildStamps;
+
 protected:
 	// The Constructor needs the eclass
 	EntityNode(const IEntityClassPtr& eclass);
@@ -153,6 +163,10 @@ public:
     // IComparableNode implementation
     std::string getFingerprint() override;
 
+    // IChangeTrackedNode implementation, tracking the keyvalues of this entity
+    std::size_t getChangeStamp() const override;
+    scene::SerialisationCache& getSerialisationCache() override;
+
 	// SelectionTestable implementation
 	virtual void testSelect(Selector& selector, SelectionTest& test) override;
 
@@ -239,6 +253,8 @@ private:
 	// Routine used by the destructor, should be non-virtual
 	void destruct();
 
+    std::string calculateFingerprint(const std::vector<scene::IComparableNode*>& children);
+
 	// Private function target - wraps to virtual protected signal
 	void _modelKeyChanged(const std::string& value);
     void _originKeyChanged();
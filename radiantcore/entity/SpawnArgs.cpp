@@ -1,6 +1,7 @@
 #include "SpawnArgs.h"
 
 #include "ieclass.h"
+#include "ichangetrackednode.h"
 #include "debugging/debugging.h"
 #include "string/predicate.h"
 #include <functional>
@@ -14,7 +15,8 @@ SpawnArgs::SpawnArgs(const IEntityClassPtr& eclass) :
         std::function<void()>(), "EntityKeyValues"),
 	_observerMutex(false),
 	_isContainer(!eclass->isFixedSize()),
-	_attachments(eclass->getDeclName())
+	_attachments(eclass->getDeclName()),
+	_changeStamp(scene::getNextChangeStamp())
 {
     // Parse attachment keys
     parseAttachments();
@@ -27,7 +29,8 @@ SpawnArgs::SpawnArgs(const SpawnArgs& other) :
         std::function<void()>(), "EntityKeyValues"),
 	_observerMutex(false),
 	_isContainer(other._isContainer),
-	_attachments(other._attachments)
+	_attachments(other._attachments),
+	_changeStamp(scene::getNextChangeStamp())
 {
     // Copy keyvalue strings, not actual KeyValue pointers
     for (const KeyValuePair& p : other._keyValues)
@@ -63,6 +66,11 @@ bool SpawnArgs::isOfType(const std::string& className)
 	return _eclass->isOfType(className);
 }
 
+std::size_t SpawnArgs::getChangeStamp() const
+{
+	return _changeStamp;
+}
+
 void SpawnArgs::importState(const KeyValues& keyValues)
 {
 	// Remove the entity key values, one by one
@@ -234,6 +242,8 @@ void SpawnArgs::setIsContainer(bool isContainer)
 
 void SpawnArgs::notifyInsert(const std::string& key, KeyValue& value)
 {
+	_changeStamp = scene::getNextChangeStamp();
+
 	// Block the addition/removal of new Observers during this process
 	_observerMutex = true;
 
@@ -248,6 +258,8 @@ void SpawnArgs::notifyInsert(const std::string& key, KeyValue& value)
 
 void SpawnArgs::notifyChange(const std::string& k, const std::string& v)
 {
+    _changeStamp = scene::getNextChangeStamp();
+
     _observerMutex = true;
 
     for (Observers::iterator i = _observers.begin();
@@ -262,6 +274,8 @@ void SpawnArgs::notifyChange(const std::string& k, const std::string& v)
 
 void SpawnArgs::notifyErase(const std::string& key, KeyValue& value)
 {
+	_changeStamp = scene::getNextChangeStamp();
+
 	// Block the addition/removal of new Observers during this process
 	_observerMutex = true;
 
@@ -45,6 +45,9 @@ class SpawnArgs: public Entity
     // Store attachment information
     AttachmentData _attachments;
 
+    // Renewed whenever a keyvalue is inserted, changed or removed
+    std::size_t _changeStamp;
+
 public:
 	// Constructor, pass the according entity class
 	SpawnArgs(const IEntityClassPtr& eclass);
@@ -81,6 +84,9 @@ public:
 
 	bool isOfType(const std::string& className) override;
 
+	// Returns the change stamp of the keyvalues, see scene::IChangeTrackedNode
+	std::size_t getChangeStamp() const;
+
 private:
 
     // Parse attachment information from def_attach and related keys (which are
@@ -59,7 +59,7 @@ int LayerManager::createLayer(const std::string& name, int layerID)
 	_layerParentIds.resize(highestID+1);
 
 	// Set the newly created layer to "visible"
-	_layerVisibility[layerID] = true;
+	setVisibilityFlag(layerID, true);
     _layerParentIds[layerID] = NO_PARENT_ID;
 
 	// Layers have changed
@@ -112,7 +112,7 @@ void LayerManager::deleteLayer(const std::string& name)
 	_layers.erase(layerID);
 
 	// Reset the visibility flag to TRUE, remove parent
-	_layerVisibility[layerID] = true;
+	setVisibilityFlag(layerID, true);
 	_layerParentIds[layerID] = NO_PARENT_ID;
 
 	if (layerID == _activeLayer)
@@ -145,7 +145,8 @@ void LayerManager::reset()
 	_layers.emplace(DEFAULT_LAYER, _(DEFAULT_LAYER_NAME));
 
 	_layerVisibility.resize(1);
-	_layerVisibility[DEFAULT_LAYER] = true;
+	_visibleLayers.clear();
+	setVisibilityFlag(DEFAULT_LAYER, true);
 
     _layerParentIds.resize(1);
     _layerParentIds[DEFAULT_LAYER] = NO_PARENT_ID;
@@ -256,12 +257,26 @@ bool LayerManager::setLayerVisibilityRecursively(int rootLayerId, bool visible)
         if (layerId < 0 || layerId >= _layerVisibility.size()) return;
 
         visibilityChange |= _layerVisibility.at(layerId) != visible;
-        _layerVisibility.at(layerId) = visible;
+        setVisibilityFlag(layerId, visible);
     });
 
     return visibilityChange;
 }
 
+void LayerManager::setVisibilityFlag(int layerId, bool visible)
+{
+    _layerVisibility[layerId] = visible;
+
+    if (visible)
+    {
+        _visibleLayers.insert(layerId);
+    }
+    else
+    {
+        _visibleLayers.erase(layerId);
+    }
+}
+
 void LayerManager::updateSceneGraphVisibility()
 {
 	UpdateNodeVisibilityWalker walker(*this);
@@ -338,20 +353,9 @@ bool LayerManager::updateNodeVisibility(const INodePtr& node)
 	// Get the list of layers the node is associated with
 	const auto& layers = node->getLayers();
 
-	// We start with the assumption that a node is hidden
-    bool isHidden = true;
-
-	// Cycle through the Node's layers, and show the node as soon as
-	// a visible layer is found.
-	for (int layerId : layers)
-	{
-		if (_layerVisibility[layerId])
-		{
-			// The layer is visible, set the visibility to true and quit
-            isHidden = false;
-			break;
-		}
-	}
+	// The node is hidden unless it is a member of at least one visible layer,
+	// for the usual layer IDs this boils down to a single mask comparison
+    bool isHidden = !layers.intersects(_visibleLayers);
 
     if (isHidden)
     {
@@ -21,6 +21,10 @@ private:
 	// quickly check whether a layer is visible or not.
     std::vector<bool> _layerVisibility;
 
+    // The IDs of all visible layers, kept in sync with _layerVisibility.
+    // Used to check a node's layer membership in one go.
+    LayerList _visibleLayers;
+
     // The parent IDs of each layer (-1 for no parent)
     std::vector<int> _layerParentIds;
 
@@ -127,6 +131,9 @@ private:
     // Returns true if any flag changed, false if nothing changed.
     bool setLayerVisibilityRecursively(int layerID, bool visible);
 
+    // Sets the visibility flag of a single layer, the ID must be in range
+    void setVisibilityFlag(int layerId, bool visible);
+
     // Invokes the function object with each layer ID in the hierarchy, including the given root
     void foreachLayerInHierarchy(int rootLayerId, const std::function<void(int)>& functor);
 
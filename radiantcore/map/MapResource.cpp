@@ -417,7 +417,8 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	rMessage() << "Opening file " << outFile.string();
 
 	// Open the stream to the primary output file
-	std::ofstream outFileStream(outFile.string());
+	std::ofstream outFileStream(outFile.string(),
+		format.isBinaryFormat() ? std::ios::out | std::ios::binary : std::ios::out);
 	std::unique_ptr<std::ofstream> auxFileStream; // aux stream is optional
 
 	// Check writeability of the auxiliary output file if necessary
@@ -444,24 +445,106 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 
 	rMessage() << "success" << std::endl;
 
+	exportToStreams(format, root, traverse, outFileStream, auxFileStream.get());
+
+	// Check for any stream failures now that we're done writing
+	if (outFileStream.fail())
+	{
+		throw OperationException(fmt::format(_("Failure writing to file {0}"), outFile.string()));
+	}
+
+	if (auxFileStream && auxFileStream->fail())
+	{
+		throw OperationException(fmt::format(_("Failure writing to file {0}"), auxFile.string()));
+	}
+}
+
+MapResource::SerialisedFile MapResource::serialiseFile(const MapFormat& format,
+    const scene::IMapRootNodePtr& root, const GraphTraversalFunc& traverse, const std::string& filename)
+{
+    SerialisedFile result;
+    result.mapFile = filename;
+    result.binary = format.isBinaryFormat();
+
+    std::ostringstream mapStream;
+    std::unique_ptr<std::ostringstream> infoFileStream;
+
+    if (format.allowInfoFileCreation())
+    {
+        result.infoFile = result.mapFile;
+        result.infoFile.replace_extension(game::current::getInfoFileExtension());
+
+        infoFileStream = std::make_unique<std::ostringstream>();
+    }
+
+    exportToStreams(format, root, traverse, mapStream, infoFileStream.get());
+
+    result.mapText = mapStream.str();
+
+    if (infoFileStream)
+    {
+        result.infoFileText = infoFileStream->str();
+    }
+
+    return result;
+}
+
+void MapResource::writeSerialisedFile(const SerialisedFile& file)
+{
+    throwIfNotWriteable(file.mapFile);
+
+    if (!file.infoFile.empty())
+    {
+        throwIfNotWriteable(file.infoFile);
+    }
+
+    auto writeFile = [](const fs::path& path, const std::string& contents, bool binary)
+    {
+        std::ofstream stream(path.string(), binary ? std::ios::out | std::ios::binary : std::ios::out);
+
+        if (!stream.is_open())
+        {
+            throw OperationException(fmt::format(_("Could not open file for writing: {0}"), path.string()));
+        }
+
+        stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        stream.close();
+
+        if (stream.fail())
+        {
+            throw OperationException(fmt::format(_("Failure writing to file {0}"), path.string()));
+        }
+    };
+
+    writeFile(file.mapFile, file.mapText, file.binary);
+
+    if (!file.infoFile.empty())
+    {
+        writeFile(file.infoFile, file.infoFileText, false);
+    }
+}
+
+void MapResource::exportToStreams(const MapFormat& format, const scene::IMapRootNodePtr& root,
+    const GraphTraversalFunc& traverse, std::ostream& mapStream, std::ostream* infoFileStream)
+{
 	// Check the total count of nodes to traverse
 	NodeCounter counter;
 	traverse(root, counter);
-		
-	// Create our main MapExporter walker, and pass the desired 
+
+	// Create our main MapExporter walker, and pass the desired
 	// format to it. The constructor will prepare the scene
 	// and the destructor will clean it up afterwards. That way
 	// we ensure a nice and tidy scene when exceptions are thrown.
 	MapExporterPtr exporter;
 	auto mapWriter = format.getMapWriter();
 
-	if (format.allowInfoFileCreation())
+	if (infoFileStream)
 	{
-		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, *auxFileStream, counter.getCount()));
+		exporter.reset(new MapExporter(*mapWriter, root, mapStream, *infoFileStream, counter.getCount()));
 	}
 	else
 	{
-		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, counter.getCount())); // no aux stream
+		exporter.reset(new MapExporter(*mapWriter, root, mapStream, counter.getCount())); // no aux stream
 	}
 
 	try
@@ -474,17 +557,6 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	{
 		throw OperationException(_("Map writing cancelled"));
 	}
-
-	// Check for any stream failures now that we're done writing
-	if (outFileStream.fail())
-	{
-		throw OperationException(fmt::format(_("Failure writing to file {0}"), outFile.string()));
-	}
-
-	if (auxFileStream && auxFileStream->fail())
-	{
-		throw OperationException(fmt::format(_("Failure writing to file {0}"), auxFile.string()));
-	}
 }
 
 } // namespace map
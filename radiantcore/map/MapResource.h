@@ -66,6 +66,31 @@ public:
 	static void saveFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
 						 const GraphTraversalFunc& traverse, const std::string& filename);
 
+    // The map (and info file) contents exported by serialiseFile()
+    struct SerialisedFile
+    {
+        fs::path mapFile;
+        std::string mapText;
+
+        // True if the map file must be written without line ending conversion
+        bool binary = false;
+
+        // Empty if the format doesn't create an info file
+        fs::path infoFile;
+        std::string infoFileText;
+    };
+
+    // First half of saveFile(): exports the map contents to memory, using the given
+    // MapFormat export module. This is the only part accessing the scene, the
+    // result can be passed to writeSerialisedFile() on any thread.
+    // Throws an OperationException if the export has been cancelled
+    static SerialisedFile serialiseFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
+                                        const GraphTraversalFunc& traverse, const std::string& filename);
+
+    // Second half of saveFile(): writes the contents exported by serialiseFile() to disk.
+    // Throws an OperationException if anything prevents successful completion
+    static void writeSerialisedFile(const SerialisedFile& file);
+
 protected:
     // Implementation-specific method to open the stream of the primary .map or .mapx file
     // May return an empty reference, may throw OperationException on failure
@@ -98,6 +123,11 @@ private:
 
 	// Checks if file can be overwritten (throws on failure)
 	static void throwIfNotWriteable(const fs::path& path);
+
+    // Runs the MapExporter on the given streams, the info file stream is optional
+    static void exportToStreams(const MapFormat& format, const scene::IMapRootNodePtr& root,
+                                const GraphTraversalFunc& traverse, std::ostream& mapStream,
+                                std::ostream* infoFileStream);
 };
 
 } // namespace map
@@ -4,6 +4,7 @@
 #include "fmt/format.h"
 #include "scene/ChildPrimitives.h"
 #include "scenelib.h"
+#include "algorithm/BrushEvaluation.h"
 #include "algorithm/MapImporter.h"
 #include "messages/MapFileOperation.h"
 
@@ -36,6 +37,9 @@ RootNodePtr MapResourceLoader::load()
         // Prepare child primitives
         scene::addOriginToChildPrimitives(root);
 
+        // Build the brush windings up front, which is faster than doing it lazily on scene insertion
+        algorithm::evaluateBrushes(root);
+
         // Move the index mapping to this class before destroying the import filter
         _indexMapping.swap(importFilter.getNodeMap());
 
@@ -0,0 +1,51 @@
+#include "BrushEvaluation.h"
+
+#include <vector>
+#include "ibrush.h"
+#include "util/ParallelFor.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+namespace
+{
+    // Below this number of brushes it's not worth starting any threads
+    constexpr std::size_t MIN_BRUSHES_FOR_CONCURRENCY = 64;
+}
+
+void evaluateBrushes(const scene::INodePtr& root)
+{
+    std::vector<IBrush*> brushes;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto* brush = Node_getIBrush(node); brush != nullptr)
+        {
+            brushes.push_back(brush);
+        }
+
+        return true;
+    });
+
+    // The windings of each brush only depend on its own faces, build them concurrently
+    if (brushes.size() >= MIN_BRUSHES_FOR_CONCURRENCY)
+    {
+        util::parallelForDynamic(brushes.size(), [&](std::size_t index)
+        {
+            brushes[index]->prepareBRep();
+        });
+    }
+
+    // Publishing the windings notifies the brush observers and renderables
+    for (auto* brush : brushes)
+    {
+        brush->evaluateBRep();
+    }
+}
+
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "inode.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+/**
+ * Re-evaluates the geometry of all brushes below the given node. The windings
+ * and bounds are constructed on several threads, the results are published
+ * to the brushes and their observers on the calling thread afterwards.
+ */
+void evaluateBrushes(const scene::INodePtr& root);
+
+}
+
+}
@@ -15,6 +15,7 @@
 
 #include "scene/ChildPrimitives.h"
 #include "messages/MapFileOperation.h"
+#include "BrushEvaluation.h"
 
 namespace map
 {
@@ -298,17 +299,7 @@ void MapExporter::finishScene()
 
 void MapExporter::recalculateBrushWindings()
 {
-	_root->foreachNode([] (const scene::INodePtr& child)->bool
-	{
-		auto* brush = Node_getIBrush(child);
-
-		if (brush != nullptr)
-		{
-			brush->evaluateBRep();
-		}
-
-		return true;
-	});
+	algorithm::evaluateBrushes(_root);
 }
 
 } // namespace
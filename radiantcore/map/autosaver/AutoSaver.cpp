@@ -6,6 +6,7 @@
 #include "imapfilechangetracker.h"
 #include "itextstream.h"
 #include "iscenegraph.h"
+#include "scene/Traverse.h"
 #include "iradiant.h"
 #include "iregistry.h"
 #include "igame.h"
@@ -27,6 +28,8 @@
 #include "messages/NotificationMessage.h"
 #include "messages/AutomaticMapSaveRequest.h"
 #include "map/Map.h"
+#include "map/MapResource.h"
+#include "time/StopWatch.h"
 
 #include <fmt/format.h>
 
@@ -57,12 +60,14 @@ namespace
 
 AutoMapSaver::AutoMapSaver() :
 	_snapshotsEnabled(false),
+	_saveInBackground(false),
     _savedChangeCount(0)
 {}
 
 void AutoMapSaver::registryKeyChanged()
 {
 	_snapshotsEnabled = registry::getValue<bool>(RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
+	_saveInBackground = registry::getValue<bool>(RKEY_AUTOSAVE_IN_BACKGROUND);
 }
 
 void AutoMapSaver::clearChanges()
@@ -111,7 +116,7 @@ void AutoMapSaver::saveSnapshot()
 		rMessage() << "Autosaving snapshot to " << filename << std::endl;
 
 		// Dump to map to the next available filename
-        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+        saveBackup(filename);
 
 		handleSnapshotSizeLimit(existingSnapshots, snapshotPath, mapName);
 	}
@@ -121,6 +126,91 @@ void AutoMapSaver::saveSnapshot()
 	}
 }
 
+void AutoMapSaver::saveBackup(const std::string& filename)
+{
+    util::StopWatch timer;
+
+    if (!_saveInBackground)
+    {
+        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+
+        rMessage() << "Autosave blocked the editor for " << timer.getMilliSecondsPassed() << " ms" << std::endl;
+        return;
+    }
+
+    // The scene is exported to memory right here, which is cheap since the writers
+    // reuse the text of unchanged nodes. Writing the files is left to a worker thread.
+    auto format = GlobalMap().getMapFormatForFilenameSafe(filename);
+
+    try
+    {
+        auto serialised = std::make_shared<MapResource::SerialisedFile>(
+            MapResource::serialiseFile(*format, GlobalSceneGraph().root(), scene::traverse, filename));
+
+        _pendingSaveFilename = filename;
+        _pendingSave = std::async(std::launch::async, [serialised]()
+        {
+            MapResource::writeSerialisedFile(*serialised);
+        });
+    }
+    catch (const IMapResource::OperationException& ex)
+    {
+        radiant::NotificationMessage::SendError(ex.what());
+        return;
+    }
+
+    rMessage() << "Autosave blocked the editor for " << timer.getMilliSecondsPassed() <<
+        " ms, writing the files in the background" << std::endl;
+}
+
+bool AutoMapSaver::checkPendingSave()
+{
+    if (!_pendingSave.valid())
+    {
+        return false;
+    }
+
+    if (_pendingSave.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        return true;
+    }
+
+    finishPendingSave();
+    return false;
+}
+
+void AutoMapSaver::waitForPendingSave()
+{
+    if (_pendingSave.valid())
+    {
+        finishPendingSave();
+    }
+}
+
+void AutoMapSaver::finishPendingSave()
+{
+    try
+    {
+        // Blocks if the write is still in progress, and re-throws any error of the worker
+        _pendingSave.get();
+
+        rMessage() << "Autosave written to " << _pendingSaveFilename << std::endl;
+    }
+    catch (const IMapResource::OperationException& ex)
+    {
+        rError() << "Autosave to " << _pendingSaveFilename << " failed: " << ex.what() << std::endl;
+        radiant::NotificationMessage::SendError(ex.what());
+    }
+    catch (const std::exception& ex)
+    {
+        rError() << "Autosave to " << _pendingSaveFilename << " failed: " << ex.what() << std::endl;
+        radiant::NotificationMessage::SendError(
+            fmt::format(_("Failed to write the automatic backup {0}:\n{1}"), _pendingSaveFilename, ex.what()));
+    }
+
+    _pendingSaveFilename.clear();
+}
+
 void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& existingSnapshots,
 	const fs::path& snapshotPath, const std::string& mapName)
 {
@@ -200,6 +290,12 @@ void AutoMapSaver::collectExistingSnapshots(std::map<int, std::string>& existing
 
 bool AutoMapSaver::runAutosaveCheck()
 {
+    // Don't start another save while the previous one is still being written
+    if (checkPendingSave())
+    {
+        return false;
+    }
+
     // Check, if changes have been made since the last autosave
     if (!GlobalSceneGraph().root() || _savedChangeCount == GlobalSceneGraph().root()->getUndoChangeTracker().getCurrentChangeCount())
     {
@@ -220,6 +316,9 @@ bool AutoMapSaver::runAutosaveCheck()
 
 void AutoMapSaver::performAutosave()
 {
+    // Snapshot numbering relies on the previous files being complete
+    waitForPendingSave();
+
     // Remember the change tracking counter
     _savedChangeCount = GlobalSceneGraph().root()->getUndoChangeTracker().getCurrentChangeCount();
 
@@ -252,7 +351,7 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving unnamed map to " << autoSaveFilename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", autoSaveFilename);
+            saveBackup(autoSaveFilename);
         }
         else
         {
@@ -268,7 +367,7 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving map to " << filename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+            saveBackup(filename);
         }
     }
 }
@@ -278,6 +377,7 @@ void AutoMapSaver::constructPreferences()
 	// Add a page to the given group
 	IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Settings/Autosave"));
 
+	page.appendCheckBox(_("Write Autosave Files in the Background"), RKEY_AUTOSAVE_IN_BACKGROUND);
 	page.appendCheckBox(_("Save Snapshots"), RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
 	page.appendEntry(_("Snapshot Folder (absolute, or relative to Map Folder)"), RKEY_AUTOSAVE_SNAPSHOTS_FOLDER);
 	page.appendEntry(_("Max total Snapshot size per Map (MB)"), RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE);
@@ -293,6 +393,8 @@ void AutoMapSaver::onMapEvent(IMap::MapEvent ev)
 	case IMap::MapLoaded:
 	case IMap::MapUnloading:
 	case IMap::MapUnloaded:
+		// Let the previous map's backup finish before touching any files
+		waitForPendingSave();
 		clearChanges();
 		break;
     default:
@@ -325,6 +427,9 @@ void AutoMapSaver::initialiseModule(const IApplicationContext& ctx)
 	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_SNAPSHOTS_ENABLED).connect(
 		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
 	));
+	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_IN_BACKGROUND).connect(
+		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
+	));
 
 	// Get notified when the map is loaded afresh
 	_signalConnections.push_back(GlobalMapModule().signal_mapEvent().connect(
@@ -343,6 +448,8 @@ void AutoMapSaver::initialiseModule(const IApplicationContext& ctx)
 
 void AutoMapSaver::shutdownModule()
 {
+	waitForPendingSave();
+
 	// Unsubscribe from all connections
 	for (sigc::connection& connection : _signalConnections)
 	{
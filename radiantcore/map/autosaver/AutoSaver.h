@@ -6,6 +6,7 @@
 #include "iautosaver.h"
 
 #include <vector>
+#include <future>
 #include <sigc++/connection.h>
 #include "os/fs.h"
 
@@ -23,6 +24,13 @@ private:
 	// TRUE, if the autosaver generates snapshots
 	bool _snapshotsEnabled;
 
+	// TRUE, if the files are written by a worker thread
+	bool _saveInBackground;
+
+	// The background write started by the last autosave (if any)
+	std::future<void> _pendingSave;
+	std::string _pendingSaveFilename;
+
 	std::size_t _savedChangeCount;
 
 	std::vector<sigc::connection> _signalConnections;
@@ -46,6 +54,9 @@ public:
 
     void performAutosave() override;
 
+    bool checkPendingSave() override;
+    void waitForPendingSave() override;
+
 private:
 	void constructPreferences();
 
@@ -56,6 +67,12 @@ private:
 	// Saves a snapshot of the currently active map (only named maps)
 	void saveSnapshot();
 
+	// Saves the current map to the given file, either directly or in the background
+	void saveBackup(const std::string& filename);
+
+	// Reports the outcome of the finished background write
+	void finishPendingSave();
+
 	void collectExistingSnapshots(std::map<int, std::string>& existingSnapshots,
 		const fs::path& snapshotPath, const std::string& mapName);
 
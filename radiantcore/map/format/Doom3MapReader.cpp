@@ -5,11 +5,15 @@
 #include "igame.h"
 #include "ientity.h"
 #include "string/string.h"
+#include "stream/utils.h"
 
 #include "Doom3MapFormat.h"
 
 #include "i18n.h"
 #include <fmt/format.h>
+#include <condition_variable>
+#include <mutex>
+#include "util/ParallelFor.h"
 
 #include "primitiveparsers/BrushDef.h"
 #include "primitiveparsers/BrushDef3.h"
@@ -24,13 +28,116 @@ Doom3MapReader::Doom3MapReader(IMapImportFilter& importFilter) :
 	_primitiveCount(0)
 {}
 
+namespace
+{
+	inline bool isWhitespace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	// Splits the map text into the top-level brace blocks (the entities), skipping
+	// quoted strings and comments like the tokeniser does. Returns false if there is
+	// anything other than the version header in front of the first block, or if the
+	// braces are unbalanced, in which case the text needs to be parsed sequentially.
+	bool findEntityBlocks(std::string_view text, std::vector<std::string_view>& blocks)
+	{
+		const char* const begin = text.data();
+		const char* const end = begin + text.size();
+		const char* blockStart = nullptr;
+		std::size_t depth = 0;
+
+		for (const char* p = begin; p != end;)
+		{
+			char c = *p;
+
+			if (c == '"')
+			{
+				// Skip the quoted string, backslashes are escaping the next character
+				for (++p; p != end && *p != '"'; ++p)
+				{
+					if (*p == '\\' && p + 1 != end) ++p;
+				}
+
+				if (p == end) return false; // unterminated quote
+
+				++p;
+			}
+			else if (c == '/' && p + 1 != end && p[1] == '/')
+			{
+				while (p != end && *p != '\n') ++p;
+			}
+			else if (c == '/' && p + 1 != end && p[1] == '*')
+			{
+				auto commentEnd = text.find("*/", p - begin + 2);
+				p = commentEnd == std::string_view::npos ? end : begin + commentEnd + 2;
+			}
+			else if (c == '{')
+			{
+				if (depth++ == 0)
+				{
+					blockStart = p;
+				}
+
+				++p;
+			}
+			else if (c == '}')
+			{
+				if (depth == 0) return false;
+
+				if (--depth == 0)
+				{
+					blocks.emplace_back(blockStart, p + 1 - blockStart);
+				}
+
+				++p;
+			}
+			else
+			{
+				// Stray tokens between the entities
+				if (depth == 0 && !blocks.empty() && !isWhitespace(c)) return false;
+
+				++p;
+			}
+		}
+
+		return depth == 0 && !blocks.empty();
+	}
+}
+
 void Doom3MapReader::readFromStream(std::istream& stream)
 {
 	// Call the virtual method to initialise the primitve parser map (if not done yet)
 	initPrimitiveParsers();
 
-	// The tokeniser used to split the stream into pieces
-	parser::BasicDefTokeniser<std::istream> tok(stream);
+	auto startPosition = stream.tellg();
+
+	// Load the whole map text, the buffer-based tokeniser doesn't need to copy
+	// any tokens and is considerably faster than the std::istream one
+	auto buffer = stream::readAll(stream);
+
+	// Reading to EOF set the failbit, the import filter still needs the stream position
+	stream.clear();
+
+	// Entities can be parsed independently, split the text at the entity boundaries
+	std::vector<std::string_view> entityBlocks;
+
+	if (findEntityBlocks(buffer, entityBlocks))
+	{
+		parser::BasicDefTokeniser<std::string_view> headerTok(
+			std::string_view(buffer).substr(0, entityBlocks.front().data() - buffer.data()));
+
+		// Try to parse the map version (throws on failure)
+		parseMapVersion(headerTok);
+
+		if (!headerTok.hasMoreTokens())
+		{
+			parseEntitiesConcurrently(stream, startPosition, buffer, entityBlocks);
+			return;
+		}
+	}
+
+	// Fall back to the sequential parser, which reports any syntax errors
+	parser::BasicDefTokeniser<std::string_view> tok(buffer);
 
 	// Try to parse the map version (throws on failure)
 	parseMapVersion(tok);
@@ -58,6 +165,78 @@ void Doom3MapReader::readFromStream(std::istream& stream)
 	// EOF reached, success
 }
 
+void Doom3MapReader::parseEntitiesConcurrently(std::istream& stream, std::istream::pos_type startPosition,
+	const std::string& buffer, const std::vector<std::string_view>& blocks)
+{
+	// The entity blocks are parsed and their primitive nodes constructed by the worker threads,
+	// while this thread is inserting the finished entities in their original order
+	std::vector<ParsedEntity> entities(blocks.size());
+	std::vector<bool> finished(blocks.size(), false);
+	std::mutex lock;
+	std::condition_variable entityFinished;
+	std::atomic<bool> cancelled(false);
+
+	auto workers = std::async(std::launch::async, [&]()
+	{
+		util::parallelForDynamic(blocks.size(), [&](std::size_t index)
+		{
+			if (!cancelled)
+			{
+				parseEntityBlock(blocks[index], entities[index]);
+			}
+
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				finished[index] = true;
+			}
+
+			entityFinished.notify_one();
+		});
+	});
+
+	try
+	{
+		for (std::size_t i = 0; i < entities.size(); ++i)
+		{
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				entityFinished.wait(guard, [&]() { return finished[i]; });
+			}
+
+			try
+			{
+				insertParsedEntity(entities[i]);
+			}
+			catch (FailureException& e)
+			{
+				std::string text = fmt::format(_("Failed parsing entity {0:d}:\n{1}"), _entityCount, e.what());
+
+				// Re-throw with more text
+				throw FailureException(text);
+			}
+
+			// The import filter derives the progress from the stream position
+			if (startPosition != std::istream::pos_type(-1))
+			{
+				stream.seekg(startPosition + std::streamoff(blocks[i].data() + blocks[i].size() - buffer.data()));
+				stream.clear();
+			}
+
+			entities[i] = ParsedEntity();
+			_entityCount++;
+		}
+	}
+	catch (...)
+	{
+		// Let the workers run out before leaving, they're referencing our locals
+		cancelled = true;
+		workers.wait();
+		throw;
+	}
+
+	workers.get();
+}
+
 void Doom3MapReader::initPrimitiveParsers()
 {
 	if (_primitiveParsers.empty())
@@ -121,6 +300,14 @@ void Doom3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INod
 {
     _primitiveCount++;
 
+	scene::INodePtr primitive = parsePrimitiveNode(tok, _primitiveCount);
+
+	// Now add the primitive as a child of the entity
+	_importFilter.addPrimitiveToEntity(primitive, parentEntity);
+}
+
+scene::INodePtr Doom3MapReader::parsePrimitiveNode(parser::DefTokeniser& tok, std::size_t primitiveNum) const
+{
 	std::string primitiveKeyword = tok.nextToken();
 
 	// Get a parser for this keyword
@@ -140,17 +327,16 @@ void Doom3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INod
 
 		if (!primitive)
 		{
-			std::string text = fmt::format(_("Primitive #{0:d}: parse error"), _primitiveCount);
+			std::string text = fmt::format(_("Primitive #{0:d}: parse error"), primitiveNum);
 			throw FailureException(text);
 		}
 
-		// Now add the primitive as a child of the entity
-		_importFilter.addPrimitiveToEntity(primitive, parentEntity); 
+		return primitive;
 	}
 	catch (parser::ParseException& e)
 	{
 		// Translate ParseExceptions to FailureExceptions
-		std::string text = fmt::format(_("Primitive #{0:d}: parse exception {1}"), _primitiveCount, e.what());
+		std::string text = fmt::format(_("Primitive #{0:d}: parse exception {1}"), primitiveNum, e.what());
 		throw FailureException(text);
 	}
 }
@@ -257,4 +443,76 @@ void Doom3MapReader::parseEntity(parser::DefTokeniser& tok)
 	_importFilter.addEntity(entity);
 }
 
+void Doom3MapReader::parseEntityBlock(std::string_view block, ParsedEntity& entity) const
+{
+	// Same syntax as in parseEntity(), keys following the first primitive are ignored
+	try
+	{
+		parser::BasicDefTokeniser<std::string_view> tok(block);
+
+		tok.assertNextToken("{");
+
+		std::string token = tok.nextToken();
+		std::size_t primitiveCount = 0;
+
+		while (true)
+		{
+			if (token == "{") // PRIMITIVE
+			{
+				entity.keyValuesComplete = true;
+				entity.primitives.push_back(parsePrimitiveNode(tok, ++primitiveCount));
+			}
+			else if (token == "}") // END OF ENTITY
+			{
+				entity.keyValuesComplete = true;
+				break;
+			}
+			else // KEY
+			{
+				std::string value = tok.nextToken();
+
+				if (value == "{" || value == "}")
+				{
+					std::string text = fmt::format(_("Parsed invalid value '{0}' for key '{1}'"), value, token);
+					throw FailureException(text);
+				}
+
+				if (!entity.keyValuesComplete)
+				{
+					entity.keyValues.insert(EntityKeyValues::value_type(token, value));
+				}
+			}
+
+			token = tok.nextToken();
+		}
+	}
+	catch (...)
+	{
+		entity.error = std::current_exception();
+	}
+}
+
+void Doom3MapReader::insertParsedEntity(ParsedEntity& entity)
+{
+	// The sequential parser is creating the entity before the first primitive,
+	// report a missing classname before any primitive errors
+	if (entity.keyValuesComplete)
+	{
+		auto node = createEntity(entity.keyValues);
+
+		for (const auto& primitive : entity.primitives)
+		{
+			_importFilter.addPrimitiveToEntity(primitive, node);
+		}
+
+		if (!entity.error)
+		{
+			_importFilter.addEntity(node);
+			return;
+		}
+	}
+
+	std::rethrow_exception(entity.error);
+}
+
 } // namespace map
@@ -2,6 +2,10 @@
 #define NODE_IMPORTER_H_
 
 #include <map>
+#include <vector>
+#include <exception>
+#include <string_view>
+#include <istream>
 #include "inode.h"
 #include "imapformat.h"
 #include "parser/DefTokeniser.h"
@@ -27,6 +31,22 @@ protected:
 	typedef std::map<std::string, PrimitiveParserPtr> PrimitiveParsers;
 	PrimitiveParsers _primitiveParsers;
 
+	// The contents of a single entity block, parsed without touching the scene
+	struct ParsedEntity
+	{
+		// The keyvalues preceding the first primitive
+		EntityKeyValues keyValues;
+
+		// Set once the first primitive or the end of the block has been reached
+		bool keyValuesComplete = false;
+
+		// The primitive nodes, in the order they appear in the file
+		std::vector<scene::INodePtr> primitives;
+
+		// Set if parsing failed
+		std::exception_ptr error;
+	};
+
 public:
 	Doom3MapReader(IMapImportFilter& importFilter);
 
@@ -49,6 +69,23 @@ protected:
 	// Parse the primitive block and insert the child into the given parent
 	virtual void parsePrimitive(parser::DefTokeniser& tok, const scene::INodePtr& parentEntity);
 
+	// Parses the given block of entity text into the given structure, without
+	// touching any shared state. This is called by several threads at once.
+	void parseEntityBlock(std::string_view block, ParsedEntity& entity) const;
+
+	// Constructs the node of the primitive with the given (1-based) number, throws on failure
+	scene::INodePtr parsePrimitiveNode(parser::DefTokeniser& tok, std::size_t primitiveNum) const;
+
+	// Creates the entity and passes it along with its primitives to the import filter,
+	// re-throws the parse error of the entity after inserting the primitives before it
+	void insertParsedEntity(ParsedEntity& entity);
+
+private:
+	// Parses the given entity blocks of the map text on several threads,
+	// inserting the entities in the order they appear in the file
+	void parseEntitiesConcurrently(std::istream& stream, std::istream::pos_type startPosition,
+		const std::string& buffer, const std::vector<std::string_view>& blocks);
+
 	// Create an entity with the given properties and layers
 	scene::INodePtr createEntity(const EntityKeyValues& keyValues);
 };
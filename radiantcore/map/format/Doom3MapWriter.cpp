@@ -5,6 +5,7 @@
 
 #include "primitivewriters/BrushDef3Exporter.h"
 #include "primitivewriters/PatchDefExporter.h"
+#include "primitivewriters/ExportUtil.h"
 
 #include "Doom3MapFormat.h"
 
@@ -48,8 +49,11 @@ void Doom3MapWriter::beginWriteEntity(const IEntityNodePtr& entity, std::ostream
 	// Entity opening brace
 	stream << "{" << std::endl;
 
-	// Entity key values
-	writeEntityKeyValues(entity, stream);
+	// Entity key values, reusing the text of the last export if the entity didn't change
+	writeCachedNodeText(stream, entity, "doom3EntityKeyValues", [&](std::ostream& output)
+	{
+		writeEntityKeyValues(entity, output);
+	});
 }
 
 void Doom3MapWriter::writeEntityKeyValues(const IEntityNodePtr& entity, std::ostream& stream)
@@ -76,7 +80,10 @@ void Doom3MapWriter::beginWriteBrush(const IBrushNodePtr& brush, std::ostream& s
 	stream << "// primitive " << _primitiveCount++ << std::endl;
 
 	// Export brushDef3 definition to stream
-	BrushDef3Exporter::exportBrush(stream, brush);
+	writeCachedNodeText(stream, brush, "brushDef3", [&](std::ostream& output)
+	{
+		BrushDef3Exporter::exportBrush(output, brush);
+	});
 }
 
 void Doom3MapWriter::endWriteBrush(const IBrushNodePtr& brush, std::ostream& stream)
@@ -90,7 +97,10 @@ void Doom3MapWriter::beginWritePatch(const IPatchNodePtr& patch, std::ostream& s
 	stream << "// primitive " << _primitiveCount++ << std::endl;
 
 	// Export patch here _mapStream
-	PatchDefExporter::exportPatch(stream, patch);
+	writeCachedNodeText(stream, patch, "patchDef", [&](std::ostream& output)
+	{
+		PatchDefExporter::exportPatch(output, patch);
+	});
 }
 
 void Doom3MapWriter::endWritePatch(const IPatchNodePtr& patch, std::ostream& stream)
@@ -26,7 +26,10 @@ public:
 		stream << "// primitive " << _primitiveCount++ << std::endl;
 
 		// Export brushDef3 definition to stream, but without contents flags
-		BrushDef3Exporter::exportBrush(stream, brush, false);
+		writeCachedNodeText(stream, brush, "brushDef3NoContentsFlags", [&](std::ostream& output)
+		{
+			BrushDef3Exporter::exportBrush(output, brush, false);
+		});
 	}
 };
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "imapformat.h"
+
+namespace map
+{
+
+namespace format
+{
+
+namespace binary
+{
+
+// Appends the given unsigned integer to the buffer, least significant byte first
+template<typename UnsignedType>
+inline void writeUnsigned(std::string& buffer, UnsignedType value)
+{
+    for (std::size_t i = 0; i < sizeof(UnsignedType); ++i)
+    {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline void writeInt32(std::string& buffer, std::int32_t value)
+{
+    writeUnsigned(buffer, static_cast<std::uint32_t>(value));
+}
+
+inline void writeDouble(std::string& buffer, double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUnsigned(buffer, bits);
+}
+
+/**
+ * Reads the values written by the functions above from a block of memory,
+ * which is usually a memory mapping of the map file. Throws an
+ * IMapReader::FailureException when reading past the end of the block.
+ */
+class InputCursor
+{
+private:
+    const unsigned char* _begin;
+    const unsigned char* _current;
+    const unsigned char* _end;
+
+public:
+    InputCursor(const char* data, std::size_t size) :
+        _begin(reinterpret_cast<const unsigned char*>(data)),
+        _current(_begin),
+        _end(_begin + size)
+    {}
+
+    // The offset of the next value from the start of the block
+    std::size_t getPosition() const
+    {
+        return static_cast<std::size_t>(_current - _begin);
+    }
+
+    // Returns a pointer to the next numBytes bytes and advances the cursor
+    const unsigned char* consume(std::size_t numBytes)
+    {
+        if (static_cast<std::size_t>(_end - _current) < numBytes)
+        {
+            throw IMapReader::FailureException("Unexpected end of file");
+        }
+
+        auto result = _current;
+        _current += numBytes;
+        return result;
+    }
+
+    // Returns a cursor for the next numBytes bytes and advances this one past them
+    InputCursor split(std::size_t numBytes)
+    {
+        auto begin = consume(numBytes);
+        return InputCursor(reinterpret_cast<const char*>(begin), numBytes);
+    }
+
+    template<typename UnsignedType>
+    UnsignedType readUnsigned()
+    {
+        auto bytes = consume(sizeof(UnsignedType));
+        UnsignedType value = 0;
+
+        for (std::size_t i = 0; i < sizeof(UnsignedType); ++i)
+        {
+            value |= static_cast<UnsignedType>(bytes[i]) << (8 * i);
+        }
+
+        return value;
+    }
+
+    std::uint8_t readUInt8()
+    {
+        return *consume(1);
+    }
+
+    std::uint32_t readUInt32()
+    {
+        return readUnsigned<std::uint32_t>();
+    }
+
+    std::uint64_t readUInt64()
+    {
+        return readUnsigned<std::uint64_t>();
+    }
+
+    std::int32_t readInt32()
+    {
+        return static_cast<std::int32_t>(readUInt32());
+    }
+
+    double readDouble()
+    {
+        auto bits = readUInt64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+}
+
+}
+
+}
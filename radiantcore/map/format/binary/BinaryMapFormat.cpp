@@ -0,0 +1,92 @@
+#include "BinaryMapFormat.h"
+
+#include "imapformat.h"
+
+#include "BinaryMapReader.h"
+#include "BinaryMapWriter.h"
+
+#include "module/StaticModule.h"
+
+namespace map
+{
+
+namespace format
+{
+
+std::size_t BinaryMapFormat::Version = 1;
+const char* BinaryMapFormat::Name = BINARY_MAP_FORMAT_NAME;
+
+// RegisterableModule implementation
+const std::string& BinaryMapFormat::getName() const
+{
+	static std::string _name(typeid(BinaryMapFormat).name());
+	return _name;
+}
+
+const StringSet& BinaryMapFormat::getDependencies() const
+{
+	static StringSet _dependencies;
+
+	if (_dependencies.empty())
+	{
+		_dependencies.insert(MODULE_MAPFORMATMANAGER);
+	}
+
+	return _dependencies;
+}
+
+void BinaryMapFormat::initialiseModule(const IApplicationContext& ctx)
+{
+	// Register ourselves as map format for mapb files
+	GlobalMapFormatManager().registerMapFormat("mapb", shared_from_this());
+}
+
+void BinaryMapFormat::shutdownModule()
+{
+	// Unregister now that we're shutting down
+	GlobalMapFormatManager().unregisterMapFormat(shared_from_this());
+}
+
+const std::string& BinaryMapFormat::getMapFormatName() const
+{
+	static std::string _name = Name;
+	return _name;
+}
+
+const std::string& BinaryMapFormat::getGameType() const
+{
+	static std::string _gameType = "doom3";
+	return _gameType;
+}
+
+IMapReaderPtr BinaryMapFormat::getMapReader(IMapImportFilter& filter) const
+{
+	return std::make_shared<BinaryMapReader>(filter);
+}
+
+IMapWriterPtr BinaryMapFormat::getMapWriter() const
+{
+	return std::make_shared<BinaryMapWriter>();
+}
+
+bool BinaryMapFormat::allowInfoFileCreation() const
+{
+	// Layers, groups and sets are stored in the map file itself
+	return false;
+}
+
+bool BinaryMapFormat::isBinaryFormat() const
+{
+	return true;
+}
+
+bool BinaryMapFormat::canLoad(std::istream& stream) const
+{
+	return BinaryMapReader::CanLoad(stream);
+}
+
+module::StaticModuleRegistration<BinaryMapFormat> binaryMapModule;
+
+}
+
+}
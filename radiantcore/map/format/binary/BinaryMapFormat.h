@@ -0,0 +1,46 @@
+#pragma once
+
+#include "imapformat.h"
+
+namespace map
+{
+
+namespace format
+{
+
+/**
+ * Native binary map format, storing the map data without any text conversion
+ * for fast loading and saving of working copies. Maps can be converted to the
+ * text formats by saving them with the .map extension.
+ */
+class BinaryMapFormat :
+	public MapFormat,
+	public std::enable_shared_from_this<BinaryMapFormat>
+{
+public:
+	// Format version, written to the file header
+	static std::size_t Version;
+	static const char* Name;
+
+	typedef std::shared_ptr<BinaryMapFormat> Ptr;
+
+	// RegisterableModule implementation
+	virtual const std::string& getName() const override;
+	virtual const StringSet& getDependencies() const override;
+	virtual void initialiseModule(const IApplicationContext& ctx) override;
+	virtual void shutdownModule() override;
+
+	virtual const std::string& getMapFormatName() const override;
+	virtual const std::string& getGameType() const override;
+	virtual IMapReaderPtr getMapReader(IMapImportFilter& filter) const override;
+	virtual IMapWriterPtr getMapWriter() const override;
+
+	virtual bool allowInfoFileCreation() const override;
+	virtual bool isBinaryFormat() const override;
+
+	virtual bool canLoad(std::istream& stream) const override;
+};
+
+}
+
+} // namespace map
@@ -0,0 +1,459 @@
+#include "BinaryMapReader.h"
+
+#include <map>
+#include <cstring>
+#include <iterator>
+#include "itextstream.h"
+#include "iselectionset.h"
+#include "iselectiongroup.h"
+#include "ilayer.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "ieclass.h"
+#include "ientity.h"
+
+#include "BinaryMapFormat.h"
+#include "BinaryIO.h"
+#include "Constants.h"
+
+#include "scenelib.h"
+#include "patch/PatchConstants.h"
+#include "math/Plane3.h"
+#include "math/Matrix3.h"
+#include "stream/MemoryStreamBuf.h"
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace format
+{
+
+using namespace binary;
+
+BinaryMapReader::BinaryMapReader(IMapImportFilter& importFilter) :
+	_importFilter(importFilter)
+{}
+
+void BinaryMapReader::readFromStream(std::istream& stream)
+{
+	// Files from the filesystem are memory-mapped, read them in place
+	if (auto memoryBuffer = dynamic_cast<stream::MemoryStreamBuf*>(stream.rdbuf()); memoryBuffer != nullptr)
+	{
+		InputCursor cursor(memoryBuffer->data(), memoryBuffer->size());
+		readContents(stream, cursor);
+		return;
+	}
+
+	// Any other stream (e.g. from a PK4 archive) is loaded into memory first
+	std::string buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	stream.clear();
+
+	InputCursor cursor(buffer.data(), buffer.size());
+	readContents(stream, cursor);
+}
+
+void BinaryMapReader::readContents(std::istream& stream, InputCursor& cursor)
+{
+	if (std::memcmp(cursor.consume(SIGNATURE_LENGTH), SIGNATURE, SIGNATURE_LENGTH) != 0)
+	{
+		throw FailureException("Not a binary map file.");
+	}
+
+	if (cursor.readUInt32() != BinaryMapFormat::Version)
+	{
+		throw FailureException("Unsupported format version.");
+	}
+
+	readStringTable(cursor);
+
+	_selectionSets.clear();
+	_entity.reset();
+
+	while (true)
+	{
+		auto recordPosition = cursor.getPosition();
+		auto tag = cursor.readUInt8();
+
+		switch (tag)
+		{
+		case RECORD_END:
+			return;
+
+		case RECORD_LAYERS:
+			readLayers(cursor);
+			break;
+
+		case RECORD_SELECTIONGROUPS:
+			readSelectionGroups(cursor);
+			break;
+
+		case RECORD_SELECTIONSETS:
+			readSelectionSets(cursor);
+			break;
+
+		case RECORD_PROPERTIES:
+			readMapProperties(cursor);
+			break;
+
+		case RECORD_ENTITY:
+			// Keep the stream position in sync, the import filter uses it to report the progress
+			stream.seekg(static_cast<std::streamoff>(recordPosition));
+			readEntity(cursor);
+			break;
+
+		case RECORD_BRUSH:
+			readBrush(cursor);
+			break;
+
+		case RECORD_PATCH:
+			readPatch(cursor);
+			break;
+
+		default:
+			throw FailureException(fmt::format("Unknown record type {0} at offset {1}",
+				static_cast<int>(tag), recordPosition));
+		}
+	}
+}
+
+void BinaryMapReader::readStringTable(InputCursor& cursor)
+{
+	auto count = cursor.readUInt32();
+
+	_strings.clear();
+	_strings.reserve(count);
+
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		auto length = cursor.readUInt32();
+		auto characters = cursor.consume(length);
+
+		_strings.emplace_back(reinterpret_cast<const char*>(characters), length);
+	}
+}
+
+const std::string& BinaryMapReader::readString(InputCursor& cursor)
+{
+	auto index = cursor.readUInt32();
+
+	if (index >= _strings.size())
+	{
+		throw FailureException(fmt::format("Invalid string index {0}", index));
+	}
+
+	return _strings[index];
+}
+
+void BinaryMapReader::readLayers(InputCursor& cursor)
+{
+	auto& layerManager = _importFilter.getRootNode()->getLayerManager();
+	layerManager.reset();
+
+	auto count = cursor.readUInt32();
+	std::vector<std::pair<int, int>> hierarchy;
+
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		auto id = cursor.readInt32();
+		const auto& name = readString(cursor);
+		auto parentId = cursor.readInt32();
+		auto flags = cursor.readUInt8();
+
+		layerManager.createLayer(name, id);
+
+		if (flags & LAYER_ACTIVE)
+		{
+			layerManager.setActiveLayer(id);
+		}
+
+		// Set visibility (and make sure this happens before the hierarchy is restored)
+		if (flags & LAYER_HIDDEN)
+		{
+			layerManager.setLayerVisibility(id, false);
+		}
+
+		hierarchy.emplace_back(id, parentId);
+	}
+
+	// Restore the layer hierarchy after all layers have been created
+	for (const auto& pair : hierarchy)
+	{
+		layerManager.setParentLayer(pair.first, pair.second);
+	}
+}
+
+void BinaryMapReader::readSelectionGroups(InputCursor& cursor)
+{
+	auto& groupManager = _importFilter.getRootNode()->getSelectionGroupManager();
+	groupManager.deleteAllSelectionGroups();
+
+	auto count = cursor.readUInt32();
+
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		auto id = static_cast<std::size_t>(cursor.readUInt64());
+		const auto& name = readString(cursor);
+
+		auto group = groupManager.createSelectionGroup(id);
+		group->setName(name);
+	}
+}
+
+void BinaryMapReader::readSelectionSets(InputCursor& cursor)
+{
+	auto& setManager = _importFilter.getRootNode()->getSelectionSetManager();
+	setManager.deleteAllSelectionSets();
+
+	auto count = cursor.readUInt32();
+
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		_selectionSets.push_back(setManager.createSelectionSet(readString(cursor)));
+	}
+}
+
+void BinaryMapReader::readMapProperties(InputCursor& cursor)
+{
+	auto& root = *_importFilter.getRootNode();
+	root.clearProperties();
+
+	auto count = cursor.readUInt32();
+
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		const auto& key = readString(cursor);
+		const auto& value = readString(cursor);
+
+		root.setProperty(key, value);
+	}
+}
+
+void BinaryMapReader::readEntity(InputCursor& cursor)
+{
+	std::map<std::string, std::string> entityKeyValues;
+
+	auto count = cursor.readUInt32();
+
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		const auto& key = readString(cursor);
+		entityKeyValues[key] = readString(cursor);
+	}
+
+	// Get the classname from the EntityKeyValues
+	auto found = entityKeyValues.find("classname");
+
+	if (found == entityKeyValues.end())
+	{
+		throw FailureException("BinaryMapReader: could not find classname for entity.");
+	}
+
+	// Otherwise create the entity and add all of the properties
+	auto eclass = GlobalEntityClassManager().findClass(found->second);
+
+	if (!eclass)
+	{
+		rError() << "BinaryMapReader: Could not find entity class: " << found->second << std::endl;
+
+		// EntityClass not found, insert a brush-based one
+		eclass = GlobalEntityClassManager().findOrInsert(found->second, true);
+	}
+
+	auto entityNode = GlobalEntityModule().createEntity(eclass);
+
+	for (const auto& pair : entityKeyValues)
+	{
+		entityNode->getEntity().setKeyValue(pair.first, pair.second);
+	}
+
+	readNodeInfo(cursor, entityNode);
+
+	_importFilter.addEntity(entityNode);
+
+	_entity = entityNode;
+}
+
+void BinaryMapReader::readBrush(InputCursor& cursor)
+{
+	if (!_entity)
+	{
+		throw FailureException("BinaryMapReader: brush without entity.");
+	}
+
+	auto detailFlag = static_cast<IBrush::DetailFlag>(cursor.readUInt8());
+	auto numFaces = cursor.readUInt32();
+
+	// The face data is stored in consecutive arrays
+	auto planes = cursor.split(numFaces * PLANE_COMPONENTS * sizeof(double));
+	auto textureMatrices = cursor.split(numFaces * TEXTURE_MATRIX_COMPONENTS * sizeof(double));
+	auto materials = cursor.split(numFaces * sizeof(std::uint32_t));
+
+	auto node = GlobalBrushCreator().createBrush();
+
+	auto brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
+	assert(brushNode);
+
+	auto& brush = brushNode->getIBrush();
+	brush.setDetailFlag(detailFlag);
+
+	for (std::uint32_t i = 0; i < numFaces; ++i)
+	{
+		Plane3 plane;
+
+		plane.normal().x() = planes.readDouble();
+		plane.normal().y() = planes.readDouble();
+		plane.normal().z() = planes.readDouble();
+		plane.dist() = -planes.readDouble(); // negate d
+
+		Matrix3 texdef;
+
+		texdef.xx() = textureMatrices.readDouble();
+		texdef.yx() = textureMatrices.readDouble();
+		texdef.zx() = textureMatrices.readDouble();
+		texdef.xy() = textureMatrices.readDouble();
+		texdef.yy() = textureMatrices.readDouble();
+		texdef.zy() = textureMatrices.readDouble();
+
+		brush.addFace(plane, texdef, readString(materials));
+	}
+
+	// Cleanup redundant face planes
+	brush.removeRedundantFaces();
+
+	_importFilter.addPrimitiveToEntity(node, _entity);
+
+	readNodeInfo(cursor, node);
+}
+
+void BinaryMapReader::readPatch(InputCursor& cursor)
+{
+	if (!_entity)
+	{
+		throw FailureException("BinaryMapReader: patch without entity.");
+	}
+
+	bool isFixedSubdiv = cursor.readUInt8() != 0;
+	auto cols = cursor.readUInt32();
+	auto rows = cursor.readUInt32();
+	auto subdivX = cursor.readUInt32();
+	auto subdivY = cursor.readUInt32();
+	const auto& material = readString(cursor);
+
+	// setDims() would silently adjust invalid dimensions, reject them instead
+	if (cols < MIN_PATCH_WIDTH || cols > MAX_PATCH_WIDTH || cols % 2 == 0 ||
+		rows < MIN_PATCH_HEIGHT || rows > MAX_PATCH_HEIGHT || rows % 2 == 0)
+	{
+		throw FailureException(fmt::format("BinaryMapReader: invalid patch dimensions {0}x{1}.", cols, rows));
+	}
+
+	auto controlPoints = cursor.split(static_cast<std::size_t>(cols) * rows * PATCH_CONTROL_COMPONENTS * sizeof(double));
+
+	auto node = GlobalPatchModule().createPatch(isFixedSubdiv ? patch::PatchDefType::Def3 : patch::PatchDefType::Def2);
+
+	auto patchNode = std::dynamic_pointer_cast<IPatchNode>(node);
+	assert(patchNode);
+
+	auto& patch = patchNode->getPatch();
+
+	patch.setShader(material);
+	patch.setDims(cols, rows);
+
+	if (isFixedSubdiv)
+	{
+		patch.setFixedSubdivisions(true, Subdivisions(subdivX, subdivY));
+	}
+
+	for (std::size_t c = 0; c < patch.getWidth(); ++c)
+	{
+		for (std::size_t r = 0; r < patch.getHeight(); ++r)
+		{
+			auto& control = patch.ctrlAt(r, c);
+
+			control.vertex[0] = controlPoints.readDouble();
+			control.vertex[1] = controlPoints.readDouble();
+			control.vertex[2] = controlPoints.readDouble();
+			control.texcoord[0] = controlPoints.readDouble();
+			control.texcoord[1] = controlPoints.readDouble();
+		}
+	}
+
+	patch.controlPointsChanged();
+
+	_importFilter.addPrimitiveToEntity(node, _entity);
+
+	readNodeInfo(cursor, node);
+}
+
+void BinaryMapReader::readNodeInfo(InputCursor& cursor, const scene::INodePtr& sceneNode)
+{
+	// Layers
+	auto layerCount = cursor.readUInt32();
+	auto layers = scene::LayerList{};
+
+	for (std::uint32_t i = 0; i < layerCount; ++i)
+	{
+		layers.insert(cursor.readInt32());
+	}
+
+	sceneNode->assignToLayers(layers);
+
+	sceneNode->foreachNode([&](const scene::INodePtr& child)
+	{
+		if (!Node_isEntity(child) && !Node_isPrimitive(child))
+		{
+			child->assignToLayers(layers);
+		}
+
+		return true;
+	});
+
+	// Selection groups, in the order the node has been added to them
+	auto& groupManager = _importFilter.getRootNode()->getSelectionGroupManager();
+	auto groupCount = cursor.readUInt32();
+
+	for (std::uint32_t i = 0; i < groupCount; ++i)
+	{
+		auto group = groupManager.getSelectionGroup(static_cast<std::size_t>(cursor.readUInt64()));
+
+		if (group)
+		{
+			group->addNode(sceneNode);
+		}
+	}
+
+	// Selection sets
+	auto setCount = cursor.readUInt32();
+
+	for (std::uint32_t i = 0; i < setCount; ++i)
+	{
+		auto index = cursor.readUInt32();
+
+		if (index < _selectionSets.size())
+		{
+			_selectionSets[index]->addNode(sceneNode);
+		}
+	}
+}
+
+bool BinaryMapReader::CanLoad(std::istream& stream)
+{
+	char header[SIGNATURE_LENGTH + sizeof(std::uint32_t)];
+
+	if (!stream.read(header, sizeof(header)))
+	{
+		return false;
+	}
+
+	if (std::memcmp(header, SIGNATURE, SIGNATURE_LENGTH) != 0)
+	{
+		return false;
+	}
+
+	InputCursor cursor(header + SIGNATURE_LENGTH, sizeof(std::uint32_t));
+	return cursor.readUInt32() <= BinaryMapFormat::Version;
+}
+
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "inode.h"
+#include "imapformat.h"
+#include "iselectionset.h"
+
+namespace map
+{
+
+namespace format
+{
+
+namespace binary { class InputCursor; }
+
+/**
+ * Reader for the binary map format, see binary/Constants.h for the file layout.
+ *
+ * Map files opened from the filesystem are served through a memory mapping,
+ * the data is then read directly from the mapped memory.
+ */
+class BinaryMapReader :
+	public IMapReader
+{
+private:
+	IMapImportFilter& _importFilter;
+
+	// The string table of the file
+	std::vector<std::string> _strings;
+
+	// The selection sets, in the order they have been written
+	std::vector<selection::ISelectionSetPtr> _selectionSets;
+
+	// The entity the following primitives are added to
+	scene::INodePtr _entity;
+
+public:
+	BinaryMapReader(IMapImportFilter& importFilter);
+
+	// IMapReader implementation
+	void readFromStream(std::istream& stream) override;
+
+	static bool CanLoad(std::istream& stream);
+
+private:
+	void readContents(std::istream& stream, binary::InputCursor& cursor);
+
+	void readStringTable(binary::InputCursor& cursor);
+	const std::string& readString(binary::InputCursor& cursor);
+
+	void readLayers(binary::InputCursor& cursor);
+	void readSelectionGroups(binary::InputCursor& cursor);
+	void readSelectionSets(binary::InputCursor& cursor);
+	void readMapProperties(binary::InputCursor& cursor);
+	void readEntity(binary::InputCursor& cursor);
+	void readBrush(binary::InputCursor& cursor);
+	void readPatch(binary::InputCursor& cursor);
+	void readNodeInfo(binary::InputCursor& cursor, const scene::INodePtr& sceneNode);
+};
+
+}
+
+}
@@ -0,0 +1,308 @@
+#include "BinaryMapWriter.h"
+
+#include "ientity.h"
+#include "ipatch.h"
+#include "imap.h"
+#include "ibrush.h"
+#include "ilayer.h"
+#include "iselectiongroup.h"
+#include "iselectionset.h"
+
+#include "math/Plane3.h"
+#include "math/Matrix3.h"
+#include "BinaryMapFormat.h"
+#include "BinaryIO.h"
+#include "Constants.h"
+
+namespace map
+{
+
+namespace format
+{
+
+using namespace binary;
+
+void BinaryMapWriter::beginWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream)
+{
+	// Layers, including their hierarchy and state
+	auto& layerManager = root->getLayerManager();
+	auto activeLayerId = layerManager.getActiveLayer();
+
+	std::string layers;
+	std::uint32_t layerCount = 0;
+
+	layerManager.foreachLayer([&](int layerId, const std::string& layerName)
+	{
+		std::uint8_t flags = 0;
+
+		if (layerId == activeLayerId) flags |= LAYER_ACTIVE;
+		if (!layerManager.layerIsVisible(layerId)) flags |= LAYER_HIDDEN;
+
+		writeInt32(layers, layerId);
+		writeUnsigned(layers, getStringIndex(layerName));
+		writeInt32(layers, layerManager.getParentLayer(layerId));
+		writeUnsigned(layers, flags);
+
+		++layerCount;
+	});
+
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_LAYERS));
+	writeUnsigned(_records, layerCount);
+	_records.append(layers);
+
+	// Selection groups, empty ones are skipped
+	std::string groups;
+	std::uint32_t groupCount = 0;
+
+	root->getSelectionGroupManager().foreachSelectionGroup([&](selection::ISelectionGroup& group)
+	{
+		if (group.size() == 0) return;
+
+		writeUnsigned(groups, static_cast<std::uint64_t>(group.getId()));
+		writeUnsigned(groups, getStringIndex(group.getName()));
+
+		++groupCount;
+	});
+
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_SELECTIONGROUPS));
+	writeUnsigned(_records, groupCount);
+	_records.append(groups);
+
+	// Selection sets, the members are looked up when writing the nodes
+	std::string sets;
+	std::uint32_t setCount = 0;
+
+	root->getSelectionSetManager().foreachSelectionSet([&](const selection::ISelectionSetPtr& set)
+	{
+		writeUnsigned(sets, getStringIndex(set->getName()));
+
+		for (const auto& node : set->getNodes())
+		{
+			_selectionSetIndices[node.get()].push_back(setCount);
+		}
+
+		++setCount;
+	});
+
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_SELECTIONSETS));
+	writeUnsigned(_records, setCount);
+	_records.append(sets);
+
+	// Map properties
+	std::string properties;
+	std::uint32_t propertyCount = 0;
+
+	root->foreachProperty([&](const std::string& key, const std::string& value)
+	{
+		writeUnsigned(properties, getStringIndex(key));
+		writeUnsigned(properties, getStringIndex(value));
+
+		++propertyCount;
+	});
+
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_PROPERTIES));
+	writeUnsigned(_records, propertyCount);
+	_records.append(properties);
+}
+
+void BinaryMapWriter::endWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream)
+{
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_END));
+
+	std::string header(SIGNATURE, SIGNATURE_LENGTH);
+	writeUnsigned(header, static_cast<std::uint32_t>(BinaryMapFormat::Version));
+
+	// String table
+	writeUnsigned(header, static_cast<std::uint32_t>(_strings.size()));
+
+	for (auto string : _strings)
+	{
+		writeUnsigned(header, static_cast<std::uint32_t>(string->size()));
+		header.append(*string);
+	}
+
+	stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+	stream.write(_records.data(), static_cast<std::streamsize>(_records.size()));
+}
+
+void BinaryMapWriter::beginWriteEntity(const IEntityNodePtr& entity, std::ostream& stream)
+{
+	std::vector<std::uint32_t> keyValues;
+
+	entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
+	{
+		keyValues.push_back(getStringIndex(key));
+		keyValues.push_back(getStringIndex(value));
+	});
+
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_ENTITY));
+	writeUnsigned(_records, static_cast<std::uint32_t>(keyValues.size() / 2));
+
+	for (auto index : keyValues)
+	{
+		writeUnsigned(_records, index);
+	}
+
+	writeNodeInfo(entity);
+}
+
+void BinaryMapWriter::endWriteEntity(const IEntityNodePtr& entity, std::ostream& stream)
+{
+	// nothing, the primitive records are following the entity record
+}
+
+void BinaryMapWriter::beginWriteBrush(const IBrushNodePtr& brushNode, std::ostream& stream)
+{
+	const auto& brush = brushNode->getIBrush();
+
+	// Faces with degenerate or empty windings are "non-contributing", like in the .map formats
+	std::vector<const IFace*> faces;
+	faces.reserve(brush.getNumFaces());
+
+	for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+	{
+		const auto& face = brush.getFace(i);
+
+		if (face.getWinding().size() > 2)
+		{
+			faces.push_back(&face);
+		}
+	}
+
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_BRUSH));
+	writeUnsigned(_records, static_cast<std::uint8_t>(brush.getDetailFlag()));
+	writeUnsigned(_records, static_cast<std::uint32_t>(faces.size()));
+
+	for (auto face : faces)
+	{
+		const auto& plane = face->getPlane3();
+
+		writeDouble(_records, plane.normal().x());
+		writeDouble(_records, plane.normal().y());
+		writeDouble(_records, plane.normal().z());
+		writeDouble(_records, -plane.dist());
+	}
+
+	for (auto face : faces)
+	{
+		auto texdef = face->getProjectionMatrix();
+
+		writeDouble(_records, texdef.xx());
+		writeDouble(_records, texdef.yx());
+		writeDouble(_records, texdef.zx());
+		writeDouble(_records, texdef.xy());
+		writeDouble(_records, texdef.yy());
+		writeDouble(_records, texdef.zy());
+	}
+
+	for (auto face : faces)
+	{
+		writeUnsigned(_records, getStringIndex(face->getShader()));
+	}
+
+	writeNodeInfo(std::dynamic_pointer_cast<scene::INode>(brushNode));
+}
+
+void BinaryMapWriter::endWriteBrush(const IBrushNodePtr& brush, std::ostream& stream)
+{
+	// nothing
+}
+
+void BinaryMapWriter::beginWritePatch(const IPatchNodePtr& patchNode, std::ostream& stream)
+{
+	const auto& patch = patchNode->getPatch();
+
+	auto subdivisions = patch.subdivisionsFixed() ? patch.getSubdivisions() : Subdivisions(0, 0);
+
+	writeUnsigned(_records, static_cast<std::uint8_t>(RECORD_PATCH));
+	writeUnsigned(_records, static_cast<std::uint8_t>(patch.subdivisionsFixed() ? 1 : 0));
+	writeUnsigned(_records, static_cast<std::uint32_t>(patch.getWidth()));
+	writeUnsigned(_records, static_cast<std::uint32_t>(patch.getHeight()));
+	writeUnsigned(_records, static_cast<std::uint32_t>(subdivisions.x()));
+	writeUnsigned(_records, static_cast<std::uint32_t>(subdivisions.y()));
+	writeUnsigned(_records, getStringIndex(patch.getShader()));
+
+	for (std::size_t c = 0; c < patch.getWidth(); ++c)
+	{
+		for (std::size_t r = 0; r < patch.getHeight(); ++r)
+		{
+			const auto& control = patch.ctrlAt(r, c);
+
+			writeDouble(_records, control.vertex.x());
+			writeDouble(_records, control.vertex.y());
+			writeDouble(_records, control.vertex.z());
+			writeDouble(_records, control.texcoord.x());
+			writeDouble(_records, control.texcoord.y());
+		}
+	}
+
+	writeNodeInfo(std::dynamic_pointer_cast<scene::INode>(patchNode));
+}
+
+void BinaryMapWriter::endWritePatch(const IPatchNodePtr& patch, std::ostream& stream)
+{
+	// nothing
+}
+
+std::uint32_t BinaryMapWriter::getStringIndex(const std::string& value)
+{
+	auto result = _stringIndices.emplace(value, static_cast<std::uint32_t>(_strings.size()));
+
+	if (result.second)
+	{
+		// The keys of an unordered_map don't move when it is growing
+		_strings.push_back(&result.first->first);
+	}
+
+	return result.first->second;
+}
+
+void BinaryMapWriter::writeNodeInfo(const scene::INodePtr& sceneNode)
+{
+	const auto& layers = sceneNode->getLayers();
+
+	writeUnsigned(_records, static_cast<std::uint32_t>(layers.size()));
+
+	for (auto layerId : layers)
+	{
+		writeInt32(_records, layerId);
+	}
+
+	auto selectable = std::dynamic_pointer_cast<IGroupSelectable>(sceneNode);
+
+	if (selectable)
+	{
+		const auto& groupIds = selectable->getGroupIds();
+
+		writeUnsigned(_records, static_cast<std::uint32_t>(groupIds.size()));
+
+		for (auto groupId : groupIds)
+		{
+			writeUnsigned(_records, static_cast<std::uint64_t>(groupId));
+		}
+	}
+	else
+	{
+		writeUnsigned(_records, static_cast<std::uint32_t>(0));
+	}
+
+	auto sets = _selectionSetIndices.find(sceneNode.get());
+
+	if (sets != _selectionSetIndices.end())
+	{
+		writeUnsigned(_records, static_cast<std::uint32_t>(sets->second.size()));
+
+		for (auto index : sets->second)
+		{
+			writeUnsigned(_records, index);
+		}
+	}
+	else
+	{
+		writeUnsigned(_records, static_cast<std::uint32_t>(0));
+	}
+}
+
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "imapformat.h"
+
+namespace map
+{
+
+namespace format
+{
+
+/**
+ * Exporter class writing the map data into the binary map format,
+ * see binary/Constants.h for a description of the file layout.
+ *
+ * The records are collected in memory, since the string table
+ * needs to be written in front of them.
+ */
+class BinaryMapWriter :
+	public IMapWriter
+{
+private:
+	// The records written so far
+	std::string _records;
+
+	// The string table, each string mapped to its index
+	std::unordered_map<std::string, std::uint32_t> _stringIndices;
+	std::vector<const std::string*> _strings;
+
+	// The selection set indices of each node which is member of a set
+	std::unordered_map<const scene::INode*, std::vector<std::uint32_t>> _selectionSetIndices;
+
+public:
+	void beginWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override;
+	void endWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override;
+
+	// Entity export methods
+	void beginWriteEntity(const IEntityNodePtr& entity, std::ostream& stream) override;
+	void endWriteEntity(const IEntityNodePtr& entity, std::ostream& stream) override;
+
+	// Brush export methods
+	void beginWriteBrush(const IBrushNodePtr& brush, std::ostream& stream) override;
+	void endWriteBrush(const IBrushNodePtr& brush, std::ostream& stream) override;
+
+	// Patch export methods
+	void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
+	void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
+
+private:
+	// Returns the string table index of the given string, adding it if necessary
+	std::uint32_t getStringIndex(const std::string& value);
+
+	// Writes the layer, selection group and selection set memberships of the given node
+	void writeNodeInfo(const scene::INodePtr& sceneNode);
+};
+
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * File layout of the binary map format. All numbers are stored little-endian,
+ * floating point values as IEEE 754 doubles, bit-exact to the values in memory.
+ *
+ * Header
+ *   char[8]    signature "DRBINMAP"
+ *   uint32     format version
+ *
+ * String table (keys, values, materials, layer and group names)
+ *   uint32     string count
+ *   per string: uint32 length, followed by the characters (no terminator)
+ *
+ * The rest of the file is a sequence of records, each starting with a uint8 tag.
+ * Strings are referenced by their uint32 index into the string table.
+ *
+ * RECORD_LAYERS           uint32 count, per layer: int32 id, string name, int32 parentId, uint8 flags
+ * RECORD_SELECTIONGROUPS  uint32 count, per group: uint64 id, string name
+ * RECORD_SELECTIONSETS    uint32 count, per set: string name (the set index is its position)
+ * RECORD_PROPERTIES       uint32 count, per property: string key, string value
+ * RECORD_ENTITY           uint32 count, per keyvalue: string key, string value; node info
+ * RECORD_BRUSH            uint8 detail flag, uint32 face count,
+ *                         face count * 4 doubles (plane normal x y z and -dist),
+ *                         face count * 6 doubles (texture matrix xx yx tx xy yy ty),
+ *                         face count * string (material), node info
+ * RECORD_PATCH            uint8 fixed subdivisions, uint32 width, uint32 height,
+ *                         uint32 subdivisions x, uint32 subdivisions y, string material,
+ *                         width * height * 5 doubles (x y z u v) column by column, node info
+ * RECORD_END              end of file
+ *
+ * Brush and patch records belong to the entity record preceding them.
+ *
+ * Node info: uint32 layer count, int32 per layer id,
+ *            uint32 group count, uint64 per selection group id,
+ *            uint32 set count, uint32 per selection set index
+ */
+namespace map
+{
+
+namespace format
+{
+
+namespace binary
+{
+
+constexpr const char SIGNATURE[] = { 'D', 'R', 'B', 'I', 'N', 'M', 'A', 'P' };
+constexpr std::size_t SIGNATURE_LENGTH = sizeof(SIGNATURE);
+
+enum RecordTag : std::uint8_t
+{
+    RECORD_END = 0,
+    RECORD_LAYERS = 1,
+    RECORD_SELECTIONGROUPS = 2,
+    RECORD_SELECTIONSETS = 3,
+    RECORD_PROPERTIES = 4,
+    RECORD_ENTITY = 5,
+    RECORD_BRUSH = 6,
+    RECORD_PATCH = 7,
+};
+
+enum LayerFlags : std::uint8_t
+{
+    LAYER_ACTIVE = 1 << 0,
+    LAYER_HIDDEN = 1 << 1,
+};
+
+constexpr std::size_t PLANE_COMPONENTS = 4;
+constexpr std::size_t TEXTURE_MATRIX_COMPONENTS = 6;
+constexpr std::size_t PATCH_CONTROL_COMPONENTS = 5;
+
+}
+
+}
+
+}
@@ -1,10 +1,6 @@
-// greebo: Specialise the float casting function
-#define SPECIALISE_STR_TO_FLOAT
-
 #include "BrushDef.h"
 
 #include "../Quake3Utils.h"
-#include "string/convert.h"
 #include "imap.h"
 #include "ibrush.h"
 #include "parser/DefTokeniser.h"
@@ -66,25 +62,25 @@ scene::INodePtr BrushDefParser::parse(parser::DefTokeniser& tok) const
 		else if (token == "(") // FACE
 		{
 			// Parse three 3D points to construct a plane
-			double x = string::to_float(tok.nextToken());
-			double y = string::to_float(tok.nextToken());
-			double z = string::to_float(tok.nextToken());
+			double x = tok.nextDouble();
+			double y = tok.nextDouble();
+			double z = tok.nextDouble();
 			Vector3 p1(x, y, z);
 
 			tok.assertNextToken(")");
 			tok.assertNextToken("(");
 
-			x = string::to_float(tok.nextToken());
-			y = string::to_float(tok.nextToken());
-			z = string::to_float(tok.nextToken());
+			x = tok.nextDouble();
+			y = tok.nextDouble();
+			z = tok.nextDouble();
 			Vector3 p2(x, y, z);
 
 			tok.assertNextToken(")");
 			tok.assertNextToken("(");
 
-			x = string::to_float(tok.nextToken());
-			y = string::to_float(tok.nextToken());
-			z = string::to_float(tok.nextToken());
+			x = tok.nextDouble();
+			y = tok.nextDouble();
+			z = tok.nextDouble();
 			Vector3 p3(x, y, z);
 
 			tok.assertNextToken(")");
@@ -97,15 +93,15 @@ scene::INodePtr BrushDefParser::parse(parser::DefTokeniser& tok) const
 			tok.assertNextToken("(");
 
 			tok.assertNextToken("(");
-			texdef.xx() = string::to_float(tok.nextToken());
-			texdef.yx() = string::to_float(tok.nextToken());
-			texdef.zx() = string::to_float(tok.nextToken());
+			texdef.xx() = tok.nextDouble();
+			texdef.yx() = tok.nextDouble();
+			texdef.zx() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken("(");
-			texdef.xy() = string::to_float(tok.nextToken());
-			texdef.yy() = string::to_float(tok.nextToken());
-			texdef.zy() = string::to_float(tok.nextToken());
+			texdef.xy() = tok.nextDouble();
+			texdef.yy() = tok.nextDouble();
+			texdef.zy() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken(")");
@@ -115,7 +111,7 @@ scene::INodePtr BrushDefParser::parse(parser::DefTokeniser& tok) const
 
 			// Parse Flags (usually each brush has all faces detail or all faces structural)
 			IBrush::DetailFlag flag = static_cast<IBrush::DetailFlag>(
-				string::convert<std::size_t>(tok.nextToken(), IBrush::Structural));
+				tok.nextUnsigned(IBrush::Structural));
 			brush.setDetailFlag(flag);
 
 			// Ignore the other two flags
@@ -185,25 +181,25 @@ scene::INodePtr LegacyBrushDefParser::parse(parser::DefTokeniser& tok) const
 		else if (token == "(") // FACE
 		{
 			// Parse three 3D points to construct a plane
-			double x = string::to_float(tok.nextToken());
-			double y = string::to_float(tok.nextToken());
-			double z = string::to_float(tok.nextToken());
+			double x = tok.nextDouble();
+			double y = tok.nextDouble();
+			double z = tok.nextDouble();
 			Vector3 p1(x, y, z);
 
 			tok.assertNextToken(")");
 			tok.assertNextToken("(");
 
-			x = string::to_float(tok.nextToken());
-			y = string::to_float(tok.nextToken());
-			z = string::to_float(tok.nextToken());
+			x = tok.nextDouble();
+			y = tok.nextDouble();
+			z = tok.nextDouble();
 			Vector3 p2(x, y, z);
 
 			tok.assertNextToken(")");
 			tok.assertNextToken("(");
 
-			x = string::to_float(tok.nextToken());
-			y = string::to_float(tok.nextToken());
-			z = string::to_float(tok.nextToken());
+			x = tok.nextDouble();
+			y = tok.nextDouble();
+			z = tok.nextDouble();
 			Vector3 p3(x, y, z);
 
 			tok.assertNextToken(")");
@@ -217,13 +213,13 @@ scene::INodePtr LegacyBrushDefParser::parse(parser::DefTokeniser& tok) const
 			// Parse texdef (shift rotation scale)
             ShiftScaleRotation ssr;
 
-            ssr.shift[0] = string::to_float(tok.nextToken());
-            ssr.shift[1] = string::to_float(tok.nextToken());
+            ssr.shift[0] = tok.nextDouble();
+            ssr.shift[1] = tok.nextDouble();
 
-            ssr.rotate = string::to_float(tok.nextToken());
+            ssr.rotate = tok.nextDouble();
 
-            ssr.scale[0] = string::to_float(tok.nextToken());
-            ssr.scale[1] = string::to_float(tok.nextToken());
+            ssr.scale[0] = tok.nextDouble();
+            ssr.scale[1] = tok.nextDouble();
 
             if (ssr.scale[0] == 0)
             {
@@ -239,7 +235,7 @@ scene::INodePtr LegacyBrushDefParser::parse(parser::DefTokeniser& tok) const
 
 			// Parse Flags (usually each brush has all faces detail or all faces structural)
 			auto flag = static_cast<IBrush::DetailFlag>(
-				string::convert<std::size_t>(tok.nextToken(), IBrush::Structural));
+				tok.nextUnsigned(IBrush::Structural));
 			brush.setDetailFlag(flag);
 
 			// Ignore the other two flags
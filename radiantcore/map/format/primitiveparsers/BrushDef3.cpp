@@ -1,8 +1,4 @@
-// greebo: Specialise the float casting function
-#define SPECIALISE_STR_TO_FLOAT
-
 #include "BrushDef3.h"
-#include "string/convert.h"
 #include "imap.h"
 #include "ibrush.h"
 #include "parser/DefTokeniser.h"
@@ -72,10 +68,10 @@ scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
 			// Construct a plane and parse its values
 			Plane3 plane;
 
-			plane.normal().x() = string::to_float(tok.nextToken());
-			plane.normal().y() = string::to_float(tok.nextToken());
-			plane.normal().z() = string::to_float(tok.nextToken());
-			plane.dist() = -string::to_float(tok.nextToken()); // negate d
+			plane.normal().x() = tok.nextDouble();
+			plane.normal().y() = tok.nextDouble();
+			plane.normal().z() = tok.nextDouble();
+			plane.dist() = -tok.nextDouble(); // negate d
 
 			tok.assertNextToken(")");
 
@@ -84,15 +80,15 @@ scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
 			tok.assertNextToken("(");
 
 			tok.assertNextToken("(");
-			texdef.xx() = string::to_float(tok.nextToken());
-			texdef.yx() = string::to_float(tok.nextToken());
-			texdef.zx() = string::to_float(tok.nextToken());
+			texdef.xx() = tok.nextDouble();
+			texdef.yx() = tok.nextDouble();
+			texdef.zx() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken("(");
-			texdef.xy() = string::to_float(tok.nextToken());
-			texdef.yy() = string::to_float(tok.nextToken());
-			texdef.zy() = string::to_float(tok.nextToken());
+			texdef.xy() = tok.nextDouble();
+			texdef.yy() = tok.nextDouble();
+			texdef.zy() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken(")");
@@ -102,7 +98,7 @@ scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
 
 			// Parse Flags (usually each brush has all faces detail or all faces structural)
 			IBrush::DetailFlag flag = static_cast<IBrush::DetailFlag>(
-				string::convert<std::size_t>(tok.nextToken(), IBrush::Structural));
+				tok.nextUnsigned(IBrush::Structural));
 			brush.setDetailFlag(flag);
 
 			// Ignore the other two flags
@@ -154,10 +150,10 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 			// Construct a plane and parse its values
 			Plane3 plane;
 
-			plane.normal().x() = string::to_float(tok.nextToken());
-			plane.normal().y() = string::to_float(tok.nextToken());
-			plane.normal().z() = string::to_float(tok.nextToken());
-			plane.dist() = -string::to_float(tok.nextToken()); // negate d
+			plane.normal().x() = tok.nextDouble();
+			plane.normal().y() = tok.nextDouble();
+			plane.normal().z() = tok.nextDouble();
+			plane.dist() = -tok.nextDouble(); // negate d
 
 			tok.assertNextToken(")");
 
@@ -166,15 +162,15 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 			tok.assertNextToken("(");
 
 			tok.assertNextToken("(");
-			texdef.xx() = string::to_float(tok.nextToken());
-			texdef.yx() = string::to_float(tok.nextToken());
-			texdef.zx() = string::to_float(tok.nextToken());
+			texdef.xx() = tok.nextDouble();
+			texdef.yx() = tok.nextDouble();
+			texdef.zx() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken("(");
-			texdef.xy() = string::to_float(tok.nextToken());
-			texdef.yy() = string::to_float(tok.nextToken());
-			texdef.zy() = string::to_float(tok.nextToken());
+			texdef.xy() = tok.nextDouble();
+			texdef.yy() = tok.nextDouble();
+			texdef.zy() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken(")");
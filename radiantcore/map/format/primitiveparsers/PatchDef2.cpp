@@ -1,12 +1,8 @@
-// greebo: Specialise the float casting function
-#define SPECIALISE_STR_TO_FLOAT
-
 #include "PatchDef2.h"
 
 #include "imap.h"
 #include "ipatch.h"
 #include "parser/DefTokeniser.h"
-#include "string/convert.h"
 #include "shaderlib.h"
 
 namespace map
@@ -53,8 +49,8 @@ scene::INodePtr PatchDef2Parser::parse(parser::DefTokeniser& tok) const
 	tok.assertNextToken("(");
 
 	// parse matrix dimensions
-	std::size_t cols = string::convert<std::size_t>(tok.nextToken());
-	std::size_t rows = string::convert<std::size_t>(tok.nextToken());
+	std::size_t cols = tok.nextUnsigned();
+	std::size_t rows = tok.nextUnsigned();
 
 	patch.setDims(cols, rows);
 
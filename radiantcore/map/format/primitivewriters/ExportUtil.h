@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ostream>
+#include <sstream>
+#include "ichangetrackednode.h"
 #include "math/FloatTools.h"
 
 namespace map
@@ -27,4 +29,47 @@ inline void writeDoubleSafe(const double d, std::ostream& os)
 	}
 }
 
+/**
+ * Writes the text block of the given node to the stream, producing the same
+ * output as invoking the write function on the stream directly.
+ *
+ * The text is taken from the node's serialisation cache if the node hasn't
+ * changed since it has last been written in the given format, otherwise the
+ * write function is called to format it again. Nodes not tracking their
+ * changes are always written through the write function.
+ */
+template<typename NodePtrType, typename WriteFunc>
+inline void writeCachedNodeText(std::ostream& stream, const NodePtrType& node, const char* format, const WriteFunc& write)
+{
+	auto trackedNode = std::dynamic_pointer_cast<scene::IChangeTrackedNode>(node);
+
+	if (!trackedNode)
+	{
+		write(stream);
+		return;
+	}
+
+	auto& cache = trackedNode->getSerialisationCache();
+	auto changeStamp = trackedNode->getChangeStamp();
+
+	if (cache.changeStamp != changeStamp || cache.precision != stream.precision() || cache.format != format)
+	{
+		// Format the block using the settings of the target stream
+		std::ostringstream buffer;
+		buffer.imbue(stream.getloc());
+		buffer.flags(stream.flags());
+		buffer.precision(stream.precision());
+		buffer.fill(stream.fill());
+
+		write(buffer);
+
+		cache.changeStamp = changeStamp;
+		cache.format = format;
+		cache.precision = stream.precision();
+		cache.text = buffer.str();
+	}
+
+	stream.write(cache.text.data(), static_cast<std::streamsize>(cache.text.size()));
+}
+
 }
@@ -4,6 +4,7 @@
 #include "ipatch.h"
 #include "shaderlib.h"
 #include "irenderable.h"
+#include "ichangetrackednode.h"
 #include "itextstream.h"
 #include "iselectiontest.h"
 
@@ -50,7 +51,8 @@ Patch::Patch(PatchNode& node) :
     _undoStateSaver(nullptr),
     _transformChanged(false),
     _tesselationChanged(true),
-    _shader(texdef_name_default())
+    _shader(texdef_name_default()),
+    _changeStamp(scene::getNextChangeStamp())
 {
     construct();
 }
@@ -65,7 +67,8 @@ Patch::Patch(const Patch& other, PatchNode& node) :
     _undoStateSaver(nullptr),
     _transformChanged(false),
     _tesselationChanged(true),
-    _shader(other._shader.getMaterialName())
+    _shader(other._shader.getMaterialName()),
+    _changeStamp(scene::getNextChangeStamp())
 {
     // Initalise the default values
     construct();
@@ -128,7 +131,7 @@ void Patch::setDims(std::size_t w, std::size_t h)
     w = MIN_PATCH_WIDTH;
 
   if((h%2)==0)
-    _height -= 1;
+    h -= 1;
   ASSERT_MESSAGE(h <= MAX_PATCH_HEIGHT, "patch too tall");
   if(h > MAX_PATCH_HEIGHT)
     h = MAX_PATCH_HEIGHT;
@@ -137,6 +140,7 @@ void Patch::setDims(std::size_t w, std::size_t h)
 
     _width = w;
     _height = h;
+    _changeStamp = scene::getNextChangeStamp();
 
     if(_width * _height != _ctrl.size())
     {
@@ -261,6 +265,7 @@ void Patch::freezeTransform()
 
     // Save the transformed working set array over _ctrl
     _ctrl = _ctrlTransformed;
+    _changeStamp = scene::getNextChangeStamp();
 
     // Don't call controlPointsChanged() here since that one will re-apply the
     // current transformation matrix, possible the second time.
@@ -276,6 +281,8 @@ void Patch::freezeTransform()
 // callback for changed control points
 void Patch::controlPointsChanged()
 {
+    _changeStamp = scene::getNextChangeStamp();
+
     transformChanged();
     evaluateTransform();
     updateTesselation();
@@ -2504,7 +2511,11 @@ void Patch::setFixedSubdivisions(bool isFixed, const Subdivisions& divisions)
 		_subDivisions.y() = 4;
 	}
 
-    SceneChangeNotify();
+    if (_node.inScene())
+    {
+        SceneChangeNotify();
+    }
+
     textureChanged();
     controlPointsChanged();
 }
@@ -2561,6 +2572,8 @@ bool Patch::getIntersection(const Ray& ray, Vector3& intersection)
 
 void Patch::textureChanged()
 {
+    _changeStamp = scene::getNextChangeStamp();
+
     _node.onMaterialChanged();
 
     for (auto i = _observers.begin(); i != _observers.end();)
@@ -2568,7 +2581,16 @@ void Patch::textureChanged()
         (*i++)->onPatchTextureChanged();
     }
 
-    signal_patchTextureChanged().emit();
+    // Patches outside the scene (e.g. constructed by the map loader threads) don't need to notify anyone
+    if (_node.inScene())
+    {
+        signal_patchTextureChanged().emit();
+    }
+}
+
+std::size_t Patch::getChangeStamp() const
+{
+    return _changeStamp;
 }
 
 void Patch::attachObserver(Observer* observer)
@@ -70,6 +70,9 @@ class Patch :
 	// Fixed subdivision layout of this patch
 	Subdivisions _subDivisions;
 
+	// Renewed whenever the control points, dimensions, subdivisions or the material change
+	std::size_t _changeStamp;
+
 	// greebo: Initialises the patch member variables
 	void construct();
 
@@ -116,6 +119,9 @@ public:
 	// callback for changed control points
 	void controlPointsChanged() override;
 
+	// Returns the change stamp of this patch, see scene::IChangeTrackedNode
+	std::size_t getChangeStamp() const;
+
 	// Check if the patch has invalid control points or width/height are zero
 	bool isValid() const override;
 
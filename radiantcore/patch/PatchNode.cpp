@@ -47,6 +47,19 @@ scene::INode::Type PatchNode::getNodeType() const
 }
 
 std::string PatchNode::getFingerprint()
+{
+    auto changeStamp = m_patch.getChangeStamp();
+
+    if (_fingerprintCache.changeStamp != changeStamp)
+    {
+        _fingerprintCache.fingerprint = calculateFingerprint();
+        _fingerprintCache.changeStamp = changeStamp;
+    }
+
+    return _fingerprintCache.fingerprint;
+}
+
+std::string PatchNode::calculateFingerprint()
 {
     constexpr std::size_t SignificantDigits = scene::SignificantFingerprintDoubleDigits;
 
@@ -82,6 +95,16 @@ std::string PatchNode::getFingerprint()
     return hash;
 }
 
+std::size_t PatchNode::getChangeStamp() const
+{
+    return m_patch.getChangeStamp();
+}
+
+scene::SerialisationCache& PatchNode::getSerialisationCache()
+{
+    return _serialisationCache;
+}
+
 void PatchNode::updateSelectableControls()
 {
 	// Clear the control instance vector and reserve <size> memory
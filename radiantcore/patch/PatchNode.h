@@ -2,6 +2,7 @@
 
 #include "irenderable.h"
 #include "icomparablenode.h"
+#include "ichangetrackednode.h"
 #include "iscenegraph.h"
 #include "itraceable.h"
 #include "imap.h"
@@ -24,7 +25,8 @@ class PatchNode final :
 	public PlaneSelectable,
 	public Transformable,
 	public ITraceable,
-    public scene::IComparableNode
+    public scene::IComparableNode,
+    public scene::IChangeTrackedNode
 {
 	selection::DragPlanes m_dragPlanes;
 
@@ -51,6 +53,12 @@ class PatchNode final :
     RenderablePatchLattice _renderableCtrlLattice; // Wireframe connecting the control points
     RenderablePatchControlPoints _renderableCtrlPoints; // the coloured control points
 
+    // The text of the last map export, not copied along with the patch
+    scene::SerialisationCache _serialisationCache;
+
+    // Fingerprint of the patch, recalculated after the patch has changed
+    scene::FingerprintCache _fingerprintCache;
+
 public:
 	PatchNode(patch::PatchDefType type);
 
@@ -63,6 +71,10 @@ public:
     // IComparableNode implementation
     std::string getFingerprint() override;
 
+    // IChangeTrackedNode implementation
+    std::size_t getChangeStamp() const override;
+    scene::SerialisationCache& getSerialisationCache() override;
+
 	// Bounded implementation
 	const AABB& localAABB() const override;
 
@@ -157,6 +169,8 @@ private:
 	void transformComponents(const Matrix4& matrix);
 
     void updateAllRenderables();
+
+    std::string calculateFingerprint();
     void hideAllRenderables();
     void clearAllRenderables();
 };
@@ -36,4 +36,9 @@ public:
 		m_subdivisions_y(subdivisions_y),
         _materialName(materialName)
     {}
+
+    std::size_t getMemoryUsage() const override
+    {
+        return sizeof(SavedState) + m_ctrl.capacity() * sizeof(PatchControl) + _materialName.capacity();
+    }
 };
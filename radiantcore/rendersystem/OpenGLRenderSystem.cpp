@@ -23,6 +23,12 @@
 namespace render
 {
 
+namespace
+{
+    // Time spent per frame on uploading textures which have been loaded in the background
+    constexpr std::size_t TEXTURE_UPLOAD_BUDGET_MSEC = 4;
+}
+
 /**
  * Main constructor.
  */
@@ -187,6 +193,9 @@ void OpenGLRenderSystem::startFrame()
 {
     // Prepare the storage objects
     _geometryStore.onFrameStart();
+
+    // Swap in the textures which have been loaded in the meantime
+    GlobalMaterialManager().uploadStreamedTextures(TEXTURE_UPLOAD_BUDGET_MSEC);
 }
 
 void OpenGLRenderSystem::endFrame()
@@ -0,0 +1,355 @@
+#include "FlatOctree.h"
+
+#include "inode.h"
+#include "OctreeNode.h"
+
+namespace scene
+{
+
+namespace
+{
+    const float START_SIZE = 512.0f;
+    const float MAX_WORLD_COORD = 65536;
+
+    const AABB START_AABB(Vector3(0, 0, 0), Vector3(START_SIZE, START_SIZE, START_SIZE));
+}
+
+FlatOctree::FlatOctree()
+{
+    _cells.push_back(Cell{ START_AABB, InvalidCell, InvalidCell, ISPNode::MemberList() });
+    _views.emplace_back(std::make_shared<FlatOctreeNode>(*this, RootCell));
+}
+
+void FlatOctree::link(const INodePtr& sceneNode)
+{
+    // Make sure we don't do double-links
+    assert(_nodeMapping.find(sceneNode.get()) == nullptr);
+
+    // Make sure the root cell is large enough
+    ensureRootSize(sceneNode);
+
+    linkRecursively(RootCell, sceneNode);
+}
+
+bool FlatOctree::unlink(const INodePtr& sceneNode)
+{
+    auto location = _nodeMapping.find(sceneNode.get());
+
+    if (location == nullptr)
+    {
+        return false;
+    }
+
+    removeMember(*location);
+    return true;
+}
+
+ISPNodePtr FlatOctree::getRoot() const
+{
+    return _views[RootCell];
+}
+
+std::size_t FlatOctree::getNumCells() const
+{
+    return _cells.size();
+}
+
+void FlatOctree::ensureRootSize(const INodePtr& sceneNode)
+{
+    const AABB& aabb = sceneNode->worldAABB();
+
+    if (!aabb.isValid()) return; // skip this for invalid bounds
+
+    while (!_cells[RootCell].bounds.contains(aabb))
+    {
+        AABB newBounds = _cells[RootCell].bounds;
+        newBounds.extents *= 2;
+
+        // Don't go beyond the map limits
+        if (newBounds.extents.x() > MAX_WORLD_COORD)
+        {
+            break;
+        }
+
+        // The root stays at index 0, take the old root's children out and
+        // re-initialise the cell with the larger bounds. The members stay
+        // where they are, the mapping table doesn't need to be touched.
+        auto oldChildren = _cells[RootCell].firstChild;
+
+        _cells[RootCell].bounds = newBounds;
+        _cells[RootCell].firstChild = InvalidCell;
+
+        subdivide(RootCell);
+
+        if (oldChildren == InvalidCell)
+        {
+            continue;
+        }
+
+        // Each octant of the old root ends up as grandchild of the new root
+        for (CellIndex i = 0; i < 8; ++i)
+        {
+            auto newChild = _cells[RootCell].firstChild + i;
+            subdivide(newChild);
+
+            for (CellIndex j = 0; j < 8; ++j)
+            {
+                auto newGrandChild = _cells[newChild].firstChild + j;
+
+                for (CellIndex old = 0; old < 8; ++old)
+                {
+                    if (_cells[newGrandChild].bounds == _cells[oldChildren + old].bounds)
+                    {
+                        relocateMembers(oldChildren + old, newGrandChild);
+                        relocateChildren(oldChildren + old, newGrandChild);
+                        break;
+                    }
+                }
+            }
+        }
+
+        releaseBlock(oldChildren);
+    }
+}
+
+void FlatOctree::linkRecursively(CellIndex cellIndex, const INodePtr& sceneNode)
+{
+    const AABB& bounds = sceneNode->worldAABB();
+
+    // If the AABB is not valid, just link it here
+    if (!bounds.isValid())
+    {
+        addMember(cellIndex, sceneNode);
+        return;
+    }
+
+    // Descend into the smallest child cell fully containing the bounds
+    for (bool descended = true; descended; )
+    {
+        descended = false;
+
+        auto firstChild = _cells[cellIndex].firstChild;
+
+        if (firstChild == InvalidCell) break;
+
+        for (CellIndex i = firstChild; i < firstChild + 8; ++i)
+        {
+            if (_cells[i].bounds.contains(bounds))
+            {
+                cellIndex = i;
+                descended = true;
+                break;
+            }
+        }
+    }
+
+    addMember(cellIndex, sceneNode);
+
+    // If this is a leaf, check if we exceeded the subdivision threshold and are large enough
+    if (_cells[cellIndex].firstChild == InvalidCell &&
+        _cells[cellIndex].members.size() >= SUBDIVISION_THRESHOLD &&
+        _cells[cellIndex].bounds.extents.x() > MIN_NODE_EXTENTS)
+    {
+        subdivide(cellIndex);
+
+        // Evaluate all member bounds before re-distributing them, this might
+        // trigger nested nodeBoundsChanged() calls re-linking members already.
+        // No references into the arena are held across these calls.
+        {
+            ISPNode::MemberList temp = _cells[cellIndex].members;
+
+            for (const auto& member : temp)
+            {
+                member->worldAABB();
+            }
+        }
+
+        ISPNode::MemberList oldList;
+        oldList.swap(_cells[cellIndex].members);
+
+        for (const auto& member : oldList)
+        {
+            _nodeMapping.erase(member.get());
+        }
+
+        // The cell has children now, so this won't subdivide it again
+        for (const auto& member : oldList)
+        {
+            linkRecursively(cellIndex, member);
+        }
+    }
+}
+
+void FlatOctree::addMember(CellIndex cellIndex, const INodePtr& sceneNode)
+{
+    auto& members = _cells[cellIndex].members;
+
+    auto inserted = _nodeMapping.insert(sceneNode.get(),
+        MemberLocation{ cellIndex, static_cast<std::uint32_t>(members.size()) });
+
+    assert(inserted);
+
+    members.push_back(sceneNode);
+}
+
+void FlatOctree::removeMember(const MemberLocation& location)
+{
+    // Copy the location, the reference points into the mapping table
+    auto cellIndex = location.cell;
+    auto slot = location.slot;
+
+    auto& members = _cells[cellIndex].members;
+    assert(slot < members.size());
+
+    _nodeMapping.erase(members[slot].get());
+
+    // Move the last member into the gap and update its slot
+    if (slot + 1 < members.size())
+    {
+        members[slot] = std::move(members.back());
+        _nodeMapping.find(members[slot].get())->slot = slot;
+    }
+
+    members.pop_back();
+}
+
+void FlatOctree::subdivide(CellIndex cellIndex)
+{
+    assert(_cells[cellIndex].firstChild == InvalidCell);
+
+    // Allocation might re-locate the arena, copy the bounds
+    auto firstChild = allocateBlock();
+    AABB bounds = _cells[cellIndex].bounds;
+
+    // Each child node has half the extents of this node
+    Vector3 childExtents = bounds.extents * 0.5;
+
+    // Construct delta-vectors, pointing in each room direction
+    Vector3 x(childExtents.x(), 0, 0);
+    Vector3 y(0, childExtents.y(), 0);
+    Vector3 z(0, 0, childExtents.z());
+
+    Vector3 baseUpper = bounds.origin + z;
+    Vector3 baseLower = bounds.origin - z;
+
+    // Use the same octant order as the OctreeNode
+    const Vector3 origins[8] =
+    {
+        baseUpper + x + y, baseUpper + x - y, baseUpper - x - y, baseUpper - x + y,
+        baseLower + x + y, baseLower + x - y, baseLower - x - y, baseLower - x + y,
+    };
+
+    for (CellIndex i = 0; i < 8; ++i)
+    {
+        auto& child = _cells[firstChild + i];
+
+        child.bounds = AABB(origins[i], childExtents);
+        child.parent = cellIndex;
+        child.firstChild = InvalidCell;
+        assert(child.members.empty());
+
+        updateViewChildren(firstChild + i);
+    }
+
+    _cells[cellIndex].firstChild = firstChild;
+    updateViewChildren(cellIndex);
+}
+
+FlatOctree::CellIndex FlatOctree::allocateBlock()
+{
+    if (!_freeBlocks.empty())
+    {
+        auto firstCell = _freeBlocks.back();
+        _freeBlocks.pop_back();
+
+        return firstCell;
+    }
+
+    auto firstCell = static_cast<CellIndex>(_cells.size());
+
+    _cells.resize(_cells.size() + 8, Cell{ AABB(), InvalidCell, InvalidCell, ISPNode::MemberList() });
+
+    for (CellIndex i = firstCell; i < firstCell + 8; ++i)
+    {
+        _views.emplace_back(std::make_shared<FlatOctreeNode>(*this, i));
+    }
+
+    return firstCell;
+}
+
+void FlatOctree::releaseBlock(CellIndex firstCell)
+{
+    for (CellIndex i = firstCell; i < firstCell + 8; ++i)
+    {
+        auto& cell = _cells[i];
+
+        assert(cell.members.empty());
+        assert(cell.firstChild == InvalidCell);
+
+        cell.parent = InvalidCell;
+        _views[i]->_children.clear();
+    }
+
+    _freeBlocks.push_back(firstCell);
+}
+
+void FlatOctree::relocateMembers(CellIndex source, CellIndex target)
+{
+    auto& sourceMembers = _cells[source].members;
+    auto& targetMembers = _cells[target].members;
+
+    for (auto& member : sourceMembers)
+    {
+        auto location = _nodeMapping.find(member.get());
+        assert(location != nullptr);
+
+        location->cell = target;
+        location->slot = static_cast<std::uint32_t>(targetMembers.size());
+
+        targetMembers.emplace_back(std::move(member));
+    }
+
+    sourceMembers.clear();
+}
+
+void FlatOctree::relocateChildren(CellIndex source, CellIndex target)
+{
+    auto firstChild = _cells[source].firstChild;
+
+    if (firstChild == InvalidCell) return;
+
+    assert(_cells[target].firstChild == InvalidCell);
+
+    _cells[target].firstChild = firstChild;
+    _cells[source].firstChild = InvalidCell;
+
+    for (CellIndex i = firstChild; i < firstChild + 8; ++i)
+    {
+        _cells[i].parent = target;
+    }
+
+    updateViewChildren(source);
+    updateViewChildren(target);
+}
+
+void FlatOctree::updateViewChildren(CellIndex cellIndex)
+{
+    auto& children = _views[cellIndex]->_children;
+    children.clear();
+
+    auto firstChild = _cells[cellIndex].firstChild;
+
+    if (firstChild == InvalidCell) return;
+
+    for (CellIndex i = firstChild; i < firstChild + 8; ++i)
+    {
+        children.push_back(_views[i]);
+    }
+}
+
+const FlatOctreeNodePtr& FlatOctree::getView(CellIndex cellIndex) const
+{
+    return _views[cellIndex];
+}
+
+} // namespace scene
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "ispacepartition.h"
+#include "math/AABB.h"
+#include "NodeLookupTable.h"
+
+namespace scene
+{
+
+class FlatOctreeNode;
+typedef std::shared_ptr<FlatOctreeNode> FlatOctreeNodePtr;
+
+/**
+ * An alternative Octree implementation with the same subdivision rules
+ * as the scene::Octree, but a different memory layout.
+ *
+ * All cells are stored in a contiguous arena and reference each other by
+ * index. The 8 children of a cell are always allocated as one block of
+ * consecutive cells, such that a cell only needs to know its first child.
+ * Blocks that are no longer in use are recycled through a free list.
+ *
+ * The lookup table for unlink() is an open-addressing hash table mapping
+ * the scene node to its cell and its slot in the cell's member list,
+ * which makes unlink() (and therefore re-linking a node after a bounds
+ * change) a constant-time operation.
+ *
+ * The ISPNode interface is served by lightweight FlatOctreeNode views,
+ * which are allocated once per arena cell and refer to it by index.
+ */
+class FlatOctree final :
+    public ISpacePartitionSystem
+{
+public:
+    typedef std::uint32_t CellIndex;
+    static constexpr CellIndex InvalidCell = std::numeric_limits<CellIndex>::max();
+
+private:
+    struct Cell
+    {
+        AABB bounds;
+        CellIndex parent;
+
+        // Index of the first of 8 consecutive child cells, InvalidCell for leaves
+        CellIndex firstChild;
+
+        ISPNode::MemberList members;
+    };
+
+    std::vector<Cell> _cells;
+
+    // One view per cell, created along with the cell
+    std::vector<FlatOctreeNodePtr> _views;
+
+    // The first cell indices of released 8-blocks
+    std::vector<CellIndex> _freeBlocks;
+
+    // The root always resides at index 0
+    static constexpr CellIndex RootCell = 0;
+
+    // Location of a linked scene node
+    struct MemberLocation
+    {
+        CellIndex cell;
+        std::uint32_t slot;
+    };
+    NodeLookupTable<MemberLocation> _nodeMapping;
+
+public:
+    FlatOctree();
+
+    void link(const INodePtr& sceneNode) override;
+    bool unlink(const INodePtr& sceneNode) override;
+    ISPNodePtr getRoot() const override;
+
+    // The number of arena cells in use (including recycled ones)
+    std::size_t getNumCells() const;
+
+private:
+    friend class FlatOctreeNode;
+
+    void ensureRootSize(const INodePtr& sceneNode);
+
+    void linkRecursively(CellIndex cellIndex, const INodePtr& sceneNode);
+
+    void addMember(CellIndex cellIndex, const INodePtr& sceneNode);
+    void removeMember(const MemberLocation& location);
+
+    // Allocates 8 child cells for the given leaf cell
+    void subdivide(CellIndex cellIndex);
+
+    CellIndex allocateBlock();
+    void releaseBlock(CellIndex firstCell);
+
+    void relocateMembers(CellIndex source, CellIndex target);
+    void relocateChildren(CellIndex source, CellIndex target);
+
+    // Refreshes the child list of the cell's view
+    void updateViewChildren(CellIndex cellIndex);
+
+    const FlatOctreeNodePtr& getView(CellIndex cellIndex) const;
+};
+
+/**
+ * ISPNode adapter exposing a single FlatOctree cell to clients
+ * traversing the space partition through the generic interface.
+ */
+class FlatOctreeNode final :
+    public ISPNode
+{
+private:
+    const FlatOctree& _owner;
+    FlatOctree::CellIndex _index;
+
+    NodeList _children;
+
+public:
+    FlatOctreeNode(const FlatOctree& owner, FlatOctree::CellIndex index) :
+        _owner(owner),
+        _index(index)
+    {}
+
+    ISPNodePtr getParent() const override
+    {
+        auto parent = _owner._cells[_index].parent;
+        return parent != FlatOctree::InvalidCell ? _owner.getView(parent) : ISPNodePtr();
+    }
+
+    const AABB& getBounds() const override
+    {
+        return _owner._cells[_index].bounds;
+    }
+
+    const NodeList& getChildNodes() const override
+    {
+        return _children;
+    }
+
+    bool isLeaf() const override
+    {
+        return _owner._cells[_index].firstChild == FlatOctree::InvalidCell;
+    }
+
+    const MemberList& getMembers() const override
+    {
+        return _owner._cells[_index].members;
+    }
+
+private:
+    friend class FlatOctree;
+};
+
+} // namespace scene
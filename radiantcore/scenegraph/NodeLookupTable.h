@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "inode.h"
+
+namespace scene
+{
+
+/**
+ * Open-addressing hash table mapping scene::INode pointers to a small
+ * value type. It is used by the FlatOctree to find the cell and member
+ * slot of a linked scene node without touching the heap for every entry.
+ *
+ * Collisions are resolved by linear probing, erasure uses backward-shift
+ * deletion, so there are no tombstones and lookup chains stay short
+ * even after heavy link/unlink churn.
+ *
+ * The table does not own the nodes, the keys are used for identity only.
+ */
+template<typename ValueType>
+class NodeLookupTable
+{
+private:
+    struct Entry
+    {
+        const INode* key = nullptr;
+        ValueType value;
+    };
+
+    std::vector<Entry> _entries;
+    std::size_t _size;
+
+    // Capacity is always a power of two, this is capacity - 1
+    std::size_t _mask;
+
+    static constexpr std::size_t InitialCapacity = 64;
+
+public:
+    NodeLookupTable() :
+        _entries(InitialCapacity),
+        _size(0),
+        _mask(InitialCapacity - 1)
+    {}
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    void clear()
+    {
+        _entries.assign(InitialCapacity, Entry());
+        _mask = InitialCapacity - 1;
+        _size = 0;
+    }
+
+    // Returns the value associated to the given node, or nullptr if not present
+    ValueType* find(const INode* key)
+    {
+        for (auto index = getBucket(key); ; index = (index + 1) & _mask)
+        {
+            auto& entry = _entries[index];
+
+            if (entry.key == key) return &entry.value;
+            if (entry.key == nullptr) return nullptr;
+        }
+    }
+
+    // Inserts the given key/value pair, returns false if the key is already present
+    bool insert(const INode* key, const ValueType& value)
+    {
+        // Keep the load factor below 0.5
+        if ((_size + 1) * 2 > _entries.size())
+        {
+            rehash(_entries.size() * 2);
+        }
+
+        for (auto index = getBucket(key); ; index = (index + 1) & _mask)
+        {
+            auto& entry = _entries[index];
+
+            if (entry.key == key) return false;
+
+            if (entry.key == nullptr)
+            {
+                entry.key = key;
+                entry.value = value;
+                ++_size;
+                return true;
+            }
+        }
+    }
+
+    // Removes the given key, returns true if the key has been present
+    bool erase(const INode* key)
+    {
+        auto index = getBucket(key);
+
+        while (_entries[index].key != key)
+        {
+            if (_entries[index].key == nullptr) return false;
+
+            index = (index + 1) & _mask;
+        }
+
+        // Backward-shift deletion: move any displaced entries following
+        // the erased one into the gap, such that no probe chain is broken
+        auto gap = index;
+
+        for (auto next = (gap + 1) & _mask; _entries[next].key != nullptr; next = (next + 1) & _mask)
+        {
+            auto home = getBucket(_entries[next].key);
+
+            // Only move the entry if its home bucket is not within (gap, next]
+            if (((next - home) & _mask) >= ((next - gap) & _mask))
+            {
+                _entries[gap] = _entries[next];
+                gap = next;
+            }
+        }
+
+        _entries[gap] = Entry();
+        --_size;
+
+        return true;
+    }
+
+private:
+    std::size_t getBucket(const INode* key) const
+    {
+        // Fibonacci hashing of the pointer value, the lower bits are always zero due to alignment
+        auto hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key) >> 4);
+        return static_cast<std::size_t>((hash * 11400714819323198485ull) >> 32) & _mask;
+    }
+
+    void rehash(std::size_t newCapacity)
+    {
+        std::vector<Entry> oldEntries(newCapacity);
+        oldEntries.swap(_entries);
+
+        _mask = newCapacity - 1;
+
+        for (const auto& entry : oldEntries)
+        {
+            if (entry.key == nullptr) continue;
+
+            auto index = getBucket(entry.key);
+
+            while (_entries[index].key != nullptr)
+            {
+                index = (index + 1) & _mask;
+            }
+
+            _entries[index] = entry;
+        }
+    }
+};
+
+}
@@ -2,15 +2,19 @@
 
 #include "ivolumetest.h"
 #include "itextstream.h"
+#include "iregistry.h"
 
 #include "scene/InstanceWalkers.h"
 #include "debugging/debugging.h"
 
 #include "math/AABB.h"
 #include "Octree.h"
+#include "FlatOctree.h"
 #include "SceneGraphFactory.h"
 #include "util/ScopedBoolLock.h"
+#include "util/ParallelFor.h"
 #include "module/StaticModule.h"
+#include "registry/registry.h"
 
 namespace scene
 {
@@ -87,8 +91,10 @@ void SceneGraph::setRoot(const IMapRootNodePtr& newRoot)
 
 	_root = newRoot;
 
-	// Refresh the space partition class
-	_spacePartition = std::make_shared<Octree>();
+	// Refresh the space partition class, pending relinks are obsolete
+	_pendingRelinks.clear();
+	_pendingRelinkIndex.clear();
+	_spacePartition = createSpacePartition();
 
 	if (_root)
 	{
@@ -103,9 +109,25 @@ void SceneGraph::setRoot(const IMapRootNodePtr& newRoot)
 	}
 }
 
+ISpacePartitionSystemPtr SceneGraph::createSpacePartition()
+{
+    if (module::GlobalModuleRegistry().moduleExists(MODULE_XMLREGISTRY) &&
+        registry::getValue<std::string>(RKEY_SPACE_PARTITION_TYPE) == "flatOctree")
+    {
+        return std::make_shared<FlatOctree>();
+    }
+
+    return std::make_shared<Octree>();
+}
+
 void SceneGraph::onUndoEvent(IUndoSystem::EventType type, const std::string& operationName)
 {
-    if (type == IUndoSystem::EventType::OperationUndone)
+    if (type == IUndoSystem::EventType::OperationRecorded)
+    {
+        // The command is finished, bring the space partition up to date
+        flushPendingRelinks();
+    }
+    else if (type == IUndoSystem::EventType::OperationUndone)
     {
         // Trigger the onPostUndo event on all scene nodes
         foreachNode([&](const INodePtr& node)->bool
@@ -173,6 +195,13 @@ void SceneGraph::erase(const INodePtr& node)
 
 	_spacePartition->unlink(node);
 
+	// No need to re-link this node anymore
+	if (auto pending = _pendingRelinkIndex.find(node.get()); pending != nullptr)
+	{
+		_pendingRelinks[*pending].reset();
+		_pendingRelinkIndex.erase(node.get());
+	}
+
 	// Fire the onRemove event on the Node
     assert(_root);
     node->onRemoveFromScene(*_root);
@@ -194,10 +223,33 @@ void SceneGraph::nodeBoundsChanged(const INodePtr& node)
         return;
     }
 
-	if (_spacePartition->unlink(node))
+	// Queue the node for re-linking, a node changing its bounds several
+	// times before the next flush will only be re-linked once
+	if (_pendingRelinkIndex.insert(node.get(), _pendingRelinks.size()))
 	{
-		// unlink returned true, so the given node was linked before => re-link it
-		_spacePartition->link(node);
+		_pendingRelinks.push_back(node);
+	}
+}
+
+void SceneGraph::flushPendingRelinks()
+{
+	// Re-linking might trigger bounds evaluations queueing more nodes,
+	// keep going until the queue is empty
+	while (!_pendingRelinks.empty())
+	{
+		std::vector<INodePtr> relinks;
+		relinks.swap(_pendingRelinks);
+		_pendingRelinkIndex.clear();
+
+		for (const auto& node : relinks)
+		{
+			// Erased nodes leave an empty slot behind
+			if (node && _spacePartition->unlink(node))
+			{
+				// unlink returned true, so the given node was linked before => re-link it
+				_spacePartition->link(node);
+			}
+		}
 	}
 }
 
@@ -248,6 +300,9 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
     // changes during traversal so let's call this now. If nothing got changed, this call is very cheap.
     if (_root != nullptr) _root->worldAABB();
 
+    // Process any bounds changes that happened since the last traversal
+    flushPendingRelinks();
+
     {
         // Buffer any calls that might happen in between
         util::ScopedBoolLock traversal(_traversalOngoing);
@@ -330,8 +385,117 @@ bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& vo
 	return true; // continue traversal
 }
 
+void SceneGraph::foreachNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker)
+{
+    foreachNodeInVolumeParallel(volume, walker, true); // visit hidden
+}
+
+void SceneGraph::foreachVisibleNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker)
+{
+    foreachNodeInVolumeParallel(volume, walker, false); // don't visit hidden
+}
+
+namespace
+{
+    // The maximum number of nodes in a chunk, also the size of a unit of work
+    constexpr std::size_t MaxChunkSize = 512;
+
+    // A slice of an octree cell's member list
+    struct MemberRange
+    {
+        const ISPNode::MemberList* members;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    void collectMemberRanges_r(const ISPNode& node, const VolumeTest& volume, std::vector<MemberRange>& ranges)
+    {
+        const auto& members = node.getMembers();
+
+        for (std::size_t begin = 0; begin < members.size(); begin += MaxChunkSize)
+        {
+            ranges.push_back(MemberRange{ &members, begin, std::min(begin + MaxChunkSize, members.size()) });
+        }
+
+        for (const auto& child : node.getChildNodes())
+        {
+            if (volume.TestAABB(child->getBounds()) != VOLUME_OUTSIDE)
+            {
+                collectMemberRanges_r(*child, volume, ranges);
+            }
+        }
+    }
+}
+
+void SceneGraph::foreachNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker, bool visitHidden)
+{
+    // Evaluate all bounds and process any pending relinks before going wide,
+    // after this point the worldAABB() calls below are not modifying anything
+    if (_root != nullptr) _root->worldAABB();
+
+    flushPendingRelinks();
+
+    {
+        util::ScopedBoolLock traversal(_traversalOngoing);
+
+        // Culling the octree cells is cheap, do it on this thread
+        std::vector<MemberRange> ranges;
+        collectMemberRanges_r(*_spacePartition->getRoot(), volume, ranges);
+
+        auto processRanges = [&](std::size_t first, std::size_t last)
+        {
+            std::vector<INodePtr> chunk;
+            chunk.reserve(MaxChunkSize);
+
+            for (auto r = first; r < last; ++r)
+            {
+                const auto& range = ranges[r];
+
+                for (auto m = range.begin; m < range.end; ++m)
+                {
+                    const auto& member = (*range.members)[m];
+
+                    if (!visitHidden && !member->visible()) continue;
+
+                    const auto& bounds = member->worldAABB();
+
+                    if (bounds.isValid() && volume.TestAABB(bounds) == VOLUME_OUTSIDE) continue;
+
+                    chunk.push_back(member);
+
+                    if (chunk.size() == MaxChunkSize)
+                    {
+                        walker.visitChunk(chunk);
+                        chunk.clear();
+                    }
+                }
+            }
+
+            if (!chunk.empty())
+            {
+                walker.visitChunk(chunk);
+            }
+        };
+
+        if (walker.isThreadSafe())
+        {
+            util::parallelForRange(ranges.size(), processRanges);
+        }
+        else
+        {
+            processRanges(0, ranges.size());
+        }
+    }
+
+    // Traversal finished, flush the action buffer
+    flushActionBuffer();
+}
+
 ISpacePartitionSystemPtr SceneGraph::getSpacePartition()
 {
+	// Clients expect to see the nodes in their current location
+	flushPendingRelinks();
+
 	return _spacePartition;
 }
 
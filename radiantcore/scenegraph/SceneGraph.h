@@ -2,6 +2,7 @@
 
 #include <map>
 #include <list>
+#include <vector>
 #include <sigc++/signal.h>
 #include <sigc++/connection.h>
 
@@ -11,6 +12,8 @@
 #include "imap.h"
 #include "iundo.h"
 
+#include "NodeLookupTable.h"
+
 namespace scene
 {
 
@@ -51,6 +54,12 @@ private:
     typedef std::list<NodeAction> BufferedActions;
     BufferedActions _actionBuffer;
 
+    // Nodes with changed bounds waiting to be re-linked in the space partition.
+    // The lookup table maps each queued node to its index in the queue, such
+    // that repeated bounds changes of the same node are only queued once.
+    std::vector<scene::INodePtr> _pendingRelinks;
+    NodeLookupTable<std::size_t> _pendingRelinkIndex;
+
     bool _traversalOngoing;
 
     sigc::connection _undoEventHandler;
@@ -95,6 +104,10 @@ public:
     void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
     void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
 
+	// Parallel variants
+    void foreachNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker) override;
+    void foreachVisibleNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker) override;
+
     ISpacePartitionSystemPtr getSpacePartition() override;
 private:
 	void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden);
@@ -103,8 +116,16 @@ private:
 	bool foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, 
 							   const INode::VisitorFunc& functor, bool visitHidden);
 
+	void foreachNodeInVolumeParallel(const VolumeTest& volume, ChunkWalker& walker, bool visitHidden);
+
     void flushActionBuffer();
 
+    // Re-links all nodes queued by nodeBoundsChanged() in one go
+    void flushPendingRelinks();
+
+    // Instantiates the space partition type selected in the registry
+    ISpacePartitionSystemPtr createSpacePartition();
+
     void onUndoEvent(IUndoSystem::EventType type, const std::string& operationName);
 };
 typedef std::shared_ptr<SceneGraph> SceneGraphPtr;
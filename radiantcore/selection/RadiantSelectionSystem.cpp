@@ -43,7 +43,8 @@ RadiantSelectionSystem::RadiantSelectionSystem() :
     _componentMode(ComponentSelectionMode::Default),
     _countPrimitive(0),
     _countComponent(0),
-    _selectionFocusActive(false)
+    _selectionFocusActive(false),
+    _transactionDepth(0)
 {}
 
 const SelectionInfo& RadiantSelectionSystem::getSelectionInfo() {
@@ -73,6 +74,78 @@ void RadiantSelectionSystem::notifyObservers(const scene::INodePtr& node, bool i
     }
 }
 
+void RadiantSelectionSystem::onSelectionStatusChanged(const scene::INodePtr& node, const ISelectable& selectable, bool isComponent)
+{
+    if (_transactionDepth == 0)
+    {
+        // The selectionInfo structure should be up to date before calling this
+        _sigSelectionChanged(selectable);
+        notifyObservers(node, isComponent);
+        return;
+    }
+
+    // Inside a transaction, remember the node for the notifications at the end
+    auto& changedNodeSet = isComponent ? _changedComponentNodeSet : _changedNodeSet;
+
+    if (changedNodeSet.insert(node.get()).second)
+    {
+        (isComponent ? _changedComponentNodes : _changedNodes).push_back(node);
+    }
+}
+
+void RadiantSelectionSystem::beginSelectionChangeTransaction()
+{
+    ++_transactionDepth;
+}
+
+void RadiantSelectionSystem::endSelectionChangeTransaction()
+{
+    assert(_transactionDepth > 0);
+
+    if (--_transactionDepth == 0)
+    {
+        flushSelectionChangeTransaction();
+    }
+}
+
+void RadiantSelectionSystem::flushSelectionChangeTransaction()
+{
+    if (_changedNodes.empty() && _changedComponentNodes.empty()) return;
+
+    // Move the lists out of the way, the listeners might start new transactions
+    auto changedNodes = std::move(_changedNodes);
+    auto changedComponentNodes = std::move(_changedComponentNodes);
+
+    _changedNodes.clear();
+    _changedComponentNodes.clear();
+    _changedNodeSet.clear();
+    _changedComponentNodeSet.clear();
+
+    // A single signal for the whole transaction, passing the most recently changed node
+    const auto& lastNode = changedNodes.empty() ? changedComponentNodes.back() : changedNodes.back();
+    auto selectable = std::dynamic_pointer_cast<ISelectable>(lastNode);
+
+    if (selectable)
+    {
+        _sigSelectionChanged(*selectable);
+    }
+
+    for (auto i = _observers.begin(); i != _observers.end(); )
+    {
+        auto* observer = *i++;
+
+        if (!changedNodes.empty())
+        {
+            observer->selectionBatchChanged(changedNodes, false);
+        }
+
+        if (!changedComponentNodes.empty())
+        {
+            observer->selectionBatchChanged(changedComponentNodes, true);
+        }
+    }
+}
+
 void RadiantSelectionSystem::toggleSelectionFocus()
 {
     if (_selectionFocusActive)
@@ -406,10 +479,8 @@ void RadiantSelectionSystem::onSelectedChanged(const scene::INodePtr& node, cons
     }
 
 	// greebo: Moved this here, the selectionInfo structure should be up to date before calling this
-	_sigSelectionChanged(selectable);
-
     // Notify observers, FALSE = primitive selection change
-    notifyObservers(node, false);
+    onSelectionStatusChanged(node, selectable, false);
 
     // Check if the number of selected primitives in the list matches the value of the selection counter
     ASSERT_MESSAGE(_selection.size() == _countPrimitive, "selection-tracking error");
@@ -443,10 +514,8 @@ void RadiantSelectionSystem::onComponentSelection(const scene::INodePtr& node, c
     }
 
 	// Moved here, since the _selectionInfo struct needs to be up to date
-	_sigSelectionChanged(selectable);
-
     // Notify observers, TRUE => this is a component selection change
-    notifyObservers(node, true);
+    onSelectionStatusChanged(node, selectable, true);
 
     // Check if the number of selected components in the list matches the value of the selection counter
     ASSERT_MESSAGE(_componentSelection.size() == _countComponent, "component selection-tracking error");
@@ -476,6 +545,8 @@ scene::INodePtr RadiantSelectionSystem::penultimateSelected()
 // Deselect or select all the instances in the scenegraph and notify the manipulator class as well
 void RadiantSelectionSystem::setSelectedAll(bool selected)
 {
+    SelectionChangeTransaction transaction(*this);
+
 	GlobalSceneGraph().foreachNode([&] (const scene::INodePtr& node)->bool
 	{
 		Node_setSelected(node, selected);
@@ -488,6 +559,8 @@ void RadiantSelectionSystem::setSelectedAll(bool selected)
 // Deselect or select all the component instances in the scenegraph and notify the manipulator class as well
 void RadiantSelectionSystem::setSelectedAllComponents(bool selected)
 {
+    SelectionChangeTransaction transaction(*this);
+
 	const scene::INodePtr& root = GlobalSceneGraph().root();
 
 	if (root)
@@ -514,46 +587,40 @@ void RadiantSelectionSystem::setSelectedAllComponents(bool selected)
 // Traverse the current selection components and visit them with the given visitor class
 void RadiantSelectionSystem::foreachSelectedComponent(const Visitor& visitor)
 {
-    for (auto i = _componentSelection.begin(); i != _componentSelection.end(); /* in-loop increment */)
+    _componentSelection.foreachNode([&](const scene::INodePtr& node)
     {
-        visitor.visit((i++)->first);
-    }
+        visitor.visit(node);
+    });
 }
 
 void RadiantSelectionSystem::foreachSelected(const std::function<void(const scene::INodePtr&)>& functor)
 {
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
-    {
-        functor((i++)->first);
-    }
+    _selection.foreachNode(functor);
 }
 
 void RadiantSelectionSystem::foreachSelectedComponent(const std::function<void(const scene::INodePtr&)>& functor)
 {
-	for (auto i = _componentSelection.begin(); i != _componentSelection.end(); /* in-loop increment */)
-    {
-        functor((i++)->first);
-    }
+    _componentSelection.foreachNode(functor);
 }
 
 void RadiantSelectionSystem::foreachBrush(const std::function<void(Brush&)>& functor)
 {
 	BrushSelectionWalker walker(functor);
 
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
+    _selection.foreachNode([&](const scene::INodePtr& node)
     {
-		walker.visit((i++)->first); // Handles group nodes recursively
-    }
+        walker.visit(node); // Handles group nodes recursively
+    });
 }
 
 void RadiantSelectionSystem::foreachFace(const std::function<void(IFace&)>& functor)
 {
 	FaceSelectionWalker walker(functor);
 
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
+    _selection.foreachNode([&](const scene::INodePtr& node)
     {
-		walker.visit((i++)->first); // Handles group nodes recursively
-    }
+        walker.visit(node); // Handles group nodes recursively
+    });
 
 	// Handle the component selection too
 	algorithm::forEachSelectedFaceComponent(functor);
@@ -563,10 +630,10 @@ void RadiantSelectionSystem::foreachPatch(const std::function<void(IPatch&)>& fu
 {
 	PatchSelectionWalker walker(functor);
 
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
+    _selection.foreachNode([&](const scene::INodePtr& node)
     {
-		walker.visit((i++)->first); // Handles group nodes recursively
-    }
+        walker.visit(node); // Handles group nodes recursively
+    });
 }
 
 std::size_t RadiantSelectionSystem::getSelectedFaceCount()
@@ -598,6 +665,9 @@ void RadiantSelectionSystem::deselectAll() {
 
 void RadiantSelectionSystem::selectPoint(SelectionTest& test, EModifier modifier, bool face)
 {
+    // Deselecting the previous and selecting the new items is a single change
+    SelectionChangeTransaction transaction(*this);
+
     // If the user is holding the replace modifiers (default: Alt-Shift), deselect the current selection
     if (modifier == SelectionSystem::eReplace) {
         if (face) {
@@ -730,6 +800,9 @@ void RadiantSelectionSystem::performPointSelection(const SelectablesList& candid
 
 void RadiantSelectionSystem::selectArea(SelectionTest& test, SelectionSystem::EModifier modifier, bool face)
 {
+    // Deselecting the previous and selecting the new items is a single change
+    SelectionChangeTransaction transaction(*this);
+
     // If we are in replace mode, deselect all the components or previous selections
     if (modifier == SelectionSystem::eReplace)
     {
@@ -1065,18 +1138,13 @@ void RadiantSelectionSystem::shutdownModule()
 	// selectable node a chance to remove itself from the container by setting
 	// its own selected state to false (rather than waiting for this to happen
 	// in its destructor).
-    for (auto i = _selection.begin(); i != _selection.end(); )
+    _selection.foreachNode([](const scene::INodePtr& node)
     {
-        // Take a reference to the node and increment the iterator while the
-        // iterator is still valid.
-        scene::INodePtr node = (i++)->first;
-
-        // If this is a selectable node, unselect it (which might remove it from
-        // the map and invalidate the original iterator)
+        // If this is a selectable node, unselect it (which will remove it from the list)
         auto selectable = scene::node_cast<ISelectable>(node);
         if (selectable)
             selectable->setSelected(false);
-    }
+    });
 
     // Clear the list of anything which remains.
 	_selection.clear();
@@ -6,6 +6,9 @@
 #include "icommandsystem.h"
 #include "imap.h"
 
+#include <unordered_set>
+#include <vector>
+
 #include "selectionlib.h"
 #include "SelectedNodeList.h"
 
@@ -70,6 +73,15 @@ private:
     bool _selectionFocusActive;
     std::set<scene::INodePtr> _selectionFocusPool;
 
+    // Nesting level of the active selection change transactions
+    std::size_t _transactionDepth;
+
+    // The nodes changed during the current transaction, in order of their first change
+    std::vector<scene::INodePtr> _changedNodes;
+    std::vector<scene::INodePtr> _changedComponentNodes;
+    std::unordered_set<scene::INode*> _changedNodeSet;
+    std::unordered_set<scene::INode*> _changedComponentNodeSet;
+
 public:
 	RadiantSelectionSystem();
 
@@ -113,6 +125,9 @@ public:
 	void onSelectedChanged(const scene::INodePtr& node, const ISelectable& selectable) override;
 	void onComponentSelection(const scene::INodePtr& node, const ISelectable& selectable) override;
 
+    void beginSelectionChangeTransaction() override;
+    void endSelectionChangeTransaction() override;
+
     SelectionChangedSignal signal_selectionChanged() const override
     {
         return _sigSelectionChanged;
@@ -189,6 +204,13 @@ private:
 
 	void notifyObservers(const scene::INodePtr& node, bool isComponent);
 
+    // Emits the selection changed signal and notifies the observers, or
+    // records the change if a selection change transaction is active
+    void onSelectionStatusChanged(const scene::INodePtr& node, const ISelectable& selectable, bool isComponent);
+
+    // Sends the notifications held back during the finished transaction
+    void flushSelectionChangeTransaction();
+
 	std::size_t getManipulatorIdForType(IManipulator::Type type);
 
 	// Command targets used to connect to the event system
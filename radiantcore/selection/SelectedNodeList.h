@@ -1,64 +1,251 @@
 #ifndef SELECTEDNODELIST_H_
 #define SELECTEDNODELIST_H_
 
-#include <map>
+#include <cassert>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 #include "inode.h"
 
 /**
- * greebo: This container adapts a std::multimap to keep track of
- * all the selected nodes in the scene. Additionally,
- * the insertion order is remembered to allow for retrieval
- * of the ultimate/penultimate selected node.
+ * greebo: This container keeps track of all the selected nodes in the
+ * scene, in the order they have been selected. This allows for
+ * retrieval of the ultimate/penultimate selected node.
  *
  * It also allows for the same node occuring multiple times in
- * the map at once. On deletion, the node which has been added
- * latest is removed.
+ * the list at once (e.g. a brush with several selected components).
+ * On deletion, the node which has been added latest is removed.
  *
- * It is not as fast when inserting new elements as std::list but
- * allows for fast lookup of arbitrary nodes.
- *
- * Also, the map interface is extended by the penultimate() accessor
- * which is needed by the RadiantSelectionSystem.
+ * The nodes are stored in a dense vector of slots in insertion order,
+ * plus a hash index pointing to the latest slot of each node. Each slot
+ * links to the previous occurrence of the same node. Erased slots are
+ * left behind as empty tombstones, which are compacted away once they
+ * outnumber the live entries. Appending, erasing and the ultimate()
+ * lookup run in amortised constant time.
  */
-class SelectedNodeList :
-	public std::multimap<scene::INodePtr, std::size_t>
+class SelectedNodeList
 {
-	// Shortcut typedef
-	typedef std::multimap<scene::INodePtr, std::size_t> MapType;
+private:
+    static constexpr std::size_t NoSlot = std::numeric_limits<std::size_t>::max();
+
+    // Tombstones are only compacted above this number
+    static constexpr std::size_t MinTombstonesToCompact = 64;
+
+    struct Slot
+    {
+        scene::INodePtr node; // empty for erased slots
+        std::size_t previousOccurrence;
+    };
+
+    std::vector<Slot> _slots;
+
+    // Maps each node to the slot of its latest occurrence
+    std::unordered_map<scene::INode*, std::size_t> _latestSlot;
+
+    std::size_t _size = 0;
+    std::size_t _numTombstones = 0;
+
+    // Compaction is postponed while the list is being iterated over
+    std::size_t _iterationDepth = 0;
 
-	// This is an ever-incrementing counter, some sort of "insertion time"
-	static std::size_t time;
 public:
-	/**
-	 * greebo: Returns the element which has been inserted last.
-	 *
-	 * Note: Runs in linear time = SLOW
-	 */
-	const scene::INodePtr& ultimate();
-	const scene::INodePtr& ultimate() const;
-
-	/**
-	 * greebo: Returns the element right before the last selected.
-	 *
-	 * Note: Runs in linear time = SLOW
-	 */
-	const scene::INodePtr& penultimate() const;
-	const scene::INodePtr& penultimate();
-
-	/**
-	 * greebo: Inserts a new element to this container.
-	 * Multiple insertions of the same elements are
-	 * allowed, but their insertion "time" is of course different.
-	 */
-	void append(const scene::INodePtr& selected);
-
-	/**
-	 * greebo: Removes the node which has been selected last
-	 * from this map. If multiple nodes with the same
-	 * address exist in the map, only the one with the
-	 * highest time is removed, the others are left.
-	 */
-	void erase(const scene::INodePtr& selected);
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    // Returns the number of occurrences of the given node
+    std::size_t count(const scene::INodePtr& node) const
+    {
+        auto found = _latestSlot.find(node.get());
+        std::size_t result = 0;
+
+        for (auto slot = found != _latestSlot.end() ? found->second : NoSlot;
+             slot != NoSlot; slot = _slots[slot].previousOccurrence)
+        {
+            ++result;
+        }
+
+        return result;
+    }
+
+    /**
+     * greebo: Returns the element which has been inserted last.
+     * The list must not be empty.
+     */
+    const scene::INodePtr& ultimate() const
+    {
+        assert(!empty());
+
+        // Trailing tombstones are removed outside of iterations, this is usually the last slot
+        auto slot = _slots.size();
+
+        while (!_slots[--slot].node) {}
+
+        return _slots[slot].node;
+    }
+
+    /**
+     * greebo: Returns the element right before the last selected.
+     * The list must contain at least two elements.
+     */
+    const scene::INodePtr& penultimate() const
+    {
+        assert(size() > 1);
+
+        auto slot = _slots.size();
+
+        while (!_slots[--slot].node) {}
+        while (!_slots[--slot].node) {}
+
+        return _slots[slot].node;
+    }
+
+    /**
+     * greebo: Inserts a new element to this container.
+     * Multiple insertions of the same elements are allowed.
+     */
+    void append(const scene::INodePtr& selected)
+    {
+        auto slot = _slots.size();
+        auto [latest, inserted] = _latestSlot.try_emplace(selected.get(), slot);
+
+        _slots.push_back(Slot{ selected, inserted ? NoSlot : latest->second });
+        latest->second = slot;
+
+        ++_size;
+    }
+
+    /**
+     * greebo: Removes the occurrence of the given node which
+     * has been added last, the others are left.
+     */
+    void erase(const scene::INodePtr& selected)
+    {
+        auto latest = _latestSlot.find(selected.get());
+
+        assert(latest != _latestSlot.end());
+        if (latest == _latestSlot.end()) return;
+
+        auto& slot = _slots[latest->second];
+
+        if (slot.previousOccurrence == NoSlot)
+        {
+            _latestSlot.erase(latest);
+        }
+        else
+        {
+            latest->second = slot.previousOccurrence;
+        }
+
+        slot.node.reset();
+        --_size;
+        ++_numTombstones;
+
+        if (_iterationDepth == 0)
+        {
+            removeTombstones();
+        }
+    }
+
+    void clear()
+    {
+        _slots.clear();
+        _latestSlot.clear();
+        _size = 0;
+        _numTombstones = 0;
+    }
+
+    /**
+     * Invokes the functor for each node in selection order. The functor may
+     * deselect nodes, erased nodes are not visited anymore. Nodes appended
+     * during the iteration are not visited.
+     */
+    template<typename Functor>
+    void foreachNode(const Functor& functor)
+    {
+        IterationGuard guard(*this);
+
+        for (std::size_t i = 0, end = _slots.size(); i < end && i < _slots.size(); ++i)
+        {
+            if (!_slots[i].node) continue;
+
+            // Take a copy, the functor might erase the node from this list
+            scene::INodePtr node = _slots[i].node;
+            functor(node);
+        }
+    }
+
+private:
+    struct IterationGuard
+    {
+        SelectedNodeList& _list;
+
+        IterationGuard(SelectedNodeList& list) :
+            _list(list)
+        {
+            ++_list._iterationDepth;
+        }
+
+        ~IterationGuard()
+        {
+            if (--_list._iterationDepth == 0)
+            {
+                _list.removeTombstones();
+            }
+        }
+    };
+
+    void removeTombstones()
+    {
+        // Keep the last slot alive, such that ultimate() doesn't need to search
+        while (!_slots.empty() && !_slots.back().node)
+        {
+            _slots.pop_back();
+            --_numTombstones;
+        }
+
+        if (_numTombstones > MinTombstonesToCompact && _numTombstones > _size)
+        {
+            compact();
+        }
+    }
+
+    // Removes all tombstones and rebuilds the index
+    void compact()
+    {
+        std::size_t target = 0;
+
+        for (std::size_t i = 0; i < _slots.size(); ++i)
+        {
+            if (!_slots[i].node) continue;
+
+            if (target != i)
+            {
+                _slots[target] = std::move(_slots[i]);
+            }
+
+            ++target;
+        }
+
+        _slots.resize(target);
+        _numTombstones = 0;
+
+        // Re-link the occurrences of each node
+        _latestSlot.clear();
+
+        for (std::size_t i = 0; i < _slots.size(); ++i)
+        {
+            auto [latest, inserted] = _latestSlot.try_emplace(_slots[i].node.get(), i);
+            _slots[i].previousOccurrence = inserted ? NoSlot : latest->second;
+            latest->second = i;
+        }
+    }
 };
 
 #endif /*SELECTEDNODELIST_H_*/
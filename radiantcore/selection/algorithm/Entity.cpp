@@ -268,6 +268,8 @@ void selectItemsByModel(const std::string& model)
 {
     if (!GlobalSceneGraph().root()) return;
 
+    SelectionChangeTransaction transaction;
+
     scene::EntitySelector selector([&](const Entity& entity)
     {
         return entityReferencesModel(entity, model);
@@ -279,7 +281,9 @@ void selectItemsByModel(const std::string& model)
 void deselectItemsByModel(const std::string& model)
 {
     if (!GlobalSceneGraph().root()) return;
-    
+
+    SelectionChangeTransaction transaction;
+
     scene::EntitySelector deselector([&](const Entity& entity)
     {
         return entityReferencesModel(entity, model);
@@ -79,6 +79,8 @@ bool EntitySelectByClassnameWalker::entityMatches(Entity* entity) const {
 
 void selectAllOfType(const cmd::ArgumentList& args)
 {
+	SelectionChangeTransaction transaction;
+
 	if (GlobalSelectionSystem().getSelectionInfo().componentCount > 0 &&
 		!FaceInstance::Selection().empty())
 	{
@@ -432,6 +434,8 @@ public:
 
 void invertSelection(const cmd::ArgumentList& args)
 {
+	SelectionChangeTransaction transaction;
+
 	if (GlobalSelectionSystem().getSelectionMode() == SelectionMode::Component)
 	{
 		InvertComponentSelectionWalker walker(GlobalSelectionSystem().ComponentMode());
@@ -569,6 +573,8 @@ public:
 			return;
 		}
 
+		SelectionChangeTransaction transaction;
+
 		// delete selected objects?
 		if (deleteBoundsSrc)
 		{
@@ -581,6 +587,8 @@ public:
 
     static void DoSelection(const std::vector<AABB>& aabbs)
     {
+        SelectionChangeTransaction transaction;
+
         SelectByBounds<TSelectionPolicy> walker(aabbs);
         GlobalSceneGraph().root()->traverse(walker);
 
@@ -252,6 +252,8 @@ public:
 };
 
 void selectChildren(const cmd::ArgumentList& args) {
+	SelectionChangeTransaction transaction;
+
 	// Traverse the selection and identify the groupnodes
 	GlobalSelectionSystem().foreachSelected(
 		GroupNodeChildSelector()
@@ -291,6 +293,8 @@ public:
 
 void expandSelectionToSiblings(const cmd::ArgumentList& args)
 {
+	SelectionChangeTransaction transaction;
+
 	ExpandSelectionToSiblingsWalker walker;
 	GlobalSceneGraph().root()->traverse(walker);
 }
@@ -333,6 +337,8 @@ public:
 
 void selectParentEntitiesOfSelected(const cmd::ArgumentList& args)
 {
+	SelectionChangeTransaction transaction;
+
 	PropagateSelectionToParentEntityWalker walker;
 	GlobalSceneGraph().root()->traverse(walker);
 }
@@ -50,6 +50,13 @@ void GroupCycle::selectionChanged(const scene::INodePtr& node, bool isComponent)
 	}
 }
 
+void GroupCycle::selectionBatchChanged(const std::vector<scene::INodePtr>& nodes, bool isComponent) {
+	// The outcome only depends on the final selection, rescan once
+	if (!isComponent) {
+		rescanSelection();
+	}
+}
+
 void GroupCycle::rescanSelection() {
 	if (_updateActive) {
 		return;
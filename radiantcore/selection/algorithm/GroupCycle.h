@@ -31,7 +31,8 @@ public:
 	/** greebo: The callback that gets invoked upon selectionChange
 	 * by the RadiantSelectionSystem
 	 */
-	void selectionChanged(const scene::INodePtr& node, bool isComponent);
+	void selectionChanged(const scene::INodePtr& node, bool isComponent) override;
+	void selectionBatchChanged(const std::vector<scene::INodePtr>& nodes, bool isComponent) override;
 
 	/** greebo: Rescans the current selection and populates the Vector of candidates
 	 */
@@ -13,10 +13,12 @@
 #include "fmt/format.h"
 
 #include "RGBAImage.h"
+#include "ImageKernels.h"
 #include "textures/HeightmapCreator.h"
 #include "textures/TextureManipulator.h"
 #include "string/predicate.h"
 #include "ShaderTemplate.h"
+#include "MaterialManager.h"
 
 /* CONSTANTS */
 namespace
@@ -110,6 +112,26 @@ MapExpressionPtr MapExpression::createForString(const std::string& str)
     }
 }
 
+ImagePtr MapExpression::getCachedImage() const
+{
+    auto& cache = GetTextureManager().getImageCache();
+    auto identifier = getIdentifier();
+
+    if (auto cached = cache.find(identifier); cached)
+    {
+        return cached;
+    }
+
+    auto image = getImage();
+
+    if (image)
+    {
+        cache.insert(identifier, image);
+    }
+
+    return image;
+}
+
 ImagePtr MapExpression::getResampled(const ImagePtr& input, std::size_t width, std::size_t height)
 {
 	// Don't process precompressed images
@@ -148,7 +170,7 @@ HeightMapExpression::HeightMapExpression (DefTokeniser& token) {
 
 ImagePtr HeightMapExpression::getImage() const {
 	// Get the heightmap from the contained expression
-	ImagePtr heightMap = heightMapExp->getImage();
+	ImagePtr heightMap = heightMapExp->getCachedImage();
 
 	if (heightMap == NULL) return ImagePtr();
 
@@ -183,14 +205,14 @@ AddNormalsExpression::AddNormalsExpression (DefTokeniser& token) {
 }
 
 ImagePtr AddNormalsExpression::getImage() const {
-    ImagePtr imgOne = mapExpOne->getImage();
+    ImagePtr imgOne = mapExpOne->getCachedImage();
 
     if (imgOne == NULL) return ImagePtr();
 
     std::size_t width = imgOne->getWidth();
     std::size_t height = imgOne->getHeight();
 
-    ImagePtr imgTwo = mapExpTwo->getImage();
+    ImagePtr imgTwo = mapExpTwo->getCachedImage();
 
     if (imgTwo == NULL) return ImagePtr();
 
@@ -205,40 +227,9 @@ ImagePtr AddNormalsExpression::getImage() const {
 
     ImagePtr result (new image::RGBAImage(width, height));
 
-    byte* pixOne = imgOne->getPixels();
-    byte* pixTwo = imgTwo->getPixels();
-    byte* pixOut = result->getPixels();
-
-    // iterate through the pixels
-    for( std::size_t y = 0; y < height; y++ )
-	{
-		for( std::size_t x = 0; x < width; x++ )
-		{
-			// create the two vectors
-			Vector3 vectorOne(
-    			static_cast<double>(pixOne[0]),
-    			static_cast<double>(pixOne[1]),
-    			static_cast<double>(pixOne[2])
-			);
-			Vector3 vectorTwo(
-    			static_cast<double>(pixTwo[0]),
-    			static_cast<double>(pixTwo[1]),
-    			static_cast<double>(pixTwo[2])
-			);
-			// Take the mean value of the two vectors
-			Vector3 vectorOut = (vectorOne + vectorTwo) * 0.5;
-
-			pixOut[0] = static_cast<byte>(float_to_integer(vectorOut.x()));
-			pixOut[1] = static_cast<byte>(float_to_integer(vectorOut.y()));
-			pixOut[2] = static_cast<byte>(float_to_integer(vectorOut.z()));
-			pixOut[3] = 255;
+    // Take the mean value of the two vectors
+    image::kernel::averageNormals(imgOne->getPixels(), imgTwo->getPixels(), result->getPixels(), width * height);
 
-			// advance the pixel pointer
-			pixOne += 4;
-			pixTwo += 4;
-			pixOut += 4;
-		}
-    }
     return result;
 }
 
@@ -261,7 +252,7 @@ SmoothNormalsExpression::SmoothNormalsExpression (DefTokeniser& token) {
 
 ImagePtr SmoothNormalsExpression::getImage() const {
 
-	ImagePtr normalMap = mapExp->getImage();
+	ImagePtr normalMap = mapExp->getCachedImage();
 
 	if (normalMap == NULL) return ImagePtr();
 
@@ -276,56 +267,9 @@ ImagePtr SmoothNormalsExpression::getImage() const {
 
 	ImagePtr result (new image::RGBAImage(width, height));
 
-	byte* in = normalMap->getPixels();
-	byte* out = result->getPixels();
-
-	struct KernelElement {
-		// offset to the current pixel
-		int dx, dy;
-	};
-
-	// a 3x3 kernel with the surrounding pixels including the pixel itself
-	const int kernelSize = 9;
-	KernelElement kernel[kernelSize] = {
-		{-1, -1 },
-		{ 0, -1 },
-		{ 1, -1 },
-		{ 1,  0 },
-		{ 1,  1 },
-		{ 0,  1 },
-		{-1,  1 },
-		{-1,  0 },
-		{ 0,  0 }
-	};
-	const float perKernelSize = 1.0f/kernelSize;
-
-	// iterate through the pixels
-	for( std::size_t y = 0; y < height; y++) {
-		for( std::size_t x = 0; x < width; x++) {
-			//the new normal vector for this pixel
-			Vector3 smoothVector(0,0,0);
-
-			// calculate the average direction of the surrounding vectors
-			for (KernelElement* i = kernel; i != kernel + kernelSize; ++i) {
-				// temporary vector to represent one of the surrounding pixels
-				byte* pixel = getPixel(in, width, height, x + i->dx, y + i->dy);
-				Vector3 temp(pixel[0], pixel[1], pixel[2]);
-
-				smoothVector += temp;
-			}
-
-			// Take the average normal vector as result
-			smoothVector *= perKernelSize;
-
-			out[0] = static_cast<byte>(float_to_integer(smoothVector.x()));
-			out[1] = static_cast<byte>(float_to_integer(smoothVector.y()));
-			out[2] = static_cast<byte>(float_to_integer(smoothVector.z()));
-			out[3] = 255;
+	// Take the average normal vector of the surrounding pixels as result
+	image::kernel::smoothNormals(normalMap->getPixels(), result->getPixels(), width, height);
 
-			// advance the pixel pointer
-			out += 4;
-	    }
-	}
     return result;
 }
 
@@ -349,14 +293,14 @@ AddExpression::AddExpression (DefTokeniser& token) {
 }
 
 ImagePtr AddExpression::getImage() const {
-    ImagePtr imgOne = mapExpOne->getImage();
+    ImagePtr imgOne = mapExpOne->getCachedImage();
 
     if (imgOne == NULL) return ImagePtr();
 
     std::size_t width = imgOne->getWidth();
     std::size_t height = imgOne->getHeight();
 
-	ImagePtr imgTwo = mapExpTwo->getImage();
+	ImagePtr imgTwo = mapExpTwo->getCachedImage();
 
 	if (imgTwo == NULL) return ImagePtr();
 
@@ -371,27 +315,9 @@ ImagePtr AddExpression::getImage() const {
 
     ImagePtr result (new image::RGBAImage(width, height));
 
-    byte* pixOne = imgOne->getPixels();
-    byte* pixTwo = imgTwo->getPixels();
-    byte* pixOut = result->getPixels();
+    // add the colors
+    image::kernel::average(imgOne->getPixels(), imgTwo->getPixels(), result->getPixels(), width * height);
 
-    // iterate through the pixels
-    for( std::size_t y = 0; y < height; y++)
-	{
-		for( std::size_t x = 0; x < width; x++)
-		{
-			// add the colors
-			pixOut[0] = static_cast<byte>(float_to_integer((static_cast<float>(pixOne[0]) + pixTwo[0]) * 0.5f));
-			pixOut[1] = static_cast<byte>(float_to_integer((static_cast<float>(pixOne[1]) + pixTwo[1]) * 0.5f));
-			pixOut[2] = static_cast<byte>(float_to_integer((static_cast<float>(pixOne[2]) + pixTwo[2]) * 0.5f));
-			pixOut[3] = static_cast<byte>(float_to_integer((static_cast<float>(pixOne[3]) + pixTwo[3]) * 0.5f));
-
-			//advance the pixel pointer
-			pixOne += 4;
-			pixTwo += 4;
-			pixOut += 4;
-		}
-    }
 	return result;
 }
 
@@ -433,7 +359,7 @@ ScaleExpression::ScaleExpression(DefTokeniser& token) :
 
 ImagePtr ScaleExpression::getImage() const
 {
-    ImagePtr img = mapExp->getImage();
+    ImagePtr img = mapExp->getCachedImage();
 
     if (img == NULL) return ImagePtr();
 
@@ -504,7 +430,7 @@ InvertAlphaExpression::InvertAlphaExpression (DefTokeniser& token) {
 }
 
 ImagePtr InvertAlphaExpression::getImage() const {
-	ImagePtr img = mapExp->getImage();
+	ImagePtr img = mapExp->getCachedImage();
 
 	if (img == NULL) return ImagePtr();
 
@@ -519,24 +445,8 @@ ImagePtr InvertAlphaExpression::getImage() const {
 
 	ImagePtr result (new image::RGBAImage(width, height));
 
-	byte* in = img->getPixels();
-	byte* out = result->getPixels();
-
-	// iterate through the pixels
-	for( std::size_t y = 0; y < height; ++y)
-	{
-		for( std::size_t x = 0; x < width; ++x)
-		{
-			out[0] = in[0];
-			out[1] = in[1];
-			out[2] = in[2];
-			out[3] = 255 - in[3];
-
-			// advance the pixel pointer
-			in += 4;
-			out += 4;
-		}
-	}
+	// Invert the alpha channel of each pixel
+	image::kernel::invertAlpha(img->getPixels(), result->getPixels(), width * height);
 
 	return result;
 }
@@ -559,7 +469,7 @@ InvertColorExpression::InvertColorExpression (DefTokeniser& token) {
 }
 
 ImagePtr InvertColorExpression::getImage() const {
-	ImagePtr img = mapExp->getImage();
+	ImagePtr img = mapExp->getCachedImage();
 
 	if (img == NULL) return ImagePtr();
 
@@ -574,22 +484,8 @@ ImagePtr InvertColorExpression::getImage() const {
 
 	ImagePtr result (new image::RGBAImage(width, height));
 
-	byte* in = img->getPixels();
-	byte* out = result->getPixels();
-
-	// iterate through the pixels
-	for( std::size_t y = 0; y < height; y++) {
-		for( std::size_t x = 0; x < width; x++) {
-			out[0] = 255 - in[0];
-			out[1] = 255 - in[1];
-			out[2] = 255 - in[2];
-			out[3] = in[3];
-
-			// advance the pixel pointer
-			in += 4;
-			out += 4;
-		}
-	}
+	// Invert the colour channels of each pixel
+	image::kernel::invertColour(img->getPixels(), result->getPixels(), width * height);
 
 	return result;
 }
@@ -612,7 +508,7 @@ MakeIntensityExpression::MakeIntensityExpression (DefTokeniser& token) {
 }
 
 ImagePtr MakeIntensityExpression::getImage() const {
-	ImagePtr img = mapExp->getImage();
+	ImagePtr img = mapExp->getCachedImage();
 
 	if (img == NULL) return ImagePtr();
 
@@ -627,24 +523,8 @@ ImagePtr MakeIntensityExpression::getImage() const {
 
 	ImagePtr result (new image::RGBAImage(width, height));
 
-	byte* in = img->getPixels();
-	byte* out = result->getPixels();
-
-	// iterate through the pixels
-	for( std::size_t y = 0; y < height; ++y)
-	{
-		for( std::size_t x = 0; x < width; ++x)
-		{
-			out[0] = in[0];
-			out[1] = in[0];
-			out[2] = in[0];
-			out[3] = in[0];
-
-			// advance the pixel pointer
-			in += 4;
-			out += 4;
-		}
-	}
+	// Copy the red channel into all channels
+	image::kernel::makeIntensity(img->getPixels(), result->getPixels(), width * height);
 
 	return result;
 }
@@ -670,7 +550,7 @@ MakeAlphaExpression::MakeAlphaExpression(DefTokeniser& token)
 
 ImagePtr MakeAlphaExpression::getImage() const
 {
-	ImagePtr img = mapExp->getImage();
+	ImagePtr img = mapExp->getCachedImage();
 
 	if (img == NULL) return ImagePtr();
 
@@ -685,24 +565,8 @@ ImagePtr MakeAlphaExpression::getImage() const
 
 	ImagePtr result (new image::RGBAImage(width, height));
 
-	byte* in = img->getPixels();
-	byte* out = result->getPixels();
-
-	// iterate through the pixels
-	for( std::size_t y = 0; y < height; y++)
-	{
-		for( std::size_t x = 0; x < width; x++)
-		{
-			out[0] = 255;
-			out[1] = 255;
-			out[2] = 255;
-			out[3] = (in[0] + in[1] + in[2])/3;
-
-			// advance the pixel pointer
-			in += 4;
-			out += 4;
-		}
-	}
+	// The average of the colour channels goes into the alpha channel, the colour is white
+	image::kernel::makeAlpha(img->getPixels(), result->getPixels(), width * height);
 
 	return result;
 }
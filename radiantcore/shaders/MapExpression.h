@@ -39,7 +39,7 @@ public:
     /* BindableTexture interface */
     TexturePtr bindTexture(const std::string& name, Role role) const override
     {
-        ImagePtr img = getImage();
+        ImagePtr img = getCachedImage();
         if (img)
             return img->bindTexture(name, role);
         else
@@ -49,6 +49,10 @@ public:
     // Abstract method to be implemented
     virtual ImagePtr getImage() const = 0;
 
+    // Returns the image of this expression, it is looked up in the texture manager's
+    // image cache first. The returned image is shared and must not be modified.
+    ImagePtr getCachedImage() const;
+
 public: /* STATIC CONSTRUCTION METHODS */
 
 	/** Creates the a MapExpression out of the given token. Nested mapexpressions
@@ -53,12 +53,14 @@ void MaterialManager::construct()
 void MaterialManager::destroy()
 {
     // Don't destroy the GLTextureManager, it's called from
-    // the CShader destructors.
+    // the CShader destructors. Just stop its background loads.
+    _textureManager->stopStreaming();
 }
 
 void MaterialManager::freeShaders() {
     _library->clear();
     _textureManager->checkBindings();
+    _textureManager->getImageCache().clear();
     activeShadersChangedNotify();
 }
 
@@ -268,12 +270,25 @@ ITableDefinition::Ptr MaterialManager::getTable(const std::string& name)
 
 void MaterialManager::reloadImages()
 {
+    // Make sure the images are read from disk again
+    _textureManager->getImageCache().clear();
+
     _library->foreachShader([](const CShaderPtr& shader)
     {
         shader->refreshImageMaps();
     });
 }
 
+void MaterialManager::uploadStreamedTextures(std::size_t millisecondBudget)
+{
+    _textureManager->uploadStreamedTextures(millisecondBudget);
+}
+
+std::size_t MaterialManager::getNumPendingTextureLoads()
+{
+    return _textureManager->getNumPendingLoads();
+}
+
 const std::string& MaterialManager::getName() const
 {
     static std::string _name(MODULE_SHADERSYSTEM);
@@ -310,10 +325,16 @@ void MaterialManager::initialiseModule(const IApplicationContext& ctx)
     GlobalFiletypes().registerPattern("material", FileTypePattern(_("Material File"), "mtr", "*.mtr"));
 
     GlobalCommandSystem().addCommand("ReloadImages", [this](const cmd::ArgumentList&) { reloadImages(); });
+    GlobalCommandSystem().addCommand("ShowTextureMemoryStats", [this](const cmd::ArgumentList&)
+    {
+        _textureManager->printMemoryStats();
+    });
 }
 
 void MaterialManager::onMaterialDefsReloaded()
 {
+    _textureManager->getImageCache().clear();
+
     _library->foreachShader([](const CShaderPtr& shader)
     {
         shader->unrealise();
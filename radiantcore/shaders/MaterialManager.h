@@ -90,6 +90,9 @@ public:
 
     void reloadImages() override;
 
+    void uploadStreamedTextures(std::size_t millisecondBudget) override;
+    std::size_t getNumPendingTextureLoads() override;
+
 public:
     sigc::signal<void> signal_activeShadersChanged() const override;
 
@@ -7,15 +7,58 @@
 #include "igl.h"
 #include "../MapExpression.h"
 #include "TextureManipulator.h"
+#include "StreamedTexture.h"
+#include "RGBAImage.h"
 #include "parser/DefTokeniser.h"
+#include "string/format.h"
+#include "time/StopWatch.h"
+#include <algorithm>
 
 namespace
 {
     const std::string SHADER_NOT_FOUND = "_missing_shader.png";
+
+    // Textures used within this period are never evicted, they are likely to be needed in the next frame
+    constexpr std::chrono::milliseconds EVICTION_GRACE_PERIOD(1000);
+
+    constexpr std::size_t MEGABYTE = 1024 * 1024;
+
+    // Estimates the texture memory occupied by the given image once it is uploaded
+    std::size_t getTextureSizeInBytes(const Image& image)
+    {
+        auto size = shaders::getImageSizeInBytes(image);
+
+        // Mipmaps are generated for images which don't provide their own
+        return image.getLevels() > 1 ? size : size * 4 / 3;
+    }
+
+    // Creates a single-pixel texture of the given colour
+    TexturePtr createSolidTexture(const std::string& name, const image::RGBAPixel& colour)
+    {
+        image::RGBAImage image(1, 1);
+        image.pixels[0] = colour;
+
+        return image.bindTexture(name, BindableTexture::Role::COLOUR);
+    }
 }
 
 namespace shaders {
 
+GLTextureManager::GLTextureManager() :
+    _streamingEnabled(RKEY_TEXTURE_STREAMING),
+    _imageCacheSize(RKEY_IMAGE_CACHE_SIZE),
+    _textureMemoryLimit(RKEY_TEXTURE_MEMORY_LIMIT),
+    _residentTextureMemory(0),
+    _numPendingLoads(0)
+{
+    _imageCache.setCapacity(std::max(_imageCacheSize.get(), 0) * MEGABYTE);
+}
+
+GLTextureManager::~GLTextureManager()
+{
+    stopStreaming();
+}
+
 void GLTextureManager::checkBindings()
 {
     // Check the TextureMap for unique pointers and release them
@@ -57,6 +100,17 @@ TexturePtr GLTextureManager::getBinding(const NamedBindablePtr& bindable,
         return existing->second;
     }
 
+    // Images of map expressions can be evaluated by the workers
+    if (_streamingEnabled.get())
+    {
+        if (auto expression = std::dynamic_pointer_cast<MapExpression>(bindable); expression)
+        {
+            auto texture = requestStreamedTexture(expression, identifier, role);
+            _textures.emplace(identifier, texture);
+            return texture;
+        }
+    }
+
     // Create and insert texture object, if it is valid
     auto texture = bindable->bindTexture(identifier, role);
     if (texture)
@@ -105,6 +159,240 @@ void GLTextureManager::clearCacheForBindable(const NamedBindablePtr& bindable)
     _textures.erase(bindable->getIdentifier());
 }
 
+TexturePtr GLTextureManager::requestStreamedTexture(const MapExpressionPtr& expression,
+    const std::string& identifier, BindableTexture::Role role)
+{
+    auto texture = std::make_shared<StreamedTexture>(identifier, expression, role, getPlaceholder(role));
+    _streamedTextures.emplace_back(texture);
+
+    queueLoad(texture);
+
+    return texture;
+}
+
+void GLTextureManager::queueLoad(const std::shared_ptr<StreamedTexture>& texture)
+{
+    if (!_workers)
+    {
+        // Make sure the resampler is constructed on this thread, it is connecting to the registry
+        TextureManipulator::instance();
+
+        _workers = std::make_unique<util::ThreadPool>();
+    }
+
+    texture->setLoading(true);
+    ++_numPendingLoads;
+
+    std::weak_ptr<StreamedTexture> weakTexture(texture);
+    auto expression = texture->getExpression();
+
+    _workers->enqueue([this, expression, weakTexture]()
+    {
+        DecodedImage decoded{ weakTexture, ImagePtr() };
+
+        // Nothing to do if the texture has been released in the meantime
+        if (!weakTexture.expired())
+        {
+            try
+            {
+                decoded.image = expression->getCachedImage();
+            }
+            catch (const std::exception& ex)
+            {
+                rError() << "[shaders] Exception loading texture " << expression->getIdentifier() << ": " << ex.what() << std::endl;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_decodedImagesLock);
+        _decodedImages.emplace_back(std::move(decoded));
+    });
+}
+
+TexturePtr GLTextureManager::getPlaceholder(BindableTexture::Role role)
+{
+    // A neutral grey for colour maps and a flat surface for normal maps
+    if (role == BindableTexture::Role::NORMAL_MAP)
+    {
+        if (!_normalMapPlaceholder)
+        {
+            _normalMapPlaceholder = createSolidTexture("_streamingPlaceholderNormal", { 128, 128, 255, 255 });
+        }
+
+        return _normalMapPlaceholder;
+    }
+
+    if (!_colourPlaceholder)
+    {
+        _colourPlaceholder = createSolidTexture("_streamingPlaceholder", { 128, 128, 128, 255 });
+    }
+
+    return _colourPlaceholder;
+}
+
+void GLTextureManager::uploadStreamedTextures(std::size_t millisecondBudget)
+{
+    util::StopWatch stopWatch;
+
+    updateResidency();
+
+    while (true)
+    {
+        DecodedImage decoded;
+
+        {
+            std::lock_guard<std::mutex> lock(_decodedImagesLock);
+
+            if (_decodedImages.empty()) break;
+
+            decoded = std::move(_decodedImages.front());
+            _decodedImages.pop_front();
+        }
+
+        --_numPendingLoads;
+
+        auto texture = decoded.texture.lock();
+
+        // Skip the upload if nobody is using this texture anymore
+        if (!texture) continue;
+
+        auto result = decoded.image ? decoded.image->bindTexture(texture->getName(), texture->getRole()) : TexturePtr();
+
+        if (result)
+        {
+            auto size = getTextureSizeInBytes(*decoded.image);
+
+            texture->setTexture(result, size);
+            _residentTextureMemory += size;
+        }
+        else
+        {
+            rError() << "[shaders] Unable to load texture: " << texture->getName() << std::endl;
+
+            // The fallback textures are shared, they don't count towards the limit.
+            // Stick to the placeholder if not even the fallback is available.
+            auto fallback = getShaderNotFound();
+            texture->setTexture(fallback ? fallback : getPlaceholder(texture->getRole()), 0);
+        }
+
+        if (stopWatch.getMilliSecondsPassed() >= millisecondBudget) break;
+    }
+}
+
+void GLTextureManager::updateResidency()
+{
+    _imageCache.setCapacity(std::max(_imageCacheSize.get(), 0) * MEGABYTE);
+
+    auto now = StreamedTexture::Clock::now();
+    std::vector<std::shared_ptr<StreamedTexture>> candidates;
+    std::size_t residentMemory = 0;
+
+    for (std::size_t i = 0; i < _streamedTextures.size(); /* in-loop increment */)
+    {
+        auto texture = _streamedTextures[i].lock();
+
+        if (!texture)
+        {
+            // Released by its owners, order doesn't matter
+            _streamedTextures[i] = std::move(_streamedTextures.back());
+            _streamedTextures.pop_back();
+            continue;
+        }
+
+        ++i;
+
+        if (texture->checkAndResetUsage())
+        {
+            texture->setLastUsed(now);
+
+            // Evicted textures are loaded again as soon as they are needed
+            if (!texture->isLoaded() && !texture->isLoading())
+            {
+                queueLoad(texture);
+            }
+        }
+
+        if (texture->getSizeInBytes() == 0) continue;
+
+        residentMemory += texture->getSizeInBytes();
+
+        if (now - texture->getLastUsed() >= EVICTION_GRACE_PERIOD)
+        {
+            candidates.emplace_back(std::move(texture));
+        }
+    }
+
+    _residentTextureMemory = residentMemory;
+
+    // A limit of 0 keeps all textures resident
+    auto limit = std::max(_textureMemoryLimit.get(), 0) * MEGABYTE;
+
+    if (limit == 0 || _residentTextureMemory <= limit) return;
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+    {
+        return a->getLastUsed() < b->getLastUsed();
+    });
+
+    for (const auto& texture : candidates)
+    {
+        if (_residentTextureMemory <= limit) break;
+
+        _residentTextureMemory -= texture->getSizeInBytes();
+        texture->evict();
+    }
+}
+
+std::size_t GLTextureManager::getNumPendingLoads() const
+{
+    return _numPendingLoads;
+}
+
+void GLTextureManager::stopStreaming()
+{
+    // Blocks until the running evaluations are done
+    _workers.reset();
+
+    std::lock_guard<std::mutex> lock(_decodedImagesLock);
+    _decodedImages.clear();
+    _numPendingLoads = 0;
+}
+
+ImageCache& GLTextureManager::getImageCache()
+{
+    return _imageCache;
+}
+
+void GLTextureManager::printMemoryStats()
+{
+    std::size_t numTextures = 0;
+    std::size_t numResident = 0;
+
+    for (const auto& weakTexture : _streamedTextures)
+    {
+        if (auto texture = weakTexture.lock(); texture)
+        {
+            ++numTextures;
+            numResident += texture->isLoaded() ? 1 : 0;
+        }
+    }
+
+    auto limit = std::max(_textureMemoryLimit.get(), 0) * MEGABYTE;
+
+    rMessage() << "-- Texture Memory --" << std::endl;
+    rMessage() << "Streamed Textures: " << numTextures << " (" << numResident << " resident, "
+        << (numTextures - numResident) << " evicted or loading)" << std::endl;
+    rMessage() << "  Texture Memory: " << string::getFormattedByteSize(_residentTextureMemory)
+        << " of " << (limit > 0 ? string::getFormattedByteSize(limit) : std::string("unlimited")) << std::endl;
+
+    auto hits = _imageCache.getNumHits();
+    auto requests = hits + _imageCache.getNumMisses();
+
+    rMessage() << "Image Cache: " << _imageCache.getNumImages() << " images" << std::endl;
+    rMessage() << "  Memory: " << string::getFormattedByteSize(_imageCache.getSizeInBytes())
+        << " of " << string::getFormattedByteSize(_imageCache.getCapacity()) << std::endl;
+    rMessage() << "  Hits: " << hits << " of " << requests << " requests" << std::endl;
+}
+
 // Return the shader-not-found texture, loading if necessary
 TexturePtr GLTextureManager::getShaderNotFound()
 {
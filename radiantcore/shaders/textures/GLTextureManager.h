@@ -3,12 +3,21 @@
 
 #include "ishaders.h"
 #include <map>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <vector>
 #include "../MapExpression.h"
+#include "ImageCache.h"
 #include "texturelib.h"
+#include "registry/CachedKey.h"
+#include "util/ThreadPool.h"
 
 namespace shaders
 {
 
+class StreamedTexture;
+
 class GLTextureManager
 {
 	// The mapping between texturekeys and Texture instances
@@ -18,14 +27,72 @@ class GLTextureManager
 	// The fallback textures in case a texture is empty or broken
 	TexturePtr _shaderNotFound;
 
+	// Stand-ins for streamed textures while they are loading, one per role
+	TexturePtr _colourPlaceholder;
+	TexturePtr _normalMapPlaceholder;
+
+	// Whether map expressions are evaluated in the background
+	registry::CachedKey<bool> _streamingEnabled;
+
+	// Memory limits in megabytes
+	registry::CachedKey<int> _imageCacheSize;
+	registry::CachedKey<int> _textureMemoryLimit;
+
+	// The images evaluated from map expressions
+	ImageCache _imageCache;
+
+	// All streamed textures handed out so far, used to track their residency
+	std::vector<std::weak_ptr<StreamedTexture>> _streamedTextures;
+
+	// The estimated memory occupied by the resident streamed textures
+	std::size_t _residentTextureMemory;
+
+	// An image evaluated by a worker, waiting to be uploaded to GL
+	struct DecodedImage
+	{
+		std::weak_ptr<StreamedTexture> texture;
+		ImagePtr image;
+	};
+
+	// Images that are ready for upload, filled by the workers
+	std::mutex _decodedImagesLock;
+	std::deque<DecodedImage> _decodedImages;
+
+	// Requested streamed textures that have not been uploaded yet
+	std::size_t _numPendingLoads;
+
+	// Evaluates the map expressions of streamed textures, created on first use
+	std::unique_ptr<util::ThreadPool> _workers;
+
 private:
 
 	// Constructs the fallback textures like "Shader Image Missing"
 	TexturePtr loadStandardTexture(const std::string& filename);
 
-public:
+	// Returns a new texture which is loaded in the background
+	TexturePtr requestStreamedTexture(const MapExpressionPtr& expression,
+                                      const std::string& identifier,
+                                      BindableTexture::Role role);
+
+	// Schedules the evaluation of the texture's map expression
+	void queueLoad(const std::shared_ptr<StreamedTexture>& texture);
+
+	TexturePtr getPlaceholder(BindableTexture::Role role);
 
-    /// Construct a bound texture from a generic named bindable.
+	// Reloads evicted textures which are in use again and evicts the least
+	// recently used ones until the texture memory limit is met
+	void updateResidency();
+
+public:
+	GLTextureManager();
+	~GLTextureManager();
+
+    /**
+     * Construct a bound texture from a generic named bindable. Images of map
+     * expressions are loaded in the background if streaming is enabled, the
+     * returned texture is then showing a placeholder until the image has been
+     * uploaded by uploadStreamedTextures().
+     */
     TexturePtr getBinding(const NamedBindablePtr& bindable,
                           BindableTexture::Role role = BindableTexture::Role::COLOUR);
 
@@ -53,6 +120,24 @@ public:
 	 */
 	void checkBindings();
 
+	// Uploads the images which have been loaded in the background, until the given
+	// amount of time has been spent. At least one image is uploaded per call.
+	// Streamed textures exceeding the texture memory limit are evicted, they
+	// are loaded again when used. Must be called from the thread owning the GL context.
+	void uploadStreamedTextures(std::size_t millisecondBudget);
+
+	// The number of streamed textures which are still showing their placeholder
+	std::size_t getNumPendingLoads() const;
+
+	// Stops the background workers and discards all unfinished loads,
+	// the affected textures keep showing their placeholder
+	void stopStreaming();
+
+	// The cache of the images evaluated from map expressions
+	ImageCache& getImageCache();
+
+	// Writes the texture and image memory usage to the console
+	void printMemoryStats();
 };
 
 typedef std::shared_ptr<GLTextureManager> GLTextureManagerPtr;
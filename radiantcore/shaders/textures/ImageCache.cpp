@@ -0,0 +1,154 @@
+#include "ImageCache.h"
+
+#include <algorithm>
+
+namespace shaders
+{
+
+std::size_t getImageSizeInBytes(const Image& image)
+{
+    std::size_t size = 0;
+
+    for (std::size_t level = 0; level < image.getLevels(); ++level)
+    {
+        auto width = image.getWidth(level);
+        auto height = image.getHeight(level);
+
+        switch (image.getGLFormat())
+        {
+        // S3TC formats are stored in blocks of 4x4 pixels, 8 or 16 bytes each
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+            size += std::max<std::size_t>(width, 4) * std::max<std::size_t>(height, 4) / 2;
+            break;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            size += std::max<std::size_t>(width, 4) * std::max<std::size_t>(height, 4);
+            break;
+
+        case GL_RGB:
+        case GL_BGR:
+            size += width * height * 3;
+            break;
+
+        default:
+            size += width * height * 4;
+            break;
+        }
+    }
+
+    return size;
+}
+
+ImageCache::ImageCache(std::size_t capacity) :
+    _sizeInBytes(0),
+    _capacity(capacity),
+    _hits(0),
+    _misses(0)
+{}
+
+ImagePtr ImageCache::find(const std::string& identifier)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto found = _index.find(identifier);
+
+    if (found == _index.end())
+    {
+        ++_misses;
+        return ImagePtr();
+    }
+
+    ++_hits;
+
+    // Move the entry to the front of the list
+    _entries.splice(_entries.begin(), _entries, found->second);
+
+    return found->second->image;
+}
+
+void ImageCache::insert(const std::string& identifier, const ImagePtr& image)
+{
+    auto sizeInBytes = getImageSizeInBytes(*image);
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (sizeInBytes > _capacity) return;
+
+    auto existing = _index.find(identifier);
+
+    if (existing != _index.end())
+    {
+        // Another thread has been evaluating the same expression, keep the first image
+        _entries.splice(_entries.begin(), _entries, existing->second);
+        return;
+    }
+
+    shrinkTo(_capacity - sizeInBytes);
+
+    _entries.emplace_front(Entry{ identifier, image, sizeInBytes });
+    _index.emplace(identifier, _entries.begin());
+    _sizeInBytes += sizeInBytes;
+}
+
+void ImageCache::setCapacity(std::size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _capacity = capacity;
+    shrinkTo(_capacity);
+}
+
+std::size_t ImageCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _capacity;
+}
+
+void ImageCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _entries.clear();
+    _index.clear();
+    _sizeInBytes = 0;
+}
+
+std::size_t ImageCache::getNumImages() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _entries.size();
+}
+
+std::size_t ImageCache::getSizeInBytes() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _sizeInBytes;
+}
+
+std::size_t ImageCache::getNumHits() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _hits;
+}
+
+std::size_t ImageCache::getNumMisses() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _misses;
+}
+
+void ImageCache::shrinkTo(std::size_t sizeInBytes)
+{
+    while (_sizeInBytes > sizeInBytes && !_entries.empty())
+    {
+        const auto& last = _entries.back();
+
+        _sizeInBytes -= last.sizeInBytes;
+        _index.erase(last.identifier);
+        _entries.pop_back();
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "iimage.h"
+
+namespace shaders
+{
+
+// Estimates the memory occupied by the pixels of the given image, including all its mipmaps
+std::size_t getImageSizeInBytes(const Image& image);
+
+/**
+ * \brief
+ * Memory-bounded cache of the images evaluated from map expressions, keyed
+ * by the expression identifier. Expressions sharing sub-expressions and
+ * textures reloaded after eviction don't need to decode and process their
+ * images again. Images are treated as immutable once they have been stored.
+ *
+ * When exceeding its capacity, the least recently requested images are
+ * dropped first. A capacity of 0 disables the cache.
+ *
+ * All methods are thread-safe, the cache is filled by the texture streaming workers.
+ */
+class ImageCache
+{
+private:
+    struct Entry
+    {
+        std::string identifier;
+        ImagePtr image;
+        std::size_t sizeInBytes;
+    };
+
+    mutable std::mutex _lock;
+
+    // The most recently requested image is at the front
+    std::list<Entry> _entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+
+    std::size_t _sizeInBytes;
+    std::size_t _capacity;
+
+    std::size_t _hits;
+    std::size_t _misses;
+
+public:
+    ImageCache(std::size_t capacity = 0);
+
+    // Returns the cached image with the given identifier, or an empty pointer
+    ImagePtr find(const std::string& identifier);
+
+    // Stores the image, evicting the least recently requested ones if necessary.
+    // Images larger than the capacity are not stored.
+    void insert(const std::string& identifier, const ImagePtr& image);
+
+    // Sets the memory limit in bytes, evicting images if necessary
+    void setCapacity(std::size_t capacity);
+    std::size_t getCapacity() const;
+
+    // Removes all images
+    void clear();
+
+    std::size_t getNumImages() const;
+    std::size_t getSizeInBytes() const;
+
+    std::size_t getNumHits() const;
+    std::size_t getNumMisses() const;
+
+private:
+    // Drops images from the back until the given size is reached, expects the lock to be held
+    void shrinkTo(std::size_t sizeInBytes);
+};
+
+}
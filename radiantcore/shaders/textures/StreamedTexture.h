@@ -0,0 +1,156 @@
+#pragma once
+
+#include <chrono>
+#include <Texture.h>
+#include "../MapExpression.h"
+
+namespace shaders
+{
+
+/**
+ * \brief
+ * Texture handed out by the GLTextureManager for images which are loaded in
+ * the background. It is forwarding to a shared placeholder texture until the
+ * GLTextureManager has uploaded the actual image, or after the uploaded
+ * texture has been evicted to stay within the texture memory limit.
+ */
+class StreamedTexture
+: public Texture
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    // Display name
+    std::string _name;
+
+    // The expression to evaluate when (re-)loading the image
+    MapExpressionPtr _expression;
+    BindableTexture::Role _role;
+
+    // The texture in use while the image is not resident
+    TexturePtr _placeholder;
+
+    // The uploaded image, empty while loading or after eviction
+    TexturePtr _texture;
+
+    // Estimated amount of memory occupied by the uploaded texture
+    std::size_t _sizeInBytes;
+
+    // Whether a load of the image has been queued
+    bool _loading;
+
+    // Set whenever the GL texture number is requested
+    mutable bool _used;
+    Clock::time_point _lastUsed;
+
+public:
+
+    StreamedTexture(const std::string& name, const MapExpressionPtr& expression,
+                    BindableTexture::Role role, const TexturePtr& placeholder)
+    : _name(name),
+      _expression(expression),
+      _role(role),
+      _placeholder(placeholder),
+      _sizeInBytes(0),
+      _loading(false),
+      _used(false),
+      _lastUsed(Clock::now())
+    { }
+
+    const MapExpressionPtr& getExpression() const
+    {
+        return _expression;
+    }
+
+    BindableTexture::Role getRole() const
+    {
+        return _role;
+    }
+
+    // True if the actual texture is resident
+    bool isLoaded() const
+    {
+        return _texture != nullptr;
+    }
+
+    bool isLoading() const
+    {
+        return _loading;
+    }
+
+    void setLoading(bool loading)
+    {
+        _loading = loading;
+    }
+
+    // Replaces the placeholder with the given (uploaded) texture
+    void setTexture(const TexturePtr& texture, std::size_t sizeInBytes)
+    {
+        _texture = texture;
+        _sizeInBytes = sizeInBytes;
+        _loading = false;
+        _lastUsed = Clock::now();
+    }
+
+    // Releases the uploaded texture, the placeholder is used until it is loaded again
+    void evict()
+    {
+        _texture.reset();
+        _sizeInBytes = 0;
+    }
+
+    std::size_t getSizeInBytes() const
+    {
+        return _sizeInBytes;
+    }
+
+    // Returns true if the texture has been used since the last call
+    bool checkAndResetUsage()
+    {
+        auto used = _used;
+        _used = false;
+        return used;
+    }
+
+    Clock::time_point getLastUsed() const
+    {
+        return _lastUsed;
+    }
+
+    void setLastUsed(Clock::time_point time)
+    {
+        _lastUsed = time;
+    }
+
+    /* Texture implementation */
+
+    std::string getName() const override
+    {
+        return _name;
+    }
+
+    GLuint getGLTexNum() const override
+    {
+        _used = true;
+        return getCurrent().getGLTexNum();
+    }
+
+    std::size_t getWidth() const override
+    {
+        return getCurrent().getWidth();
+    }
+
+    std::size_t getHeight() const override
+    {
+        return getCurrent().getHeight();
+    }
+
+private:
+    const Texture& getCurrent() const
+    {
+        return _texture ? *_texture : *_placeholder;
+    }
+};
+
+}
@@ -2,9 +2,9 @@
 
 #include "iundo.h"
 
-#include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace undo
 {
@@ -22,41 +22,53 @@ private:
 	class UndoableState
 	{
 	private:
-		IUndoable& _undoable;
+		IUndoable* _undoable;
 		IUndoMementoPtr _data;
 
 	public:
         UndoableState(IUndoable& undoable) :
-            _undoable(undoable),
-            _data(_undoable.exportState())
+            _undoable(&undoable),
+            _data(_undoable->exportState())
         {}
 
-        // Noncopyable
+        // Noncopyable, but movable to be stored in a vector
         UndoableState(const UndoableState& other) = delete;
         UndoableState& operator=(const UndoableState& other) = delete;
+        UndoableState(UndoableState&& other) = default;
+        UndoableState& operator=(UndoableState&& other) = default;
 
 		void restore()
 		{
-			_undoable.importState(_data);
+			_undoable->importState(_data);
 		}
 
         void notifyOperationRestored()
         {
-            _undoable.onOperationRestored();
+            _undoable->onOperationRestored();
+        }
+
+        std::size_t getMemoryUsage() const
+        {
+            return sizeof(UndoableState) + (_data ? _data->getMemoryUsage() : 0);
         }
 	};
 
-	// The Snapshot (the list of structs containing Undoable+Data)
-	std::list<UndoableState> _snapshot;
+	// The Snapshot (the list of structs containing Undoable+Data), in the order
+	// they have been recorded. A vector avoids one list node allocation per state.
+	std::vector<UndoableState> _snapshot;
 
 	// The name of the UndoOperaton
 	std::string _command;
 
+	// The bytes occupied by the recorded states
+	std::size_t _memoryUsage;
+
 public:
     using Ptr = std::shared_ptr<Operation>;
 
 	Operation(const std::string& command) :
-		_command(command)
+		_command(command),
+		_memoryUsage(0)
 	{}
 
 	const std::string& getName() const
@@ -77,22 +89,35 @@ public:
 	void save(IUndoable& undoable)
 	{
 		// Record the state of the given undable and push it to the snapshot
-		// The order is relevant, we add to the front
-		_snapshot.emplace_front(undoable);
+		_snapshot.emplace_back(undoable);
+		_memoryUsage += _snapshot.back().getMemoryUsage();
+	}
+
+	// Releases the excess capacity of the snapshot, called when the operation is complete
+	void compact()
+	{
+		_snapshot.shrink_to_fit();
+	}
+
+	// Returns the approximate number of bytes occupied by this operation
+	std::size_t getMemoryUsage() const
+	{
+		return sizeof(Operation) + _memoryUsage +
+			(_snapshot.capacity() - _snapshot.size()) * sizeof(UndoableState);
 	}
 
 	void restoreSnapshot()
 	{
-        // Walk through the snapshot front-to-back, the most recently added one is at the front
-		for (auto& state : _snapshot)
+        // Walk through the snapshot back-to-front, the most recently added one is restored first
+		for (auto state = _snapshot.rbegin(); state != _snapshot.rend(); ++state)
 		{
-            state.restore();
+            state->restore();
 		}
 
         // After all the snapshots have been restored, notify the undoables to give them a chance to cleanup
-        for (auto& state : _snapshot)
+        for (auto state = _snapshot.rbegin(); state != _snapshot.rend(); ++state)
         {
-            state.notifyOperationRestored();
+            state->notifyOperationRestored();
         }
 	}
 };
@@ -28,6 +28,9 @@ private:
 	// The pending undo operation (will be committed on finish, if not empty)
     Operation::Ptr _pending;
 
+    // The bytes occupied by the operations in the stack (excluding the pending one)
+    std::size_t _memoryUsage = 0;
+
 public:
 
 	bool empty() const
@@ -52,17 +55,26 @@ public:
 
 	void pop_front()
 	{
+		_memoryUsage -= _stack.front()->getMemoryUsage();
 		_stack.pop_front();
 	}
 
 	void pop_back()
 	{
+		_memoryUsage -= _stack.back()->getMemoryUsage();
 		_stack.pop_back();
 	}
 
 	void clear()
 	{
 		_stack.clear();
+		_memoryUsage = 0;
+	}
+
+	// Returns the approximate number of bytes occupied by the operations in this stack
+	std::size_t getMemoryUsage() const
+	{
+		return _pending ? _memoryUsage + _pending->getMemoryUsage() : _memoryUsage;
 	}
 
 	// Allocate a new Operation to work with
@@ -96,6 +108,8 @@ public:
 		
 		// Rename the last undo operation (it may be "unnamed" till now)
         _pending->setName(command);
+        _pending->compact();
+        _memoryUsage += _pending->getMemoryUsage();
 
         // Move the pending operation into its place
         _stack.emplace_back(std::move(_pending));
@@ -12,7 +12,8 @@ namespace undo
 
 UndoSystem::UndoSystem() :
 	_activeUndoStack(nullptr),
-	_undoLevels(RKEY_UNDO_QUEUE_SIZE)
+	_undoLevels(RKEY_UNDO_QUEUE_SIZE),
+	_memoryLimit(RKEY_UNDO_MEMORY_LIMIT)
 {}
 
 UndoSystem::~UndoSystem()
@@ -53,6 +54,11 @@ bool UndoSystem::operationStarted() const
 	return _activeUndoStack != nullptr;
 }
 
+std::size_t UndoSystem::getMemoryUsage() const
+{
+	return _undoStack.getMemoryUsage() + _redoStack.getMemoryUsage();
+}
+
 void UndoSystem::cancel()
 {
     if (_activeUndoStack != nullptr)
@@ -67,6 +73,7 @@ void UndoSystem::finish(const std::string& command)
 	if (finishUndo(command))
     {
 		rMessage() << command << std::endl;
+		enforceMemoryLimit();
         _eventSignal.emit(EventType::OperationRecorded, command);
 	}
 }
@@ -174,4 +181,26 @@ void UndoSystem::setActiveUndoStack(UndoStack* stack)
 	}
 }
 
+void UndoSystem::enforceMemoryLimit()
+{
+	auto limit = _memoryLimit.get() * 1024 * 1024;
+
+	if (limit == 0) return;
+
+	std::size_t numDiscarded = 0;
+
+	// The most recent operation is always kept, even if it exceeds the limit on its own
+	while (_undoStack.size() > 1 && getMemoryUsage() > limit)
+	{
+		_undoStack.pop_front();
+		++numDiscarded;
+	}
+
+	if (numDiscarded > 0)
+	{
+		rMessage() << "Undo: discarded " << numDiscarded << " operations to stay within the memory limit, " <<
+			"now using " << (getMemoryUsage() / 1024) << " kB" << std::endl;
+	}
+}
+
 } // namespace undo
@@ -16,6 +16,9 @@ namespace undo
 
 constexpr const char* const RKEY_UNDO_QUEUE_SIZE = "user/ui/undo/queueSize";
 
+// The memory limit of the undo stack in MB, 0 = unlimited
+constexpr const char* const RKEY_UNDO_MEMORY_LIMIT = "user/ui/undo/memoryLimit";
+
 /**
 * greebo: The UndoSystem (interface: iundo.h) is maintaining two internal
 * stacks of Operations (one for Undo, one for Redo), each containing a list
@@ -33,6 +36,10 @@ constexpr const char* const RKEY_UNDO_QUEUE_SIZE = "user/ui/undo/queueSize";
 *
 * The RedoStack is discarded as soon as a new Undoable Operation is recorded
 * and pushed to the UndoStack.
+*
+* Apart from the number of undo levels, the size of the UndoStack is limited
+* by a memory budget: the oldest operations are discarded as soon as the
+* recorded operations occupy more than the configured amount of memory.
 */
 class UndoSystem final :
 	public IUndoSystem
@@ -47,6 +54,7 @@ private:
 	std::map<IUndoable*, UndoStackFiller> _undoables;
 
     registry::CachedKey<std::size_t> _undoLevels;
+    registry::CachedKey<std::size_t> _memoryLimit;
 
     sigc::signal<void(EventType, const std::string&)> _eventSignal;
 
@@ -63,6 +71,8 @@ public:
 
 	bool operationStarted() const override;
 
+	std::size_t getMemoryUsage() const override;
+
 	void undo() override;
 	void redo() override;
 
@@ -79,6 +89,9 @@ private:
 
 	// Assigns the given stack to all of the Undoables listed in the map
 	void setActiveUndoStack(UndoStack* stack);
+
+	// Discards the oldest undo operations until the memory limit is met
+	void enforceMemoryLimit();
 };
 
 }
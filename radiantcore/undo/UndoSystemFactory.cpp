@@ -40,6 +40,7 @@ private:
     {
         IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Settings/Undo System"));
         page.appendSpinner(_("Undo Queue Size"), RKEY_UNDO_QUEUE_SIZE, 0, 1024, 1);
+        page.appendSpinner(_("Undo Memory Limit (MB, 0 = unlimited)"), RKEY_UNDO_MEMORY_LIMIT, 0, 65536, 1);
     }
 };
 
@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <locale>
+#include <functional>
 
 #include "iradiant.h"
 #include "idatastream.h"
@@ -60,7 +61,7 @@ void Doom3FileSystem::initDirectory(const std::string& inputPath)
         entry.archive = std::make_shared<DirectoryArchive>(path);
         entry.is_pakfile = false;
 
-        _archives.push_back(entry);
+        addArchive(std::move(entry));
     }
 
     // Instantiate a new sorting container for the filenames
@@ -139,6 +140,8 @@ void Doom3FileSystem::initialise(const SearchPaths& vfsSearchPaths, const std::s
         initDirectory(path);
     }
 
+    buildPakFileIndex();
+
     signal_Initialised().emit();
 }
 
@@ -149,6 +152,8 @@ bool Doom3FileSystem::isInitialised() const
 
 void Doom3FileSystem::shutdown()
 {
+    _pakFileIndex.clear();
+    _directoryArchives.clear();
     _archives.clear();
     _directories.clear();
     _vfsSearchPaths.clear();
@@ -168,9 +173,16 @@ int Doom3FileSystem::getFileCount(const std::string& filename)
     int count = 0;
     std::string fixedFilename(os::standardPath(filename));
 
-    for (const ArchiveDescriptor& descriptor : _archives)
+    auto indexEntry = _pakFileIndex.find(string::to_lower_copy(fixedFilename));
+
+    if (indexEntry != _pakFileIndex.end())
+    {
+        count += indexEntry->second.count;
+    }
+
+    for (auto descriptor : _directoryArchives)
     {
-        if (descriptor.archive->containsFile(fixedFilename))
+        if (descriptor->archive->containsFile(fixedFilename))
         {
             ++count;
         }
@@ -181,13 +193,8 @@ int Doom3FileSystem::getFileCount(const std::string& filename)
 
 FileInfo Doom3FileSystem::getFileInfo(const std::string& vfsRelativePath)
 {
-    for (const auto& descriptor : _archives)
+    if (auto descriptor = findArchiveContainingFile(vfsRelativePath); descriptor != nullptr)
     {
-        if (!descriptor.archive->containsFile(vfsRelativePath))
-        {
-            continue;
-        }
-
         // Determine the visibility of this file
         auto topLevelDir = os::getToplevelDirectory(vfsRelativePath);
 
@@ -201,7 +208,7 @@ FileInfo Doom3FileSystem::getFileInfo(const std::string& vfsRelativePath)
             visibility = assetsList->getVisibility(relativePath);
         }
 
-        return FileInfo("", vfsRelativePath, visibility, *descriptor.archive);
+        return FileInfo("", vfsRelativePath, visibility, *descriptor->archive);
     }
 
     return FileInfo();
@@ -215,14 +222,11 @@ ArchiveFilePtr Doom3FileSystem::openFile(const std::string& filename)
         return ArchiveFilePtr();
     }
 
-    for (const auto& descriptor : _archives)
-    {
-        auto file = descriptor.archive->openFile(filename);
+    auto descriptor = findArchiveContainingFile(filename);
 
-        if (file)
-        {
-            return file;
-        }
+    if (descriptor != nullptr)
+    {
+        return descriptor->archive->openFile(filename);
     }
 
     // not found
@@ -243,14 +247,11 @@ ArchiveFilePtr Doom3FileSystem::openFileInAbsolutePath(const std::string& filena
 
 ArchiveTextFilePtr Doom3FileSystem::openTextFile(const std::string& filename)
 {
-    for (const auto& descriptor : _archives)
-    {
-        auto file = descriptor.archive->openTextFile(filename);
+    auto descriptor = findArchiveContainingFile(filename);
 
-        if (file)
-        {
-            return file;
-        }
+    if (descriptor != nullptr)
+    {
+        return descriptor->archive->openTextFile(filename);
     }
 
     return ArchiveTextFilePtr();
@@ -340,11 +341,11 @@ void Doom3FileSystem::forEachFileInArchive(const std::string& absoluteArchivePat
 
 std::string Doom3FileSystem::findFile(const std::string& name)
 {
-    for (const auto& descriptor : _archives)
+    for (auto descriptor : _directoryArchives)
     {
-        if (!descriptor.is_pakfile && descriptor.archive->containsFile(name))
+        if (descriptor->archive->containsFile(name))
         {
-            return descriptor.name;
+            return descriptor->name;
         }
     }
 
@@ -376,7 +377,7 @@ void Doom3FileSystem::initPakFile(const std::string& filename)
         entry.name = filename;
         entry.archive = std::make_shared<archive::ZipArchive>(filename);
         entry.is_pakfile = true;
-        _archives.push_back(entry);
+        addArchive(std::move(entry));
 
         rMessage() << "[vfs] pak file: " << filename << std::endl;
     }
@@ -389,12 +390,95 @@ void Doom3FileSystem::initPakFile(const std::string& filename)
         entry.name = path;
         entry.archive = std::make_shared<DirectoryArchive>(path);
         entry.is_pakfile = false;
-        _archives.push_back(entry);
+        addArchive(std::move(entry));
 
         rMessage() << "[vfs] pak dir:  " << path << std::endl;
     }
 }
 
+void Doom3FileSystem::addArchive(ArchiveDescriptor&& descriptor)
+{
+    descriptor.priority = _archives.size();
+    _archives.emplace_back(std::move(descriptor));
+
+    if (!_archives.back().is_pakfile)
+    {
+        _directoryArchives.push_back(&_archives.back());
+    }
+}
+
+namespace
+{
+    // Invokes the functor for each file in an archive
+    class FileCollector :
+        public IArchive::Visitor
+    {
+    private:
+        std::function<void(const std::string&)> _func;
+
+    public:
+        FileCollector(const std::function<void(const std::string&)>& func) :
+            _func(func)
+        {}
+
+        void visitFile(const std::string& name, IArchiveFileInfoProvider& infoProvider) override
+        {
+            _func(name);
+        }
+
+        bool visitDirectory(const std::string& name, std::size_t depth) override
+        {
+            return false;
+        }
+    };
+}
+
+void Doom3FileSystem::buildPakFileIndex()
+{
+    ScopedDebugTimer timer("[vfs] Indexed PK4 files");
+
+    _pakFileIndex.clear();
+
+    for (const auto& descriptor : _archives)
+    {
+        if (!descriptor.is_pakfile) continue;
+
+        FileCollector collector([&](const std::string& name)
+        {
+            auto result = _pakFileIndex.emplace(string::to_lower_copy(name), PakFileIndexEntry{ &descriptor, 0 });
+
+            // The archives are visited in search order, the first one stays in the index
+            ++result.first->second.count;
+        });
+
+        descriptor.archive->traverse(collector, "");
+    }
+
+    rMessage() << "[vfs] " << _pakFileIndex.size() << " unique files in PK4 archives" << std::endl;
+}
+
+const Doom3FileSystem::ArchiveDescriptor* Doom3FileSystem::findArchiveContainingFile(const std::string& filename)
+{
+    auto indexEntry = _pakFileIndex.find(string::to_lower_copy(filename));
+    auto pakFile = indexEntry != _pakFileIndex.end() ? indexEntry->second.archive : nullptr;
+
+    // Physical directories preceding the PK4 in the search order take precedence
+    for (auto descriptor : _directoryArchives)
+    {
+        if (pakFile != nullptr && descriptor->priority > pakFile->priority)
+        {
+            break;
+        }
+
+        if (descriptor->archive->containsFile(filename))
+        {
+            return descriptor;
+        }
+    }
+
+    return pakFile;
+}
+
 sigc::signal<void>& Doom3FileSystem::signal_Initialised()
 {
     return _sigInitialised;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 #include "iarchive.h"
 #include "ifilesystem.h"
 
@@ -25,10 +26,30 @@ private:
 		std::string name;
 		IArchive::Ptr archive;
 		bool is_pakfile;
+
+		// Position in the search order, lower values take precedence
+		std::size_t priority;
 	};
 
     std::list<ArchiveDescriptor> _archives;
 
+    // The non-PK4 archives (physical directories) in search order
+    std::vector<const ArchiveDescriptor*> _directoryArchives;
+
+    // PK4 archives don't change after they have been opened, so the
+    // location of their files is indexed after initialisation. The table is
+    // keyed by the lowercase file path and refers to the PK4 taking precedence.
+    // Physical directories can change while the application is running,
+    // these are still queried for each lookup.
+    struct PakFileIndexEntry
+    {
+        const ArchiveDescriptor* archive;
+
+        // Number of PK4 archives containing this file
+        int count;
+    };
+    std::unordered_map<std::string, PakFileIndexEntry> _pakFileIndex;
+
     sigc::signal<void> _sigInitialised;
 
 public:
@@ -78,6 +99,12 @@ public:
 private:
 	void initDirectory(const std::string& path);
 	void initPakFile(const std::string& filename);
+	void addArchive(ArchiveDescriptor&& descriptor);
+
+	void buildPakFileIndex();
+
+	// Returns the archive providing the given file, or nullptr if not found
+	const ArchiveDescriptor* findArchiveContainingFile(const std::string& filename);
 
     std::shared_ptr<AssetsList> findAssetsList(const std::string& topLevelPath);
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include "iarchive.h"
+#include "os/MappedFile.h"
+#include "stream/MemoryInputStream.h"
+#include "DeflatedInputStream.h"
+
+namespace archive
+{
+
+/**
+ * An ArchiveFile located in a memory-mapped ZIP archive. Stored entries
+ * are read straight from the mapping, deflated entries are inflated from it.
+ * Each instance has its own read position, no locking is involved.
+ */
+class MappedArchiveFile :
+	public ArchiveFile
+{
+private:
+	std::string _name;
+	std::shared_ptr<os::MappedFile> _mappedFile; // keeps the mapping alive
+	stream::MemoryInputStream _substream; // the compressed or stored data of this entry
+	std::unique_ptr<DeflatedInputStream> _zipstream; // inflates data from the mapping, null for stored entries
+	std::size_t _size;
+
+public:
+	MappedArchiveFile(const std::string& name,
+					  const std::shared_ptr<os::MappedFile>& mappedFile,
+					  const StreamBase::byte_type* data, // start of the entry data within the mapping
+					  std::size_t stream_size,
+					  std::size_t file_size,
+					  bool deflated) :
+		_name(name),
+		_mappedFile(mappedFile),
+		_substream(data, stream_size),
+		_zipstream(deflated ? std::make_unique<DeflatedInputStream>(data, stream_size) : nullptr),
+		_size(file_size)
+	{}
+
+	std::size_t size() const override
+	{
+		return _size;
+	}
+
+	const std::string& getName() const override
+	{
+		return _name;
+	}
+
+	InputStream& getInputStream() override
+	{
+		if (_zipstream)
+		{
+			return *_zipstream;
+		}
+
+		return _substream;
+	}
+};
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include "iarchive.h"
+#include "gamelib.h"
+#include "os/MappedFile.h"
+#include "stream/MemoryInputStream.h"
+#include "stream/BinaryToTextInputStream.h"
+#include "DeflatedInputStream.h"
+
+namespace archive
+{
+
+/**
+ * An ArchiveTextFile located in a memory-mapped ZIP archive,
+ * see MappedArchiveFile.
+ */
+class MappedArchiveTextFile :
+	public ArchiveTextFile
+{
+private:
+	std::string _name;
+	std::shared_ptr<os::MappedFile> _mappedFile; // keeps the mapping alive
+	stream::MemoryInputStream _substream; // the compressed or stored data of this entry
+	std::unique_ptr<DeflatedInputStream> _zipstream; // inflates data from the mapping, null for stored entries
+	stream::BinaryToTextInputStream<InputStream> _textStream; // converts data from the binary stream
+
+	// Mod directory containing this file
+	std::string _modRoot;
+
+public:
+	MappedArchiveTextFile(const std::string& name,
+						  const std::shared_ptr<os::MappedFile>& mappedFile,
+						  const std::string& modRoot,
+						  const StreamBase::byte_type* data, // start of the entry data within the mapping
+						  StreamBase::size_type stream_size,
+						  bool deflated) :
+		_name(name),
+		_mappedFile(mappedFile),
+		_substream(data, stream_size),
+		_zipstream(deflated ? std::make_unique<DeflatedInputStream>(data, stream_size) : nullptr),
+		_textStream(_zipstream ? static_cast<InputStream&>(*_zipstream) : _substream),
+		_modRoot(modRoot)
+	{}
+
+	const std::string& getName() const override
+	{
+		return _name;
+	}
+
+	TextInputStream& getInputStream() override
+	{
+		return _textStream;
+	}
+
+	std::string getModName() const override
+	{
+		return game::current::getModPath(_modRoot);
+	}
+};
+
+}
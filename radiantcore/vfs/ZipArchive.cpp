@@ -14,6 +14,9 @@
 #include "DeflatedArchiveTextFile.h"
 #include "StoredArchiveFile.h"
 #include "StoredArchiveTextFile.h"
+#include "MappedArchiveFile.h"
+#include "MappedArchiveTextFile.h"
+#include "stream/MemoryInputStream.h"
 
 namespace archive
 {
@@ -32,18 +35,32 @@ public:
 ZipArchive::ZipArchive(const std::string& fullPath) :
 	_fullPath(fullPath),
 	_containingFolder(os::standardPathWithSlash(fs::path(_fullPath).remove_filename())),
-	_istream(_fullPath)
+	_mappedFile(std::make_shared<os::MappedFile>(_fullPath)),
+	_istream(_mappedFile->failed() ? _fullPath : std::string())
 {
-	if (_istream.failed())
+	if (_mappedFile->failed())
 	{
-		rError() << "Cannot open Zip file stream: " << _fullPath << std::endl;
-		return;
+		_mappedFile.reset();
+
+		if (_istream.failed())
+		{
+			rError() << "Cannot open Zip file stream: " << _fullPath << std::endl;
+			return;
+		}
 	}
 
 	try
 	{
 		// Try loading the zip file, this will throw exceptoions on any problem
-		loadZipFile();
+		if (_mappedFile)
+		{
+			stream::MemoryInputStream mappedStream(_mappedFile->data(), _mappedFile->size());
+			loadZipFile(mappedStream);
+		}
+		else
+		{
+			loadZipFile(_istream);
+		}
 	}
 	catch (ZipFailureException& ex)
 	{
@@ -64,6 +81,19 @@ ArchiveFilePtr ZipArchive::openFile(const std::string& name)
 	{
 		const std::shared_ptr<ZipRecord>& file = i->second.getRecord();
 
+		if (_mappedFile)
+		{
+			auto data = findMappedData(*file);
+
+			if (data == nullptr)
+			{
+				return ArchiveFilePtr();
+			}
+
+			return std::make_shared<MappedArchiveFile>(name, _mappedFile, data,
+				file->stream_size, file->file_size, file->mode == ZipRecord::eDeflated);
+		}
+
 		stream::FileInputStream::size_type position = 0;
 
 		{
@@ -104,6 +134,19 @@ ArchiveTextFilePtr ZipArchive::openTextFile(const std::string& name)
 	{
 		const std::shared_ptr<ZipRecord>& file = i->second.getRecord();
 
+		if (_mappedFile)
+		{
+			auto data = findMappedData(*file);
+
+			if (data == nullptr)
+			{
+				return ArchiveTextFilePtr();
+			}
+
+			return std::make_shared<MappedArchiveTextFile>(name, _mappedFile, _containingFolder, data,
+				file->stream_size, file->mode == ZipRecord::eDeflated);
+		}
+
 		// Guard against concurrent access
 		std::lock_guard<std::mutex> lock(_streamLock);
 
@@ -163,10 +206,28 @@ std::string ZipArchive::getArchivePath(const std::string& relativePath)
     return _fullPath;
 }
 
-void ZipArchive::readZipRecord()
+const StreamBase::byte_type* ZipArchive::findMappedData(const ZipRecord& record)
+{
+	// The mapping is read-only, a local stream is all it takes to parse the header
+	stream::MemoryInputStream istream(_mappedFile->data(), _mappedFile->size());
+	istream.seek(record.position);
+
+	ZipFileHeader header;
+	stream::readZipFileHeader(istream, header);
+
+	if (header.magic != ZIP_MAGIC_FILE_HEADER || istream.getRemainingSize() < record.stream_size)
+	{
+		rError() << "Error reading zip file " << _fullPath << std::endl;
+		return nullptr;
+	}
+
+	return istream.getCurrentPointer();
+}
+
+void ZipArchive::readZipRecord(SeekableInputStream& istream)
 {
 	ZipMagic magic;
-	stream::readZipMagic(_istream, magic);
+	stream::readZipMagic(istream, magic);
 
 	if (magic != ZIP_MAGIC_ROOT_DIR_ENTRY)
 	{
@@ -174,14 +235,14 @@ void ZipArchive::readZipRecord()
 	}
 
 	ZipVersion version_encoder;
-	stream::readZipVersion(_istream, version_encoder);
+	stream::readZipVersion(istream, version_encoder);
 	ZipVersion version_extract;
-	stream::readZipVersion(_istream, version_extract);
+	stream::readZipVersion(istream, version_extract);
 
 	//unsigned short flags =
-	stream::readLittleEndian<int16_t>(_istream);
+	stream::readLittleEndian<int16_t>(istream);
 	
-	uint16_t compression_mode = stream::readLittleEndian<uint16_t>(_istream);
+	uint16_t compression_mode = stream::readLittleEndian<uint16_t>(istream);
 
 	if (compression_mode != Z_DEFLATED && compression_mode != 0)
 	{
@@ -189,25 +250,25 @@ void ZipArchive::readZipRecord()
 	}
 
 	ZipDosTime dostime;
-	stream::readZipDosTime(_istream, dostime);
+	stream::readZipDosTime(istream, dostime);
 
 	//unsigned int crc32 =
-	stream::readLittleEndian<uint32_t>(_istream);
+	stream::readLittleEndian<uint32_t>(istream);
 	
-	uint32_t compressed_size = stream::readLittleEndian<uint32_t>(_istream);
-	uint32_t uncompressed_size = stream::readLittleEndian<uint32_t>(_istream);
-	uint16_t namelength = stream::readLittleEndian<uint16_t>(_istream);
-	uint16_t extras = stream::readLittleEndian<uint16_t>(_istream);
-	uint16_t comment = stream::readLittleEndian<uint16_t>(_istream);
+	uint32_t compressed_size = stream::readLittleEndian<uint32_t>(istream);
+	uint32_t uncompressed_size = stream::readLittleEndian<uint32_t>(istream);
+	uint16_t namelength = stream::readLittleEndian<uint16_t>(istream);
+	uint16_t extras = stream::readLittleEndian<uint16_t>(istream);
+	uint16_t comment = stream::readLittleEndian<uint16_t>(istream);
 
 	//unsigned short diskstart =
-	stream::readLittleEndian<uint16_t>(_istream);
+	stream::readLittleEndian<uint16_t>(istream);
 	//unsigned short filetype =
-	stream::readLittleEndian<uint16_t>(_istream);
+	stream::readLittleEndian<uint16_t>(istream);
 	//unsigned int filemode =
-	stream::readLittleEndian<uint32_t>(_istream);
+	stream::readLittleEndian<uint32_t>(istream);
 
-	uint32_t position = stream::readLittleEndian<uint32_t>(_istream);
+	uint32_t position = stream::readLittleEndian<uint32_t>(istream);
 
 	// greebo: Read the filename directly into a newly constructed std::string.
 
@@ -218,11 +279,11 @@ void ZipArchive::readZipRecord()
 
 	std::string path(namelength, '\0');
 
-	_istream.read(
-		reinterpret_cast<stream::FileInputStream::byte_type*>(const_cast<char*>(path.data())),
+	istream.read(
+		reinterpret_cast<StreamBase::byte_type*>(const_cast<char*>(path.data())),
 		namelength);
 
-	_istream.seek(extras + comment, stream::FileInputStream::cur);
+	istream.seek(extras + comment, SeekableInputStream::cur);
 
 	if (os::isDirectory(path))
 	{
@@ -246,30 +307,30 @@ void ZipArchive::readZipRecord()
 	}
 }
 
-void ZipArchive::loadZipFile()
+void ZipArchive::loadZipFile(SeekableInputStream& istream)
 {
-	SeekableStream::position_type pos = findZipDiskTrailerPosition(_istream);
+	SeekableStream::position_type pos = findZipDiskTrailerPosition(istream);
 
 	if (pos == 0)
 	{
 		throw ZipFailureException("Unable to locate Zip disk trailer");
 	}
 
-	_istream.seek(pos);
+	istream.seek(pos);
 
 	ZipDiskTrailer trailer;
-	stream::readZipDiskTrailer(_istream, trailer);
+	stream::readZipDiskTrailer(istream, trailer);
 
 	if (trailer.magic != ZIP_MAGIC_DISK_TRAILER)
 	{
 		throw ZipFailureException("Invalid Zip Magic, maybe this is not a zip file?");
 	}
 
-	_istream.seek(trailer.rootseek);
+	istream.seek(trailer.rootseek);
 
 	for (unsigned short i = 0; i < trailer.entries; ++i)
 	{
-		readZipRecord();
+		readZipRecord(istream);
 	}
 }
 
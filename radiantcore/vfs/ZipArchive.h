@@ -3,6 +3,8 @@
 #include "iarchive.h"
 #include "GenericFileSystem.h"
 #include "stream/FileInputStream.h"
+#include "os/MappedFile.h"
+#include <memory>
 #include <mutex>
 
 namespace archive
@@ -16,6 +18,11 @@ namespace archive
  * physical directories.
  *
  * Archives are owned and instantiated by the GlobalFileSystem instance.
+ *
+ * The archive file is memory-mapped if possible, files opened from a mapped
+ * archive read their data straight from the mapping, without locking or
+ * re-opening the archive. If the mapping fails, the archive falls back
+ * to reading through a shared, mutex-protected file stream.
  */
 class ZipArchive final :
 	public IArchive
@@ -51,6 +58,11 @@ private:
 	std::string _fullPath;			// the full path to the Zip file
 	std::string _containingFolder;  // the folder this Zip is located in
 	mutable std::string _modName;	// mod name, calculated based on the containing folder
+
+	// The read-only mapping of the archive, null if the file couldn't be mapped
+	std::shared_ptr<os::MappedFile> _mappedFile;
+
+	// Fallback stream, only opened if the mapping failed
 	stream::FileInputStream _istream;
     std::mutex _streamLock;
 
@@ -69,8 +81,11 @@ public:
     std::string getArchivePath(const std::string& relativePath) override;
 
 private:
-	void readZipRecord();
-	void loadZipFile();
+	void readZipRecord(SeekableInputStream& istream);
+	void loadZipFile(SeekableInputStream& istream);
+
+	// Returns the start of the record's data in the mapped file, or nullptr on failure
+	const StreamBase::byte_type* findMappedData(const ZipRecord& record);
 };
 
 }
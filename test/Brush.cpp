@@ -12,6 +12,8 @@
 #include "math/Vector3.h"
 #include "os/path.h"
 #include "testutil/FileSelectionHelper.h"
+#include "time/StopWatch.h"
+#include "util/ParallelFor.h"
 
 namespace test
 {
@@ -443,4 +445,178 @@ TEST_F(BrushTest, LoadBrushWithDuplicatePlanes)
     }
 }
 
+namespace
+{
+
+// Creates an n-sided prism around the z axis, the side faces are tangent to the given radius
+scene::INodePtr createPrismBrush(const scene::INodePtr& parent, const Vector3& origin, std::size_t sides, double radius)
+{
+    auto brushNode = GlobalBrushCreator().createBrush();
+    parent->addChildNode(brushNode);
+
+    auto brush = Node_getIBrush(brushNode);
+
+    for (std::size_t i = 0; i < sides; ++i)
+    {
+        auto angle = 2 * math::PI * i / sides;
+        Vector3 normal(cos(angle), sin(angle), 0);
+
+        brush->addFace(Plane3(normal, normal.dot(origin) + radius), Matrix3::getIdentity(), "textures/numbers/1");
+    }
+
+    brush->addFace(Plane3(0, 0, 1, origin.z() + 32), Matrix3::getIdentity(), "textures/numbers/1");
+    brush->addFace(Plane3(0, 0, -1, -origin.z() + 32), Matrix3::getIdentity(), "textures/numbers/1");
+
+    brush->evaluateBRep();
+
+    return brushNode;
+}
+
+}
+
+TEST_F(BrushTest, PrismWithManySidesHasCompleteWindings)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    // More sides than the pre-allocated winding size
+    constexpr std::size_t Sides = 100;
+    constexpr double Radius = 256;
+
+    Vector3 origin(64, -128, 16);
+    auto brush = Node_getIBrush(createPrismBrush(worldspawn, origin, Sides, Radius));
+
+    EXPECT_TRUE(brush->hasContributingFaces());
+    ASSERT_EQ(brush->getNumFaces(), Sides + 2);
+
+    // The corners lie on the circumscribed circle
+    auto cornerRadius = Radius / cos(math::PI / Sides);
+
+    for (std::size_t i = 0; i < Sides; ++i)
+    {
+        const auto& winding = brush->getFace(i).getWinding();
+        EXPECT_EQ(winding.size(), 4) << "Side face " << i << " should be a quad";
+    }
+
+    for (auto cap : { Sides, Sides + 1 })
+    {
+        const auto& winding = brush->getFace(cap).getWinding();
+        EXPECT_EQ(winding.size(), Sides) << "Cap face should have a vertex per side";
+
+        for (const auto& vertex : winding)
+        {
+            auto offset = vertex.vertex - origin;
+            EXPECT_NEAR(sqrt(offset.x() * offset.x() + offset.y() * offset.y()), cornerRadius, 0.01);
+            EXPECT_NEAR(std::abs(offset.z()), 32, 0.01);
+        }
+    }
+}
+
+// Measures the winding construction rate on a large number of brushes
+TEST_F(BrushTest, WindingConstructionBenchmark)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<scene::INodePtr> brushes;
+    std::size_t numFaces = 0;
+
+    // A mix of cuboids, 16-sided and 64-sided prisms
+    for (std::size_t i = 0; i < 3000; ++i)
+    {
+        Vector3 origin(static_cast<double>(i % 50) * 512, static_cast<double>(i / 50) * 512, 0);
+
+        brushes.push_back(i % 3 == 0 ? algorithm::createCubicBrush(worldspawn, origin, "textures/numbers/1") :
+            createPrismBrush(worldspawn, origin, i % 3 == 1 ? 16 : 64, 128));
+
+        numFaces += Node_getIBrush(brushes.back())->getNumFaces();
+    }
+
+    constexpr std::size_t NumPasses = 5;
+    util::StopWatch timer;
+
+    for (std::size_t pass = 0; pass < NumPasses; ++pass)
+    {
+        for (const auto& node : brushes)
+        {
+            auto brush = Node_getIBrush(node);
+
+            // Mark the planes as changed, then rebuild all windings
+            brush->getFace(0).transform(Matrix4::getIdentity());
+            brush->evaluateBRep();
+        }
+    }
+
+    auto milliSeconds = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+    auto numWindings = numFaces * NumPasses;
+
+    rMessage() << "Built " << numWindings << " windings of " << brushes.size() << " brushes in " << milliSeconds <<
+        " ms (" << (numWindings * 1000 / milliSeconds) << " windings per second)" << std::endl;
+
+    for (const auto& node : brushes)
+    {
+        EXPECT_TRUE(Node_getIBrush(node)->hasContributingFaces());
+    }
+}
+
+TEST_F(BrushTest, ConcurrentlyPreparedWindingsMatchSequentialOnes)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<scene::INodePtr> brushes;
+
+    for (std::size_t i = 0; i < 200; ++i)
+    {
+        brushes.push_back(createPrismBrush(worldspawn, Vector3(static_cast<double>(i) * 300, 0, 0), 3 + i % 40, 128));
+    }
+
+    // Remember the windings and bounds built on this thread
+    std::vector<std::vector<IWinding>> expectedWindings;
+    std::vector<AABB> expectedBounds;
+
+    for (const auto& node : brushes)
+    {
+        auto& windings = expectedWindings.emplace_back();
+        auto brush = Node_getIBrush(node);
+
+        expectedBounds.push_back(node->localAABB());
+
+        for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+        {
+            windings.push_back(brush->getFace(i).getWinding());
+        }
+
+        // Invalidate the windings without changing the geometry
+        brush->getFace(0).transform(Matrix4::getIdentity());
+    }
+
+    util::parallelFor(brushes.size(), [&](std::size_t index)
+    {
+        Node_getIBrush(brushes[index])->prepareBRep();
+    });
+
+    for (std::size_t b = 0; b < brushes.size(); ++b)
+    {
+        auto brush = Node_getIBrush(brushes[b]);
+        brush->evaluateBRep();
+
+        ASSERT_EQ(brush->getNumFaces(), expectedWindings[b].size());
+
+        for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+        {
+            const auto& winding = brush->getFace(i).getWinding();
+            const auto& expected = expectedWindings[b][i];
+
+            ASSERT_EQ(winding.size(), expected.size()) << "Brush " << b << ", face " << i;
+
+            for (std::size_t v = 0; v < winding.size(); ++v)
+            {
+                EXPECT_EQ(winding[v].vertex, expected[v].vertex) << "Brush " << b << ", face " << i;
+                EXPECT_EQ(winding[v].texcoord, expected[v].texcoord) << "Brush " << b << ", face " << i;
+                EXPECT_EQ(winding[v].adjacent, expected[v].adjacent) << "Brush " << b << ", face " << i;
+            }
+        }
+
+        EXPECT_EQ(brushes[b]->localAABB(), expectedBounds[b]) << "Brush " << b;
+    }
+}
+
 }
@@ -1,7 +1,11 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <numeric>
+#include <random>
 #include "render/ContinuousBuffer.h"
 #include "testutil/TestBufferObjectProvider.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -650,4 +654,111 @@ TEST(ContinuousBufferTest, SyncToBufferAfterApplyingTransaction)
     EXPECT_TRUE(checkDataInBufferObject(buffer, handle2, *bufferObject, eight)) << "Data sync unsuccessful";
 }
 
+
+// Allocates and releases lots of slots of varying sizes (including empty ones) in random order,
+// the slots must never overlap and released space must be merged again
+TEST(ContinuousBufferTest, AllocationChurn)
+{
+    constexpr std::size_t NumSlots = 100000;
+    constexpr std::size_t NumRounds = 20;
+
+    // Empty slots share their offset with their neighbours, they must not collide in the free slot index
+    {
+        render::ContinuousBuffer<int> buffer(16);
+
+        auto first = buffer.allocate(0);
+        auto second = buffer.allocate(0);
+        auto third = buffer.allocate(0);
+        auto occupied = buffer.allocate(4);
+
+        buffer.deallocate(first);
+        buffer.deallocate(third);
+
+        // Both released slots need to be re-used before the larger free slot is cut
+        auto reused1 = buffer.allocate(0);
+        auto reused2 = buffer.allocate(0);
+        EXPECT_TRUE((reused1 == first && reused2 == third) || (reused1 == third && reused2 == first)) << "Empty free slot got lost";
+
+        buffer.deallocate(reused1);
+        buffer.deallocate(second);
+        buffer.deallocate(reused2);
+        buffer.deallocate(occupied);
+
+        EXPECT_EQ(buffer.getNumAllocatedElements(), 0);
+        EXPECT_EQ(buffer.getOffset(buffer.allocate(16)), 0) << "Free slots have not been merged";
+    }
+
+    std::minstd_rand random(42);
+    std::uniform_int_distribution<std::size_t> sizeDistribution(0, 64);
+
+    render::ContinuousBuffer<int> buffer;
+    std::vector<render::ContinuousBuffer<int>::Handle> handles(NumSlots);
+    std::vector<std::size_t> sizes(NumSlots);
+
+    util::StopWatch timer;
+
+    for (std::size_t i = 0; i < NumSlots; ++i)
+    {
+        sizes[i] = sizeDistribution(random);
+        handles[i] = buffer.allocate(sizes[i]);
+    }
+
+    auto initialAllocationTime = timer.getMilliSecondsPassed();
+    timer.restart();
+
+    // In each round release half of the slots in random order and allocate new ones with different sizes
+    std::vector<std::size_t> indices(NumSlots);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    for (std::size_t round = 0; round < NumRounds; ++round)
+    {
+        std::shuffle(indices.begin(), indices.end(), random);
+
+        for (std::size_t i = 0; i < NumSlots / 2; ++i)
+        {
+            buffer.deallocate(handles[indices[i]]);
+        }
+
+        for (std::size_t i = 0; i < NumSlots / 2; ++i)
+        {
+            sizes[indices[i]] = sizeDistribution(random);
+            handles[indices[i]] = buffer.allocate(sizes[indices[i]]);
+        }
+    }
+
+    auto churnTime = timer.getMilliSecondsPassed();
+
+    // Check the allocations, every slot must have the requested size and none of them may overlap
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+
+    for (std::size_t i = 0; i < NumSlots; ++i)
+    {
+        EXPECT_EQ(buffer.getSize(handles[i]), sizes[i]);
+        ranges.emplace_back(buffer.getOffset(handles[i]), buffer.getSize(handles[i]));
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+
+    for (std::size_t i = 1; i < ranges.size(); ++i)
+    {
+        ASSERT_LE(ranges[i - 1].first + ranges[i - 1].second, ranges[i].first) << "Slots are overlapping";
+    }
+
+    EXPECT_EQ(buffer.getNumAllocatedElements(), std::accumulate(sizes.begin(), sizes.end(), std::size_t(0)));
+
+    // After releasing everything, the whole buffer is one free block again
+    for (auto handle : handles)
+    {
+        buffer.deallocate(handle);
+    }
+
+    EXPECT_EQ(buffer.getNumAllocatedElements(), 0);
+
+    auto handle = buffer.allocate(NumSlots * 32);
+    EXPECT_EQ(buffer.getOffset(handle), 0) << "Free blocks have not been merged";
+
+    rMessage() << "Allocated " << NumSlots << " slots in " << initialAllocationTime << " ms, " << NumRounds
+        << " rounds of releasing and re-allocating half of them took " << churnTime << " ms" << std::endl;
+}
+
 }
@@ -9,6 +9,9 @@
 #include "os/path.h"
 #include "parser/DefBlockSyntaxParser.h"
 #include "string/case_conv.h"
+#include "fmt/format.h"
+#include "registry/registry.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -1755,4 +1758,170 @@ TEST_F(DeclManagerTest, AssigningSyntaxBlockOverridesModification)
     EXPECT_EQ(decl->getKeyValue("description"), "assigned") << "Assigned syntax block didn't take effect";
 }
 
+// Many files defining the same decl, parsed concurrently, the first file in sorted order has to win
+TEST_F(DeclManagerTest, ConcurrentlyParsedFilesAreMergedInOrder)
+{
+    constexpr std::size_t NumFiles = 64;
+    std::vector<std::unique_ptr<TemporaryFile>> tempFiles;
+
+    for (std::size_t i = 0; i < NumFiles; ++i)
+    {
+        auto& file = tempFiles.emplace_back(std::make_unique<TemporaryFile>(
+            _context.getTestProjectPath() + fmt::format("testdecls/parallel_{0:02d}.decl", i)));
+
+        std::string contents;
+
+        // Pad the files to make the parse durations differ
+        for (std::size_t line = 0; line < (i % 7) * 200; ++line)
+        {
+            contents += fmt::format("testdecl decl/parallel/{0}/padding{1} {{ diffusemap textures/padding }}\n", i, line);
+        }
+
+        contents += fmt::format("testdecl decl/parallel/shared {{ diffusemap textures/parallel/{0:02d} }}\n", i);
+        contents += fmt::format("testdecl decl/parallel/{0} {{ diffusemap textures/parallel/{0} }}\n", i);
+
+        file->setContents(contents);
+    }
+
+    util::StopWatch timer;
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    expectDeclContains(decl::Type::TestDecl, "decl/parallel/shared", "textures/parallel/00");
+
+    rMessage() << "Parsing " << NumFiles << " decl files took " << timer.getMilliSecondsPassed() << " ms" << std::endl;
+
+    for (std::size_t i = 0; i < NumFiles; ++i)
+    {
+        expectDeclIsPresent(decl::Type::TestDecl, fmt::format("decl/parallel/{0}", i));
+    }
+
+    // The order needs to be stable across reloads
+    GlobalDeclarationManager().reloadDeclarations();
+
+    expectDeclContains(decl::Type::TestDecl, "decl/parallel/shared", "textures/parallel/00");
+}
+
+namespace
+{
+
+// Returns all decls of the given type mapped to their block contents
+std::map<std::string, std::string> getDeclContents(decl::Type type)
+{
+    std::map<std::string, std::string> result;
+
+    GlobalDeclarationManager().foreachDeclaration(type, [&](const decl::IDeclaration::Ptr& decl)
+    {
+        result.emplace(decl->getDeclName(), decl->getBlockSyntax().contents);
+    });
+
+    return result;
+}
+
+}
+
+TEST_F(DeclManagerTest, ParseCacheFileIsCreated)
+{
+    fs::path cacheFolder = _context.getCacheDataPath() + "declcache/";
+    fs::remove_all(cacheFolder);
+
+    registry::setValue(decl::RKEY_DECL_PARSE_CACHE, true);
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    expectDeclIsPresent(decl::Type::TestDecl, "decl/numbers/1");
+
+    EXPECT_TRUE(fs::exists(cacheFolder / "testdecls_decl.cache")) << "Parse cache file has not been written";
+}
+
+TEST_F(DeclManagerTest, ParseCacheDisabled)
+{
+    fs::path cacheFolder = _context.getCacheDataPath() + "declcache/";
+    fs::remove_all(cacheFolder);
+
+    registry::setValue(decl::RKEY_DECL_PARSE_CACHE, false);
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    expectDeclIsPresent(decl::Type::TestDecl, "decl/numbers/1");
+
+    EXPECT_FALSE(fs::exists(cacheFolder / "testdecls_decl.cache")) << "Parse cache file should not have been written";
+}
+
+TEST_F(DeclManagerTest, ParseCacheProducesIdenticalDecls)
+{
+    fs::remove_all(_context.getCacheDataPath() + "declcache/");
+    registry::setValue(decl::RKEY_DECL_PARSE_CACHE, true);
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    // The first run has been filling the cache, the reload will use it
+    auto parsedDecls = getDeclContents(decl::Type::TestDecl);
+    auto parsedMaterials = getDeclContents(decl::Type::Material);
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_FALSE(parsedDecls.empty());
+    EXPECT_EQ(getDeclContents(decl::Type::TestDecl), parsedDecls) << "Cached decls differ from the parsed ones";
+    EXPECT_EQ(getDeclContents(decl::Type::Material), parsedMaterials) << "Cached materials differ from the parsed ones";
+}
+
+TEST_F(DeclManagerTest, ParseCacheDetectsChangedFile)
+{
+    fs::remove_all(_context.getCacheDataPath() + "declcache/");
+    registry::setValue(decl::RKEY_DECL_PARSE_CACHE, true);
+
+    TemporaryFile tempFile(_context.getTestProjectPath() + "testdecls/temp_file.decl");
+    tempFile.setContents(R"(
+testdecl decl/temporary/11 { diffusemap textures/temporary/11 }
+)");
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    expectDeclContains(decl::Type::TestDecl, "decl/temporary/11", "diffusemap textures/temporary/11");
+
+    // Same file size, different contents, this must not be served from the cache
+    tempFile.setContents(R"(
+testdecl decl/temporary/11 { diffusemap textures/temporary/22 }
+)");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    expectDeclContains(decl::Type::TestDecl, "decl/temporary/11", "diffusemap textures/temporary/22");
+}
+
+TEST_F(DeclManagerTest, ParseCacheColdVersusWarmReload)
+{
+    registry::setValue(decl::RKEY_DECL_PARSE_CACHE, true);
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    expectDeclIsPresent(decl::Type::TestDecl, "decl/numbers/1");
+
+    // Cold: all files need to be tokenised
+    fs::remove_all(_context.getCacheDataPath() + "declcache/");
+
+    util::StopWatch coldTimer;
+    GlobalDeclarationManager().reloadDeclarations();
+    auto coldTime = coldTimer.getMilliSecondsPassed();
+
+    auto coldMaterials = getDeclContents(decl::Type::Material);
+
+    // Warm: every file should be taken from the cache
+    util::StopWatch warmTimer;
+    GlobalDeclarationManager().reloadDeclarations();
+    auto warmTime = warmTimer.getMilliSecondsPassed();
+
+    rMessage() << "Reloading decls took " << coldTime << " ms without and "
+        << warmTime << " ms with a populated parse cache" << std::endl;
+
+    EXPECT_EQ(getDeclContents(decl::Type::Material), coldMaterials);
+}
+
 }
@@ -1,6 +1,10 @@
 #include "gtest/gtest.h"
 
+#include <cstdlib>
+#include <sstream>
+#include "itextstream.h"
 #include "parser/DefTokeniser.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -128,4 +132,147 @@ TEST(DefTokeniser, EmptyQuotesAtEndOfBlock)
     EXPECT_EQ(keyValuePairs["mins"], "-1 -1 -3");
 }
 
+inline std::vector<std::string> getAllTokens(parser::DefTokeniser& tokeniser)
+{
+    std::vector<std::string> tokens;
+
+    while (tokeniser.hasMoreTokens())
+    {
+        tokens.emplace_back(tokeniser.nextToken());
+    }
+
+    return tokens;
+}
+
+TEST(DefTokeniser, StringViewTokeniserMatchesStreamTokeniser)
+{
+    std::vector<std::string> testStrings =
+    {
+        "",
+        " \t\r\n",
+        R"("inherit" "atdm:mover_handle_base")",
+        R"( "inherit"	"atdm:" \
+    "mover_handle_base")",
+        R"("escaped \"quote\" and\ttab\n" "back\slash")",
+        R"(brushDef3 { ( 0 0 1 -604 ) ( ( 0.015625 0 255.9375 ) ( 0 0.015625 0 ) ) "textures/a" 0 0 0 })",
+        "key // comment until the end of the line\nvalue",
+        "token/*delimited*/next /* unterminated",
+        "a/b/c //\r\n/ / x/",
+        R"(abc"def"ghi "" "unterminated)",
+        "{}(),kept,delimiters",
+        R"("continued" \ )",
+    };
+
+    for (const auto& testString : testStrings)
+    {
+        std::istringstream stream(testString);
+        parser::BasicDefTokeniser<std::istream> streamTokeniser(stream);
+        parser::BasicDefTokeniser<std::string_view> viewTokeniser(testString);
+
+        EXPECT_EQ(getAllTokens(viewTokeniser), getAllTokens(streamTokeniser)) << "Token mismatch in " << testString;
+    }
+}
+
+TEST(DefTokeniser, StringViewTokensPointIntoBuffer)
+{
+    std::string testString = R"(key "quoted value" ( 1 2 3 ))";
+    parser::BasicDefTokeniser<std::string_view> tokeniser(testString);
+
+    auto bufferStart = testString.data();
+    auto bufferEnd = bufferStart + testString.size();
+
+    while (tokeniser.hasMoreTokens())
+    {
+        auto token = tokeniser.nextTokenView();
+
+        EXPECT_TRUE(token.data() >= bufferStart && token.data() + token.size() <= bufferEnd)
+            << "Token " << token << " has been copied";
+    }
+}
+
+TEST(DefTokeniser, StringViewTokenSurvivesLookahead)
+{
+    // Both tokens need to be materialised, the first one must still be valid after fetching the second
+    std::string testString = R"("first\ttoken" "second\ttoken")";
+    parser::BasicDefTokeniser<std::string_view> tokeniser(testString);
+
+    auto first = tokeniser.nextTokenView();
+    EXPECT_EQ(first, "first\ttoken");
+    EXPECT_EQ(tokeniser.peek(), "second\ttoken");
+    EXPECT_EQ(first, "first\ttoken");
+
+    EXPECT_EQ(tokeniser.nextTokenView(), "second\ttoken");
+    EXPECT_FALSE(tokeniser.hasMoreTokens());
+}
+
+TEST(DefTokeniser, NumericTokens)
+{
+    std::string testString = "0.015625 -604 +3 1e5 -2.220446049250313e-16 nonsense 134217728 -1 text";
+
+    std::istringstream stream(testString);
+    parser::BasicDefTokeniser<std::istream> streamTokeniser(stream);
+    parser::BasicDefTokeniser<std::string_view> viewTokeniser(testString);
+
+    for (auto* tokeniser : std::initializer_list<parser::DefTokeniser*>{ &streamTokeniser, &viewTokeniser })
+    {
+        EXPECT_EQ(tokeniser->nextDouble(), 0.015625);
+        EXPECT_EQ(tokeniser->nextDouble(), -604);
+        EXPECT_EQ(tokeniser->nextDouble(), 3);
+        EXPECT_EQ(tokeniser->nextDouble(), 1e5);
+        EXPECT_EQ(tokeniser->nextDouble(), -2.220446049250313e-16);
+        EXPECT_EQ(tokeniser->nextDouble(), 0) << "Non-numeric tokens should be converted to 0";
+        EXPECT_EQ(tokeniser->nextUnsigned(), 134217728);
+        EXPECT_EQ(tokeniser->nextUnsigned(5), 5) << "Expected the default value for negative numbers";
+        EXPECT_EQ(tokeniser->nextUnsigned(7), 7) << "Expected the default value for non-numeric tokens";
+    }
+}
+
+// Compares the throughput of the std::istream and the buffer-based tokeniser on brushDef3 text
+TEST(DefTokeniser, BrushDef3Throughput)
+{
+    std::string text;
+
+    for (int i = 0; i < 40000; ++i)
+    {
+        text += "( 0 0 1 -" + std::to_string(i) + " ) ( ( 0.0078125 -2.220446049250313e-16 0.5 ) "
+            "( -4.432218481120742e-16 0.0078125 62.75 ) ) \"textures/numbers/" + std::to_string(i % 10) + "\" 0 0 0\n";
+    }
+
+    auto megaBytes = text.size() / (1024.0 * 1024.0);
+
+    util::StopWatch timer;
+    std::istringstream stream(text);
+    parser::BasicDefTokeniser<std::istream> streamTokeniser(stream);
+
+    double streamSum = 0;
+
+    while (streamTokeniser.hasMoreTokens())
+    {
+        streamTokeniser.assertNextToken("(");
+        for (int n = 0; n < 4; ++n) streamSum += std::atof(streamTokeniser.nextToken().c_str());
+        streamTokeniser.skipTokens(17);
+    }
+
+    auto streamTime = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+    timer.restart();
+
+    parser::BasicDefTokeniser<std::string_view> viewTokeniser(text);
+
+    double viewSum = 0;
+
+    while (viewTokeniser.hasMoreTokens())
+    {
+        viewTokeniser.assertNextToken("(");
+        for (int n = 0; n < 4; ++n) viewSum += viewTokeniser.nextDouble();
+        viewTokeniser.skipTokens(17);
+    }
+
+    auto viewTime = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+
+    EXPECT_EQ(streamSum, viewSum);
+
+    rMessage() << "Tokenising " << megaBytes << " MB of brushDef3 faces: std::istream " <<
+        megaBytes * 1000 / streamTime << " MB/s, std::string_view " << megaBytes * 1000 / viewTime << " MB/s" << std::endl;
+}
+
 }
@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <numeric>
 #include <random>
@@ -414,6 +416,238 @@ TEST(GeometryStore, SyncObjectAcquisition)
         "GeometryStore should have performed 5 frame buffer switches";
 }
 
+TEST(GeometryStore, FrameBufferRing)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
+
+    std::vector<render::IBufferObject::Ptr> vertexBuffers;
+    std::vector<render::IBufferObject::Ptr> indexBuffers;
+
+    for (std::size_t i = 0; i < render::GeometryStore::NumFrameBuffers; ++i)
+    {
+        store.onFrameStart();
+        auto buffers = store.getBufferObjects();
+
+        EXPECT_EQ(std::find(vertexBuffers.begin(), vertexBuffers.end(), buffers.first), vertexBuffers.end()) <<
+            "Each frame buffer should have its own vertex buffer object";
+        EXPECT_EQ(std::find(indexBuffers.begin(), indexBuffers.end(), buffers.second), indexBuffers.end()) <<
+            "Each frame buffer should have its own index buffer object";
+
+        vertexBuffers.push_back(buffers.first);
+        indexBuffers.push_back(buffers.second);
+        store.onFrameFinished();
+    }
+
+    // The next frames should cycle through the same buffers again
+    for (std::size_t i = 0; i < render::GeometryStore::NumFrameBuffers; ++i)
+    {
+        store.onFrameStart();
+        EXPECT_EQ(store.getBufferObjects().first, vertexBuffers.at(i)) << "Unexpected vertex buffer in frame " << i;
+        EXPECT_EQ(store.getBufferObjects().second, indexBuffers.at(i)) << "Unexpected index buffer in frame " << i;
+        store.onFrameFinished();
+    }
+}
+
+TEST(GeometryStore, FrameBufferWaitsForItsFence)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
+
+    std::vector<std::shared_ptr<TestSyncObject>> fences;
+
+    for (std::size_t frame = 0; frame < 4 * render::GeometryStore::NumFrameBuffers; ++frame)
+    {
+        store.onFrameStart();
+
+        // Only the fence of the frame that used this buffer before should have been waited for
+        for (std::size_t i = 0; i < fences.size(); ++i)
+        {
+            auto expectedWaitCount = i + render::GeometryStore::NumFrameBuffers <= frame ? 1 : 0;
+            EXPECT_EQ(fences[i]->waitCount, expectedWaitCount) << "Fence of frame " << i << " in frame " << frame;
+        }
+
+        store.onFrameFinished();
+        fences.push_back(TestSyncObjectProvider::Instance().lastCreatedSyncObject);
+    }
+}
+
+namespace
+{
+
+// Checks the data uploaded to the buffer objects of the current frame against the expectations
+inline void verifyBufferObjects(render::GeometryStore& store, const std::vector<Allocation>& allocations)
+{
+    auto buffers = store.getBufferObjects();
+    auto vertexBuffer = std::static_pointer_cast<TestBufferObject>(buffers.first);
+    auto indexBuffer = std::static_pointer_cast<TestBufferObject>(buffers.second);
+
+    for (const auto& allocation : allocations)
+    {
+        auto renderParms = store.getBufferAddresses(allocation.slot);
+
+        // The first index pointer is an offset into the bound index buffer
+        auto firstIndex = reinterpret_cast<std::uintptr_t>(renderParms.firstIndex) / sizeof(unsigned int);
+
+        ASSERT_LE((firstIndex + allocation.indices.size()) * sizeof(unsigned int), indexBuffer->buffer.size()) <<
+            "Index buffer object too small";
+        ASSERT_LE((renderParms.firstVertex + allocation.vertices.size()) * sizeof(render::RenderVertex), vertexBuffer->buffer.size()) <<
+            "Vertex buffer object too small";
+
+        for (std::size_t i = 0; i < allocation.indices.size(); ++i)
+        {
+            unsigned int index;
+            std::memcpy(&index, indexBuffer->buffer.data() + (firstIndex + i) * sizeof(unsigned int), sizeof(index));
+            EXPECT_EQ(index, allocation.indices[i]) << "Index buffer object out of sync";
+        }
+
+        for (std::size_t i = 0; i < allocation.vertices.size(); ++i)
+        {
+            render::RenderVertex vertex;
+            std::memcpy(&vertex, vertexBuffer->buffer.data() + (renderParms.firstVertex + i) * sizeof(render::RenderVertex), sizeof(vertex));
+            EXPECT_TRUE(math::isNear(vertex.vertex, allocation.vertices[i].vertex, 0.01)) << "Vertex buffer object out of sync";
+        }
+    }
+}
+
+}
+
+TEST(GeometryStore, BufferObjectsFollowModifications)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
+
+    std::vector<Allocation> allocations;
+    std::minstd_rand rand(23); // fixed seed
+
+    store.onFrameStart();
+
+    for (auto i = 0; i < 20; ++i)
+    {
+        auto vertices = generateVertices(i, 10 + rand() % 50);
+        auto indices = generateIndices(vertices);
+
+        auto slot = store.allocateSlot(vertices.size(), indices.size());
+        store.updateData(slot, vertices, indices);
+
+        allocations.emplace_back(Allocation{ slot, vertices, indices });
+    }
+
+    store.syncToBufferObjects();
+    verifyBufferObjects(store, allocations);
+    store.onFrameFinished();
+
+    for (auto frame = 0; frame < 50; ++frame)
+    {
+        store.onFrameStart();
+
+        for (auto a = 0; a < allocations.size(); ++a)
+        {
+            auto& allocation = allocations[a];
+
+            switch (rand() % 5)
+            {
+            case 1: // updateSubData
+            {
+                auto newVertices = generateVertices(rand() % 9, allocation.vertices.size() >> 1);
+                std::copy(newVertices.begin(), newVertices.end(), allocation.vertices.begin());
+
+                store.updateSubData(allocation.slot, 0, newVertices, 0, { allocation.indices.front() });
+                break;
+            }
+
+            case 2: // shrink and update
+            {
+                // Don't touch vertices below a minimum size
+                if (allocation.vertices.size() < 10) break;
+
+                allocation.vertices = generateVertices(rand() % 9, allocation.vertices.size() - rand() % 5);
+                allocation.indices = generateIndices(allocation.vertices);
+
+                store.resizeData(allocation.slot, allocation.vertices.size(), allocation.indices.size());
+                store.updateData(allocation.slot, allocation.vertices, allocation.indices);
+                break;
+            }
+
+            case 3: // re-allocation
+            {
+                store.deallocateSlot(allocation.slot);
+
+                allocation.vertices = generateVertices(rand() % 9, 10 + rand() % 50);
+                allocation.indices = generateIndices(allocation.vertices);
+                allocation.slot = store.allocateSlot(allocation.vertices.size(), allocation.indices.size());
+
+                store.updateData(allocation.slot, allocation.vertices, allocation.indices);
+                break;
+            }
+            } // switch
+        }
+
+        store.syncToBufferObjects();
+        verifyBufferObjects(store, allocations);
+        store.onFrameFinished();
+    }
+}
+
+TEST(GeometryStore, OnlyModifiedRangesAreUploaded)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
+
+    std::vector<Allocation> allocations;
+
+    store.onFrameStart();
+
+    for (auto i = 0; i < 10; ++i)
+    {
+        auto vertices = generateVertices(i, 100);
+        auto indices = generateIndices(vertices);
+
+        auto slot = store.allocateSlot(vertices.size(), indices.size());
+        store.updateData(slot, vertices, indices);
+
+        allocations.emplace_back(Allocation{ slot, vertices, indices });
+    }
+
+    store.syncToBufferObjects();
+    store.onFrameFinished();
+
+    // Let every buffer in the ring receive the initial data
+    for (std::size_t i = 1; i < render::GeometryStore::NumFrameBuffers; ++i)
+    {
+        store.onFrameStart();
+        store.syncToBufferObjects();
+        store.onFrameFinished();
+    }
+
+    // Change a few vertices of a single slot
+    store.onFrameStart();
+
+    auto& allocation = allocations[4];
+    auto newVertices = generateVertices(9, 5);
+    std::copy(newVertices.begin(), newVertices.end(), allocation.vertices.begin() + 20);
+
+    store.updateSubData(allocation.slot, 20, newVertices, 0, { allocation.indices.front() });
+
+    // The change should reach every buffer object, without touching anything else
+    for (std::size_t i = 0; i < render::GeometryStore::NumFrameBuffers; ++i)
+    {
+        if (i > 0)
+        {
+            store.onFrameStart();
+        }
+
+        store.syncToBufferObjects();
+
+        auto vertexBuffer = std::static_pointer_cast<TestBufferObject>(store.getBufferObjects().first);
+        auto renderParms = store.getBufferAddresses(allocation.slot);
+
+        EXPECT_EQ(vertexBuffer->lastUsedOffset, (renderParms.firstVertex + 20) * sizeof(render::RenderVertex)) <<
+            "Unexpected upload offset in frame " << i;
+        EXPECT_EQ(vertexBuffer->lastUsedByteCount, newVertices.size() * sizeof(render::RenderVertex)) <<
+            "Unexpected upload size in frame " << i;
+
+        verifyBufferObjects(store, allocations);
+        store.onFrameFinished();
+    }
+}
+
 TEST(GeometryStore, AllocateIndexRemap)
 {
     render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
@@ -0,0 +1,395 @@
+#include "gtest/gtest.h"
+
+#include <functional>
+#include <random>
+#include <vector>
+#include "ImageKernels.h"
+#include "itextstream.h"
+#include "time/StopWatch.h"
+
+namespace test
+{
+
+namespace
+{
+
+using Pixels = std::vector<std::uint8_t>;
+
+Pixels createRandomImage(std::size_t width, std::size_t height, unsigned int seed = 42)
+{
+    std::minstd_rand random(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    Pixels pixels(width * height * 4);
+
+    for (auto& value : pixels)
+    {
+        value = static_cast<std::uint8_t>(distribution(random));
+    }
+
+    return pixels;
+}
+
+// Image sizes covering the remainders of the vectorised loops
+const std::vector<std::pair<std::size_t, std::size_t>> TestSizes
+{
+    { 1, 1 }, { 3, 2 }, { 5, 7 }, { 8, 1 }, { 17, 13 }, { 64, 32 }, { 100, 3 },
+};
+
+}
+
+TEST(ImageKernelsTest, ResampleLineGolden)
+{
+    Pixels in { 0, 10, 200, 255, 200, 30, 0, 255 };
+    Pixels out(4 * 4);
+
+    image::kernel::resample(in.data(), 2, 1, out.data(), 4, 1);
+
+    EXPECT_EQ(out, Pixels({ 0, 10, 200, 255, 100, 20, 100, 255, 200, 30, 0, 255, 200, 30, 0, 255 }));
+}
+
+TEST(ImageKernelsTest, ResampleColumnGolden)
+{
+    Pixels in { 0, 10, 200, 255, 200, 30, 0, 255 };
+    Pixels out(4 * 4, 1);
+
+    image::kernel::resample(in.data(), 1, 2, out.data(), 1, 4);
+
+    // The rows after the last source row are copies of it
+    EXPECT_EQ(out, Pixels({ 0, 10, 200, 255, 100, 20, 100, 255, 200, 30, 0, 255, 200, 30, 0, 255 }));
+}
+
+TEST(ImageKernelsTest, ResampleMatchesScalar)
+{
+    for (auto [inWidth, inHeight] : TestSizes)
+    {
+        for (auto [outWidth, outHeight] : TestSizes)
+        {
+            auto in = createRandomImage(inWidth, inHeight);
+            Pixels expected(outWidth * outHeight * 4);
+            Pixels result(outWidth * outHeight * 4);
+
+            image::kernel::scalar::resample(in.data(), inWidth, inHeight, expected.data(), outWidth, outHeight);
+            image::kernel::resample(in.data(), inWidth, inHeight, result.data(), outWidth, outHeight);
+
+            EXPECT_EQ(result, expected) << "Resampling " << inWidth << "x" << inHeight << " to " << outWidth << "x" << outHeight;
+        }
+    }
+}
+
+TEST(ImageKernelsTest, LerpRowsMatchesScalar)
+{
+    for (std::size_t lerp : { 0, 1, 0x4000, 0x7FFF, 0x8000, 0xC000, 0xFFFF })
+    {
+        for (std::size_t numBytes : { 1, 15, 16, 33, 70 })
+        {
+            auto rows = createRandomImage(numBytes, 2, static_cast<unsigned int>(lerp));
+            Pixels expected(numBytes);
+            Pixels result(numBytes);
+
+            image::kernel::scalar::lerpRows(rows.data(), rows.data() + numBytes, expected.data(), numBytes, lerp);
+            image::kernel::lerpRows(rows.data(), rows.data() + numBytes, result.data(), numBytes, lerp);
+
+            EXPECT_EQ(result, expected) << "Lerping " << numBytes << " bytes by " << lerp;
+        }
+    }
+}
+
+TEST(ImageKernelsTest, MipReduceGolden)
+{
+    Pixels in { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 17 };
+    Pixels out(4);
+
+    image::kernel::mipReduce(in.data(), out.data(), 2, 2, 1, 1);
+    EXPECT_EQ(out, Pixels({ 7, 8, 9, 10 }));
+
+    out.resize(8);
+    image::kernel::mipReduce(in.data(), out.data(), 2, 2, 1, 2);
+    EXPECT_EQ(out, Pixels({ 3, 4, 5, 6, 11, 12, 13, 14 }));
+
+    image::kernel::mipReduce(in.data(), out.data(), 2, 2, 2, 1);
+    EXPECT_EQ(out, Pixels({ 5, 6, 7, 8, 9, 10, 11, 12 }));
+}
+
+TEST(ImageKernelsTest, MipReduceMatchesScalar)
+{
+    for (auto [width, height] : std::vector<std::pair<std::size_t, std::size_t>>{ { 2, 2 }, { 6, 6 }, { 8, 4 }, { 64, 64 }, { 256, 2 } })
+    {
+        auto in = createRandomImage(width, height);
+
+        for (auto [destWidth, destHeight] : { std::make_pair(width / 2, height / 2), std::make_pair(width / 2, height), std::make_pair(width, height / 2) })
+        {
+            Pixels expected(in.size());
+            Pixels result(in.size());
+
+            image::kernel::scalar::mipReduce(in.data(), expected.data(), width, height, destWidth, destHeight);
+            image::kernel::mipReduce(in.data(), result.data(), width, height, destWidth, destHeight);
+
+            EXPECT_EQ(result, expected) << "Reducing " << width << "x" << height << " to " << destWidth << "x" << destHeight;
+
+            // The image is usually reduced in place
+            auto inPlace = in;
+            image::kernel::mipReduce(inPlace.data(), inPlace.data(), width, height, destWidth, destHeight);
+
+            auto reducedSize = (width > destWidth ? width / 2 : width) * (height > destHeight ? height / 2 : height) * 4;
+            EXPECT_TRUE(std::equal(expected.begin(), expected.begin() + reducedSize, inPlace.begin()))
+                << "Reducing " << width << "x" << height << " to " << destWidth << "x" << destHeight << " in place";
+        }
+    }
+}
+
+TEST(ImageKernelsTest, LookupTableGolden)
+{
+    std::uint8_t table[256];
+
+    for (int i = 0; i < 256; ++i)
+    {
+        table[i] = static_cast<std::uint8_t>(255 - i);
+    }
+
+    Pixels pixels { 0, 128, 255, 77 };
+    image::kernel::applyLookupTable(pixels.data(), 1, table);
+
+    EXPECT_EQ(pixels, Pixels({ 255, 127, 0, 77 })) << "Alpha should be left untouched";
+}
+
+TEST(ImageKernelsTest, ChannelOperationsGolden)
+{
+    Pixels in { 10, 20, 30, 40 };
+    Pixels out(4);
+
+    image::kernel::invertColour(in.data(), out.data(), 1);
+    EXPECT_EQ(out, Pixels({ 245, 235, 225, 40 }));
+
+    image::kernel::invertAlpha(in.data(), out.data(), 1);
+    EXPECT_EQ(out, Pixels({ 10, 20, 30, 215 }));
+
+    image::kernel::makeIntensity(in.data(), out.data(), 1);
+    EXPECT_EQ(out, Pixels({ 10, 10, 10, 10 }));
+
+    image::kernel::makeAlpha(in.data(), out.data(), 1);
+    EXPECT_EQ(out, Pixels({ 255, 255, 255, 20 }));
+}
+
+TEST(ImageKernelsTest, AverageGolden)
+{
+    // Halves are rounded to even
+    Pixels one { 0, 2, 3, 4 };
+    Pixels two { 1, 2, 4, 7 };
+    Pixels out(4);
+
+    image::kernel::average(one.data(), two.data(), out.data(), 1);
+    EXPECT_EQ(out, Pixels({ 0, 2, 4, 6 }));
+
+    image::kernel::averageNormals(one.data(), two.data(), out.data(), 1);
+    EXPECT_EQ(out, Pixels({ 0, 2, 4, 255 }));
+}
+
+TEST(ImageKernelsTest, PixelOperationsMatchScalar)
+{
+    using PixelOperation = std::function<void(const std::uint8_t*, std::uint8_t*, std::size_t)>;
+
+    const std::vector<std::pair<PixelOperation, PixelOperation>> operations
+    {
+        { image::kernel::invertColour, image::kernel::scalar::invertColour },
+        { image::kernel::invertAlpha, image::kernel::scalar::invertAlpha },
+        { image::kernel::makeIntensity, image::kernel::scalar::makeIntensity },
+        { image::kernel::makeAlpha, image::kernel::scalar::makeAlpha },
+    };
+
+    for (std::size_t numPixels : { 1, 3, 4, 9, 31, 1000 })
+    {
+        auto in = createRandomImage(numPixels, 1);
+        auto other = createRandomImage(numPixels, 1, 7);
+
+        for (std::size_t i = 0; i < operations.size(); ++i)
+        {
+            Pixels expected(in.size());
+            Pixels result(in.size());
+
+            operations[i].second(in.data(), expected.data(), numPixels);
+            operations[i].first(in.data(), result.data(), numPixels);
+
+            EXPECT_EQ(result, expected) << "Operation " << i << " on " << numPixels << " pixels";
+        }
+
+        Pixels expected(in.size());
+        Pixels result(in.size());
+
+        image::kernel::scalar::average(in.data(), other.data(), expected.data(), numPixels);
+        image::kernel::average(in.data(), other.data(), result.data(), numPixels);
+        EXPECT_EQ(result, expected) << "Averaging " << numPixels << " pixels";
+
+        image::kernel::scalar::averageNormals(in.data(), other.data(), expected.data(), numPixels);
+        image::kernel::averageNormals(in.data(), other.data(), result.data(), numPixels);
+        EXPECT_EQ(result, expected) << "Averaging " << numPixels << " normals";
+    }
+}
+
+TEST(ImageKernelsTest, SmoothNormalsGolden)
+{
+    // A single pixel in a 4x4 image, it is spread to its neighbours including the wrapped ones
+    Pixels in(4 * 4 * 4, 0);
+    in[(1 * 4 + 1) * 4 + 0] = 90;
+    in[(1 * 4 + 1) * 4 + 1] = 180;
+    in[(1 * 4 + 1) * 4 + 2] = 9;
+
+    Pixels out(in.size());
+    image::kernel::smoothNormals(in.data(), out.data(), 4, 4);
+
+    for (std::size_t y = 0; y < 4; ++y)
+    {
+        for (std::size_t x = 0; x < 4; ++x)
+        {
+            const auto* pixel = out.data() + (y * 4 + x) * 4;
+            auto isNeighbour = x != 3 && y != 3;
+
+            EXPECT_EQ(Pixels(pixel, pixel + 4), isNeighbour ? Pixels({ 10, 20, 1, 255 }) : Pixels({ 0, 0, 0, 255 }))
+                << "Pixel " << x << "," << y;
+        }
+    }
+}
+
+TEST(ImageKernelsTest, SmoothNormalsMatchesScalar)
+{
+    for (auto [width, height] : TestSizes)
+    {
+        auto in = createRandomImage(width, height);
+        Pixels expected(in.size());
+        Pixels result(in.size());
+
+        image::kernel::scalar::smoothNormals(in.data(), expected.data(), width, height);
+        image::kernel::smoothNormals(in.data(), result.data(), width, height);
+
+        EXPECT_EQ(result, expected) << "Smoothing " << width << "x" << height;
+    }
+
+    // Sums close to the rounding boundaries
+    for (std::uint8_t value : { 0, 1, 4, 5, 127, 128, 254, 255 })
+    {
+        Pixels in(5 * 3 * 4, value);
+        in[0] = 255;
+        in[5] = 0;
+
+        Pixels expected(in.size());
+        Pixels result(in.size());
+
+        image::kernel::scalar::smoothNormals(in.data(), expected.data(), 5, 3);
+        image::kernel::smoothNormals(in.data(), result.data(), 5, 3);
+
+        EXPECT_EQ(result, expected) << "Smoothing a uniform image of " << static_cast<int>(value);
+    }
+}
+
+TEST(ImageKernelsTest, NormalMapGolden)
+{
+    // A single peak in the center of a 3x3 height map
+    Pixels in(3 * 3 * 4, 0);
+    in[(1 * 3 + 1) * 4] = 255;
+
+    Pixels out(in.size());
+    image::kernel::createNormalMap(in.data(), out.data(), 3, 3, 1.0f);
+
+    auto getPixel = [&](std::size_t x, std::size_t y)
+    {
+        const auto* pixel = out.data() + (y * 3 + x) * 4;
+        return Pixels(pixel, pixel + 4);
+    };
+
+    EXPECT_EQ(getPixel(1, 1), Pixels({ 128, 128, 255, 255 })) << "The peak should be flat";
+    EXPECT_EQ(getPixel(0, 1), Pixels({ 37, 128, 218, 255 })) << "Left of the peak should face left";
+    EXPECT_EQ(getPixel(2, 1), Pixels({ 218, 128, 218, 255 })) << "Right of the peak should face right";
+    EXPECT_EQ(getPixel(1, 0), Pixels({ 128, 37, 218, 255 })) << "Above the peak should face up";
+    EXPECT_EQ(getPixel(1, 2), Pixels({ 128, 218, 218, 255 })) << "Below the peak should face down";
+}
+
+TEST(ImageKernelsTest, NormalMapMatchesScalar)
+{
+    for (auto scale : { 0.5f, 1.0f, 8.0f })
+    {
+        for (auto [width, height] : TestSizes)
+        {
+            auto in = createRandomImage(width, height);
+            Pixels expected(in.size());
+            Pixels result(in.size());
+
+            image::kernel::scalar::createNormalMap(in.data(), expected.data(), width, height, scale);
+            image::kernel::createNormalMap(in.data(), result.data(), width, height, scale);
+
+            EXPECT_EQ(result, expected) << "Normal map of " << width << "x" << height << " with scale " << scale;
+        }
+    }
+}
+
+// Measures the throughput of the scalar and the vectorised kernels
+TEST(ImageKernelsTest, Throughput)
+{
+    constexpr std::size_t Size = 1024;
+    constexpr std::size_t NumPixels = Size * Size;
+    constexpr std::size_t NumPasses = 5;
+
+    auto in = createRandomImage(Size, Size);
+    auto other = createRandomImage(Size, Size, 7);
+    Pixels out(NumPixels * 4);
+    Pixels large((Size + Size / 2) * (Size + Size / 2) * 4);
+
+    std::uint8_t table[256];
+
+    for (int i = 0; i < 256; ++i)
+    {
+        table[i] = static_cast<std::uint8_t>(255 - i);
+    }
+
+    auto measure = [&](const std::string& name, const std::function<void()>& scalar, const std::function<void()>& vectorised)
+    {
+        auto getMegabytesPerSecond = [&](const std::function<void()>& kernel)
+        {
+            util::StopWatch timer;
+
+            for (std::size_t pass = 0; pass < NumPasses; ++pass)
+            {
+                kernel();
+            }
+
+            auto milliSeconds = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+            return NumPixels * 4 * NumPasses / 1000 / milliSeconds;
+        };
+
+        auto scalarThroughput = getMegabytesPerSecond(scalar);
+        auto vectorisedThroughput = getMegabytesPerSecond(vectorised);
+
+        rMessage() << name << ": " << scalarThroughput << " MB/s scalar, " << vectorisedThroughput << " MB/s vectorised" << std::endl;
+    };
+
+    using namespace image::kernel;
+
+    measure("resample",
+        [&]() { scalar::resample(in.data(), Size, Size, large.data(), Size + Size / 2, Size + Size / 2); },
+        [&]() { resample(in.data(), Size, Size, large.data(), Size + Size / 2, Size + Size / 2); });
+    measure("mipReduce",
+        [&]() { scalar::mipReduce(in.data(), out.data(), Size, Size, Size / 2, Size / 2); },
+        [&]() { mipReduce(in.data(), out.data(), Size, Size, Size / 2, Size / 2); });
+    measure("applyLookupTable",
+        [&]() { scalar::applyLookupTable(out.data(), NumPixels, table); },
+        [&]() { applyLookupTable(out.data(), NumPixels, table); });
+    measure("invertColour",
+        [&]() { scalar::invertColour(in.data(), out.data(), NumPixels); },
+        [&]() { invertColour(in.data(), out.data(), NumPixels); });
+    measure("makeIntensity",
+        [&]() { scalar::makeIntensity(in.data(), out.data(), NumPixels); },
+        [&]() { makeIntensity(in.data(), out.data(), NumPixels); });
+    measure("makeAlpha",
+        [&]() { scalar::makeAlpha(in.data(), out.data(), NumPixels); },
+        [&]() { makeAlpha(in.data(), out.data(), NumPixels); });
+    measure("averageNormals",
+        [&]() { scalar::averageNormals(in.data(), other.data(), out.data(), NumPixels); },
+        [&]() { averageNormals(in.data(), other.data(), out.data(), NumPixels); });
+    measure("smoothNormals",
+        [&]() { scalar::smoothNormals(in.data(), out.data(), Size, Size); },
+        [&]() { smoothNormals(in.data(), out.data(), Size, Size); });
+    measure("createNormalMap",
+        [&]() { scalar::createNormalMap(in.data(), out.data(), Size, Size, 1.0f); },
+        [&]() { createNormalMap(in.data(), out.data(), Size, Size, 1.0f); });
+}
+
+}
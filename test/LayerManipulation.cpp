@@ -1,6 +1,8 @@
 #include "i18n.h"
 #include "RadiantTest.h"
 
+#include <set>
+
 #include "imap.h"
 #include "ilayer.h"
 #include "ifilter.h"
@@ -9,8 +11,10 @@
 #include "os/file.h"
 
 #include "algorithm/Scene.h"
+#include "string/convert.h"
 #include "string/split.h"
 #include "string/trim.h"
+#include "time/StopWatch.h"
 #include "testutil/FileSaveConfirmationHelper.h"
 #include "testutil/TemporaryFile.h"
 
@@ -1247,4 +1251,154 @@ TEST_F(LayerTest, ParseLayerPropertiesHiddenLayers)
     expectLayersAreVisible({ 0,4,5,9 }, false);
 }
 
+TEST(LayerListTest, InlineAndOverflowIds)
+{
+    scene::LayerList list{ 70, 3, 0, -2, 63, 64 };
+
+    EXPECT_EQ(list.size(), 6);
+    EXPECT_EQ(std::vector<int>(list.begin(), list.end()), std::vector<int>({ -2, 0, 3, 63, 64, 70 })) << "Iteration must be ordered";
+
+    EXPECT_FALSE(list.insert(3)) << "3 is already a member";
+    EXPECT_FALSE(list.insert(70)) << "70 is already a member";
+    EXPECT_EQ(list.count(64), 1);
+    EXPECT_EQ(list.count(65), 0);
+    EXPECT_EQ(*list.find(63), 63);
+    EXPECT_EQ(list.find(5), list.end());
+
+    EXPECT_EQ(list.erase(0), 1);
+    EXPECT_EQ(list.erase(70), 1);
+    EXPECT_EQ(list.erase(70), 0);
+    EXPECT_EQ(list, scene::LayerList({ -2, 3, 63, 64 }));
+
+    EXPECT_TRUE(list.intersects(scene::LayerList{ 1, 63 }));
+    EXPECT_TRUE(list.intersects(scene::LayerList{ 64 }));
+    EXPECT_FALSE(list.intersects(scene::LayerList{ 0, 1, 65 }));
+    EXPECT_FALSE(list.intersects(scene::LayerList()));
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.begin(), list.end());
+}
+
+// Compares the memory footprint and the visibility check of the LayerList
+// against the std::set<int> it replaced
+TEST(LayerListTest, VisibilityCheckVersusStdSet)
+{
+    constexpr std::size_t NumNodes = 200000;
+    constexpr int NumLayers = 8;
+
+    std::vector<std::set<int>> sets(NumNodes);
+    std::vector<scene::LayerList> lists(NumNodes);
+
+    for (std::size_t i = 0; i < NumNodes; ++i)
+    {
+        sets[i].insert(static_cast<int>(i % NumLayers));
+        lists[i].insert(static_cast<int>(i % NumLayers));
+    }
+
+    // Every other layer is hidden
+    std::vector<bool> layerVisibility(NumLayers);
+    scene::LayerList visibleLayers;
+
+    for (int layerId = 0; layerId < NumLayers; layerId += 2)
+    {
+        layerVisibility[layerId] = true;
+        visibleLayers.insert(layerId);
+    }
+
+    util::StopWatch timer;
+    std::size_t visibleSets = 0;
+
+    for (const auto& set : sets)
+    {
+        for (int layerId : set)
+        {
+            if (layerVisibility[layerId])
+            {
+                ++visibleSets;
+                break;
+            }
+        }
+    }
+
+    auto setTime = timer.getMilliSecondsPassed();
+    timer.restart();
+
+    std::size_t visibleLists = 0;
+
+    for (const auto& list : lists)
+    {
+        if (list.intersects(visibleLayers))
+        {
+            ++visibleLists;
+        }
+    }
+
+    auto listTime = timer.getMilliSecondsPassed();
+
+    EXPECT_EQ(visibleSets, NumNodes / 2);
+    EXPECT_EQ(visibleLists, visibleSets);
+
+    // A std::set allocates one tree node per element (3 pointers, colour and value)
+    auto setBytes = sizeof(std::set<int>) + 4 * sizeof(void*);
+    auto listBytes = sizeof(scene::LayerList);
+
+    rMessage() << "Single-layer membership of " << NumNodes << " nodes: std::set<int> " <<
+        setBytes * NumNodes / 1024 << " KiB, " << setTime << " msec for the visibility check; LayerList " <<
+        listBytes * NumNodes / 1024 << " KiB, " << listTime << " msec" << std::endl;
+
+    EXPECT_LT(listBytes, setBytes);
+}
+
+TEST_F(LayerTest, LayerVisibilityToggleBenchmark)
+{
+    constexpr std::size_t NumBrushes = 4000;
+    constexpr int NumRounds = 20;
+
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<int> layerIds = { 0 };
+
+    for (int i = 1; i < 8; ++i)
+    {
+        layerIds.push_back(layerManager.createLayer("Layer" + string::to_string(i)));
+    }
+
+    std::vector<scene::INodePtr> brushes;
+
+    for (std::size_t i = 0; i < NumBrushes; ++i)
+    {
+        auto brush = algorithm::createCubicBrush(worldspawn, Vector3(static_cast<double>(i % 64) * 128, static_cast<double>(i / 64) * 128, 0));
+        brush->assignToLayers(scene::LayerList{ layerIds[i % layerIds.size()] });
+        brushes.push_back(brush);
+    }
+
+    util::StopWatch timer;
+
+    for (int round = 0; round < NumRounds; ++round)
+    {
+        for (auto layerId : layerIds)
+        {
+            layerManager.setLayerVisibility(layerId, round % 2 != 0);
+        }
+    }
+
+    rMessage() << "Toggled " << layerIds.size() << " layers " << NumRounds << " times on " << NumBrushes <<
+        " brushes in " << timer.getMilliSecondsPassed() << " msec" << std::endl;
+
+    // The last round made all layers visible again
+    for (const auto& brush : brushes)
+    {
+        EXPECT_TRUE(brush->visible());
+    }
+
+    layerManager.setLayerVisibility(layerIds[1], false);
+
+    for (std::size_t i = 0; i < NumBrushes; ++i)
+    {
+        EXPECT_EQ(brushes[i]->visible(), i % layerIds.size() != 1) << "Brush " << i << " has the wrong visibility";
+    }
+}
+
 }
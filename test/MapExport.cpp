@@ -3,6 +3,9 @@
 #include "imap.h"
 #include "imapformat.h"
 #include "ibrush.h"
+#include "ipatch.h"
+#include "ientity.h"
+#include "ichangetrackednode.h"
 #include "math/Plane3.h"
 #include "math/Matrix3.h"
 #include "iselection.h"
@@ -13,7 +16,9 @@
 #include "messages/MapFileOperation.h"
 #include "algorithm/XmlUtils.h"
 #include "algorithm/Primitives.h"
+#include "algorithm/Scene.h"
 #include "testutil/FileSelectionHelper.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -333,4 +338,160 @@ TEST_F(MapExportTest, ExportPrefabWithEmptyFileExtension)
     runExportWithEmptyFileExtension(_context.getTemporaryDataPath(), "SaveSelectedAsPrefab");
 }
 
+namespace
+{
+
+// Exports the whole map to a string using the format for the given game type
+std::string exportMapText(const std::string& gameType)
+{
+    GlobalSelectionSystem().setSelectedAll(true);
+
+    std::ostringstream output;
+    GlobalMapModule().exportSelected(output, GlobalMapFormatManager().getMapFormatForGameType(gameType, "map"));
+
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    return output.str();
+}
+
+// Invokes the functor for the given node and its children, if they are tracking their changes
+void foreachChangeTrackedNode(const scene::INodePtr& node, const std::function<void(scene::IChangeTrackedNode&)>& functor)
+{
+    if (auto trackedNode = std::dynamic_pointer_cast<scene::IChangeTrackedNode>(node); trackedNode)
+    {
+        functor(*trackedNode);
+    }
+
+    node->foreachNode([&](const scene::INodePtr& child)
+    {
+        foreachChangeTrackedNode(child, functor);
+        return true;
+    });
+}
+
+void clearSerialisationCaches()
+{
+    foreachChangeTrackedNode(GlobalSceneGraph().root(), [](scene::IChangeTrackedNode& node)
+    {
+        node.getSerialisationCache() = scene::SerialisationCache();
+    });
+}
+
+}
+
+TEST_F(MapExportTest, UnchangedNodesReuseExportedText)
+{
+    loadMap("altar.map");
+
+    auto initialText = exportMapText("doom3");
+
+    // Every worldspawn primitive should have stored its text along with its current change stamp
+    // (children of other func_* entities are moved around during export, so they're left out)
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    std::size_t numCachedNodes = 0;
+
+    foreachChangeTrackedNode(worldspawn, [&](scene::IChangeTrackedNode& node)
+    {
+        EXPECT_EQ(node.getSerialisationCache().changeStamp, node.getChangeStamp());
+        EXPECT_FALSE(node.getSerialisationCache().text.empty());
+        ++numCachedNodes;
+    });
+
+    EXPECT_GT(numCachedNodes, 10);
+
+    // A second export of the unchanged map is taking the text from the cache
+    EXPECT_EQ(exportMapText("doom3"), initialText);
+
+    auto brush = algorithm::findFirstBrush(worldspawn, [](const IBrushNodePtr&) { return true; });
+    auto otherBrush = algorithm::findFirstBrush(worldspawn, [&](const IBrushNodePtr& node)
+    {
+        return std::dynamic_pointer_cast<scene::INode>(node) != brush;
+    });
+    auto patch = algorithm::findFirstPatch(worldspawn, [](const IPatchNodePtr&) { return true; });
+    auto light = algorithm::findFirstEntity(GlobalSceneGraph().root(), [](const IEntityNodePtr& entity)
+    {
+        return entity->getEntity().getKeyValue("classname") == "light_torchflame";
+    });
+
+    ASSERT_TRUE(brush && otherBrush && patch && light);
+
+    auto untouchedStamp = std::dynamic_pointer_cast<scene::IChangeTrackedNode>(otherBrush)->getChangeStamp();
+
+    // Change the material of a face, which must not affect the other brush
+    {
+        UndoableCommand cmd("changeMaterial");
+        Node_getIBrush(brush)->getFace(0).setShader("textures/numbers/2");
+    }
+
+    EXPECT_EQ(std::dynamic_pointer_cast<scene::IChangeTrackedNode>(otherBrush)->getChangeStamp(), untouchedStamp);
+
+    // Shift a texture, change a patch and an entity keyvalue
+    {
+        UndoableCommand cmd("shiftTexture");
+        Node_getIBrush(otherBrush)->getFace(1).shiftTexdef(8, 16);
+    }
+
+    {
+        UndoableCommand cmd("changePatch");
+        Node_getIPatch(patch)->setShader("textures/numbers/3");
+    }
+
+    {
+        UndoableCommand cmd("changeKeyValue");
+        Node_getEntity(light)->setKeyValue("_color", "0.5 0.25 1");
+    }
+
+    auto modifiedText = exportMapText("doom3");
+    EXPECT_NE(modifiedText, initialText);
+    EXPECT_NE(modifiedText.find("\"textures/numbers/2\""), std::string::npos);
+    EXPECT_NE(modifiedText.find("\"_color\" \"0.5 0.25 1\""), std::string::npos);
+
+    // The partially cached export must be the same as a fresh one
+    clearSerialisationCaches();
+    EXPECT_EQ(exportMapText("doom3"), modifiedText);
+
+    // Switching the format must not reuse the text of the other one
+    auto quake4Text = exportMapText("quake4");
+    EXPECT_NE(quake4Text, modifiedText);
+    clearSerialisationCaches();
+    EXPECT_EQ(exportMapText("quake4"), quake4Text);
+
+    // Undoing all changes needs to bring back the original text
+    for (int i = 0; i < 4; ++i)
+    {
+        GlobalMapModule().getUndoSystem().undo();
+    }
+
+    EXPECT_EQ(exportMapText("doom3"), initialText);
+}
+
+TEST_F(MapExportTest, IncrementalExportBenchmark)
+{
+    auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 20000, 256);
+
+    clearSerialisationCaches();
+
+    util::StopWatch timer;
+    auto fullText = exportMapText("doom3");
+    auto fullExportTime = timer.getMilliSecondsPassed();
+
+    // Touch 1% of the brushes
+    for (std::size_t i = 0; i < brushes.size(); i += 100)
+    {
+        UndoableCommand cmd("shiftTexture");
+        Node_getIBrush(brushes[i])->getFace(0).shiftTexdef(1, 0);
+    }
+
+    timer.restart();
+    auto incrementalText = exportMapText("doom3");
+    auto incrementalExportTime = timer.getMilliSecondsPassed();
+
+    clearSerialisationCaches();
+    EXPECT_EQ(exportMapText("doom3"), incrementalText);
+    EXPECT_NE(incrementalText, fullText);
+
+    rMessage() << "Exported " << brushes.size() << " brushes in " << fullExportTime <<
+        " ms, after changing 1% of them in " << incrementalExportTime << " ms" << std::endl;
+}
+
 }
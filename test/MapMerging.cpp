@@ -1,5 +1,8 @@
 #include "RadiantTest.h"
 
+#include <set>
+#include <algorithm>
+
 #include "icommandsystem.h"
 #include "itransformable.h"
 #include "ibrush.h"
@@ -9,6 +12,8 @@
 #include "algorithm/Scene.h"
 #include "registry/registry.h"
 #include "scenelib.h"
+#include "time/StopWatch.h"
+#include "testutil/TemporaryFile.h"
 #include "scene/merge/GraphComparer.h"
 #include "scene/merge/MergeOperation.h"
 #include "scene/merge/ThreeWayMergeOperation.h"
@@ -385,6 +390,166 @@ TEST_F(MapMergeTest, DetectChildPrimitiveChanges)
     EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveRemoved), 3);
 }
 
+// The comparison is running on several threads, the order of the reported differences must not depend on that
+TEST_F(MapMergeTest, ComparisonResultOrderIsDeterministic)
+{
+    auto result = performComparison("maps/fingerprinting.mapx", _context.getTestProjectPath() + "maps/fingerprinting_2.mapx");
+
+    auto resource = GlobalMapResourceManager().createFromPath(_context.getTestProjectPath() + "maps/fingerprinting_2.mapx");
+    EXPECT_TRUE(resource->load());
+
+    auto secondResult = GraphComparer::Compare(resource->getRootNode(), GlobalMapModule().getRoot());
+
+    ASSERT_EQ(result->equivalentEntities.size(), secondResult->equivalentEntities.size());
+    ASSERT_EQ(result->differingEntities.size(), secondResult->differingEntities.size());
+
+    auto match = result->equivalentEntities.begin();
+    auto secondMatch = secondResult->equivalentEntities.begin();
+
+    for (; match != result->equivalentEntities.end(); ++match, ++secondMatch)
+    {
+        EXPECT_EQ(match->fingerPrint, secondMatch->fingerPrint);
+    }
+
+    auto diff = result->differingEntities.begin();
+    auto secondDiff = secondResult->differingEntities.begin();
+
+    for (; diff != result->differingEntities.end(); ++diff, ++secondDiff)
+    {
+        EXPECT_EQ(diff->entityName, secondDiff->entityName);
+        EXPECT_EQ(diff->type, secondDiff->type);
+        ASSERT_EQ(diff->differingChildren.size(), secondDiff->differingChildren.size());
+
+        auto child = diff->differingChildren.begin();
+        auto secondChild = secondDiff->differingChildren.begin();
+
+        for (; child != diff->differingChildren.end(); ++child, ++secondChild)
+        {
+            EXPECT_EQ(child->fingerprint, secondChild->fingerprint);
+            EXPECT_EQ(child->type, secondChild->type);
+        }
+
+        // Within each kind of difference, the primitives are sorted by fingerprint
+        for (auto type : { ComparisonResult::PrimitiveDifference::Type::PrimitiveAdded, ComparisonResult::PrimitiveDifference::Type::PrimitiveRemoved })
+        {
+            std::vector<std::string> fingerprints;
+
+            for (const auto& childDiff : diff->differingChildren)
+            {
+                if (childDiff.type == type) fingerprints.push_back(childDiff.fingerprint);
+            }
+
+            EXPECT_TRUE(std::is_sorted(fingerprints.begin(), fingerprints.end()));
+        }
+    }
+}
+
+namespace
+{
+
+// Generates a map with func_static entities, each holding brushesPerEntity cuboids.
+// The first brush of each entity listed in changedEntities is using a different material.
+std::string generateMergeBenchmarkMap(std::size_t numEntities, std::size_t brushesPerEntity,
+    const std::set<std::size_t>& changedEntities)
+{
+    std::string mapText = "Version 2\n{\n\"classname\" \"worldspawn\"\n}\n";
+
+    for (std::size_t e = 0; e < numEntities; ++e)
+    {
+        auto name = "func_static_" + std::to_string(e);
+        auto z = std::to_string(e * 64);
+        auto zMax = std::to_string(e * 64 + 32);
+
+        mapText += "{\n\"classname\" \"func_static\"\n\"name\" \"" + name + "\"\n\"model\" \"" + name + "\"\n";
+
+        for (std::size_t b = 0; b < brushesPerEntity; ++b)
+        {
+            auto x = std::to_string(b * 64);
+            auto xMax = std::to_string(b * 64 + 32);
+            auto shader = std::string(b == 0 && changedEntities.count(e) > 0 ? "\"textures/numbers/2\"" : "\"textures/numbers/1\"");
+            auto texdef = " ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+
+            mapText += "{\nbrushDef3\n{\n";
+            mapText += "( 0 0 1 -" + zMax + " )" + texdef;
+            mapText += "( 0 0 -1 " + z + " )" + texdef;
+            mapText += "( 0 1 0 -32 )" + texdef;
+            mapText += "( 0 -1 0 0 )" + texdef;
+            mapText += "( 1 0 0 -" + xMax + " )" + texdef;
+            mapText += "( -1 0 0 " + x + " )" + texdef;
+            mapText += "}\n}\n";
+        }
+
+        mapText += "}\n";
+    }
+
+    return mapText;
+}
+
+}
+
+// Compares two maps with 100k brushes each, measuring the time spent with and without cached fingerprints
+TEST_F(MapMergeTest, CompareLargeMapsBenchmark)
+{
+    constexpr std::size_t NumEntities = 50;
+    constexpr std::size_t BrushesPerEntity = 2000;
+    const std::set<std::size_t> changedEntities = { 3, 17, 42 };
+
+    auto basePath = _context.getTemporaryDataPath() + "merge_benchmark_base.map";
+    auto sourcePath = _context.getTemporaryDataPath() + "merge_benchmark_source.map";
+    TemporaryFile baseFile(basePath, generateMergeBenchmarkMap(NumEntities, BrushesPerEntity, {}));
+    TemporaryFile sourceFile(sourcePath, generateMergeBenchmarkMap(NumEntities, BrushesPerEntity, changedEntities));
+
+    auto baseResource = GlobalMapResourceManager().createFromPath(basePath);
+    auto sourceResource = GlobalMapResourceManager().createFromPath(sourcePath);
+    ASSERT_TRUE(baseResource->load());
+    ASSERT_TRUE(sourceResource->load());
+
+    auto checkResult = [&](const ComparisonResult::Ptr& result, const std::set<std::size_t>& expectedEntities)
+    {
+        EXPECT_EQ(result->differingEntities.size(), expectedEntities.size());
+
+        for (auto e : expectedEntities)
+        {
+            auto diff = getEntityDifference(result, "func_static_" + std::to_string(e));
+
+            // The changed brush is showing up as one removal and one addition
+            EXPECT_EQ(diff.type, ComparisonResult::EntityDifference::Type::EntityPresentButDifferent);
+            EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveAdded), 1);
+            EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveRemoved), 1);
+        }
+    };
+
+    util::StopWatch timer;
+    auto result = GraphComparer::Compare(sourceResource->getRootNode(), baseResource->getRootNode());
+    auto initialTime = timer.getMilliSecondsPassed();
+
+    checkResult(result, changedEntities);
+
+    // The second comparison is working with the fingerprints cached by the first one
+    timer.restart();
+    result = GraphComparer::Compare(sourceResource->getRootNode(), baseResource->getRootNode());
+    auto cachedTime = timer.getMilliSecondsPassed();
+
+    checkResult(result, changedEntities);
+
+    // Changing a single brush in the source invalidates the fingerprints of that brush and its entity
+    auto entity = algorithm::getEntityByName(sourceResource->getRootNode(), "func_static_0");
+    ASSERT_TRUE(entity);
+    auto brush = Node_getIBrush(algorithm::findFirstBrushWithMaterial(entity, "textures/numbers/1"));
+    brush->setShader("textures/numbers/2");
+
+    timer.restart();
+    result = GraphComparer::Compare(sourceResource->getRootNode(), baseResource->getRootNode());
+    auto changedTime = timer.getMilliSecondsPassed();
+
+    auto expectedEntities = changedEntities;
+    expectedEntities.insert(0);
+    checkResult(result, expectedEntities);
+
+    rMessage() << "Compared two maps with " << NumEntities * BrushesPerEntity << " brushes each in " << initialTime
+        << " ms, " << cachedTime << " ms with cached fingerprints, " << changedTime << " ms after changing a brush" << std::endl;
+}
+
 template<typename T>
 std::shared_ptr<T> findAction(const IMergeOperation::Ptr& operation, const std::function<bool(const std::shared_ptr<T>&)>& predicate)
 {
@@ -1,6 +1,7 @@
 #include "RadiantTest.h"
 
 #include <fstream>
+#include <sstream>
 #include "iundo.h"
 #include "imap.h"
 #include "imapformat.h"
@@ -10,6 +11,8 @@
 #include "iradiant.h"
 #include "iselectiongroup.h"
 #include "ilightnode.h"
+#include "ientity.h"
+#include "ibrush.h"
 #include "icommandsystem.h"
 #include "messages/ApplicationShutdownRequest.h"
 #include "messages/FileSelectionRequest.h"
@@ -26,6 +29,8 @@
 #include "testutil/FileSaveConfirmationHelper.h"
 #include "registry/registry.h"
 #include "testutil/TemporaryFile.h"
+#include "time/StopWatch.h"
+#include "parser/ParseException.h"
 
 using namespace std::chrono_literals;
 
@@ -455,6 +460,239 @@ TEST_F(MapLoadingTest, loadMapxInResourceOnly)
     checkAltarScene(resource->getRootNode());
 }
 
+TEST_F(MapLoadingTest, loadMapbInResourceOnly)
+{
+    // Save a binary copy of the altar map
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+    checkAltarScene();
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "altar_copy.mapb";
+
+    auto format = GlobalMapFormatManager().getMapFormatForFilename(tempPath.string());
+    EXPECT_EQ(format->getMapFormatName(), map::BINARY_MAP_FORMAT_NAME);
+
+    FileSelectionHelper responder(tempPath.string(), format);
+    GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    EXPECT_TRUE(os::fileOrDirExists(tempPath));
+
+    // Load the binary copy, this is going through the memory mapped file stream
+    auto resource = GlobalMapResourceManager().createFromPath(tempPath.string());
+    EXPECT_TRUE(resource->load()) << "Copied map not found: " << tempPath.string();
+
+    checkAltarScene(resource->getRootNode());
+}
+
+// Generates a large map with cuboid brushes and patches and measures the load throughput
+TEST_F(MapLoadingTest, loadLargeMapThroughput)
+{
+    constexpr int NumBrushes = 20000;
+    constexpr int NumPatches = 2000;
+
+    std::string mapText = "Version 2\n{\n\"classname\" \"worldspawn\"\n";
+
+    for (int i = 0; i < NumBrushes; ++i)
+    {
+        auto offset = std::to_string(i * 64);
+        auto shader = "\"textures/numbers/" + std::to_string(i % 10) + "\"";
+
+        mapText += "{\nbrushDef3\n{\n";
+        mapText += "( 0 0 1 -64 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+        mapText += "( 0 0 -1 0 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+        mapText += "( 0 1 0 -64 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+        mapText += "( 0 -1 0 0 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+        mapText += "( 1 0 0 -" + std::to_string(i * 64 + 64) + " ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+        mapText += "( -1 0 0 " + offset + " ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+        mapText += "}\n}\n";
+    }
+
+    for (int i = 0; i < NumPatches; ++i)
+    {
+        auto z = std::to_string(i * 16);
+
+        mapText += "{\npatchDef2\n{\n\"textures/numbers/1\"\n( 3 3 0 0 0 )\n(\n";
+
+        for (int col = 0; col < 3; ++col)
+        {
+            auto x = std::to_string(col * 32);
+            mapText += "( ( " + x + " 0 " + z + " 0 0 ) ( " + x + " 32 " + z + " 0 0.5 ) ( " + x + " 64 " + z + " 0 1 ) )\n";
+        }
+
+        mapText += ")\n}\n}\n";
+    }
+
+    mapText += "}\n";
+
+    fs::path mapPath = _context.getTemporaryDataPath();
+    mapPath /= "large_generated.map";
+    TemporaryFile tempFile(mapPath.string(), mapText);
+
+    util::StopWatch timer;
+    GlobalCommandSystem().executeCommand("OpenMap", mapPath.string());
+    auto loadTime = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+
+    auto worldspawn = algorithm::findWorldspawn(GlobalMapModule().getRoot());
+    ASSERT_TRUE(worldspawn);
+    EXPECT_EQ(algorithm::getChildCount(worldspawn), NumBrushes + NumPatches);
+
+    auto megaBytes = mapText.size() / (1024.0 * 1024.0);
+
+    rMessage() << "Loaded " << megaBytes << " MB map with " << NumBrushes << " brushes and " << NumPatches <<
+        " patches in " << loadTime << " ms (" << megaBytes * 1000 / loadTime << " MB/s)" << std::endl;
+}
+
+namespace
+{
+
+// Generates a map with func_static entities named entity_N, each holding one brush
+// using the shader textures/numbers/(N % 10), and some braces hidden in strings and comments
+std::string generateEntityMap(int numEntities, int brokenEntity = -1)
+{
+    std::string mapText = "Version 2\n// { header comment\n{\n\"classname\" \"worldspawn\"\n}\n";
+
+    for (int i = 1; i <= numEntities; ++i)
+    {
+        auto shader = "\"textures/numbers/" + std::to_string(i % 10) + "\"";
+
+        mapText += "/* entity } " + std::to_string(i) + " */\n{\n\"classname\" \"func_static\"\n";
+        mapText += "\"name\" \"entity_" + std::to_string(i) + "\"\n";
+        mapText += "\"model\" \"entity_" + std::to_string(i) + "\"\n";
+        mapText += "\"description\" \"braces { } and \\\"quotes\\\" // inside a value\"\n";
+        mapText += i == brokenEntity ? "{\nbrushDef4\n{\n}\n}\n" : "{\nbrushDef3\n{\n";
+
+        if (i != brokenEntity)
+        {
+            mapText += "( 0 0 1 -64 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+            mapText += "( 0 0 -1 0 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+            mapText += "( 0 1 0 -64 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+            mapText += "( 0 -1 0 0 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+            mapText += "( 1 0 0 -64 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+            mapText += "( -1 0 0 0 ) ( ( 0.0078125 0 0.5 ) ( 0 0.0078125 0.5 ) ) " + shader + " 0 0 0\n";
+            mapText += "}\n}\n";
+        }
+
+        mapText += "}\n";
+    }
+
+    return mapText;
+}
+
+// Import filter recording the entities it receives
+class RecordingImportFilter :
+    public map::IMapImportFilter
+{
+private:
+    scene::IMapRootNodePtr _root;
+
+public:
+    std::vector<scene::INodePtr> entities;
+    std::map<scene::INodePtr, std::vector<scene::INodePtr>> primitives;
+
+    RecordingImportFilter() :
+        _root(GlobalMapModule().getRoot())
+    {}
+
+    const scene::IMapRootNodePtr& getRootNode() const override
+    {
+        return _root;
+    }
+
+    bool addEntity(const scene::INodePtr& entity) override
+    {
+        entities.push_back(entity);
+        return true;
+    }
+
+    bool addPrimitiveToEntity(const scene::INodePtr& primitive, const scene::INodePtr& entity) override
+    {
+        primitives[entity].push_back(primitive);
+        return true;
+    }
+};
+
+}
+
+// Entities are parsed on several threads, they need to end up in the scene in file order
+TEST_F(MapLoadingTest, concurrentlyParsedEntitiesKeepFileOrder)
+{
+    constexpr int NumEntities = 500;
+
+    fs::path mapPath = _context.getTemporaryDataPath();
+    mapPath /= "generated_entities.map";
+    TemporaryFile tempFile(mapPath.string(), generateEntityMap(NumEntities));
+
+    GlobalCommandSystem().executeCommand("OpenMap", mapPath.string());
+
+    std::vector<scene::INodePtr> entities;
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        entities.push_back(node);
+        return true;
+    });
+
+    ASSERT_EQ(entities.size(), NumEntities + 1);
+    EXPECT_EQ(Node_getEntity(entities[0])->getKeyValue("classname"), "worldspawn");
+
+    for (int i = 1; i <= NumEntities; ++i)
+    {
+        auto entity = Node_getEntity(entities[i]);
+        EXPECT_EQ(entity->getKeyValue("name"), "entity_" + std::to_string(i));
+        EXPECT_EQ(entity->getKeyValue("description"), "braces { } and \"quotes\" // inside a value");
+
+        ASSERT_EQ(algorithm::getChildCount(entities[i]), 1);
+
+        auto brush = Node_getIBrush(algorithm::getNthChild(entities[i], 0));
+        ASSERT_TRUE(brush);
+        EXPECT_EQ(brush->getNumFaces(), 6);
+        EXPECT_EQ(brush->getFace(0).getShader(), "textures/numbers/" + std::to_string(i % 10));
+    }
+}
+
+TEST_F(MapLoadingTest, concurrentParserReportsFailingEntity)
+{
+    constexpr int BrokenEntity = 37;
+
+    std::stringstream stream(generateEntityMap(100, BrokenEntity));
+
+    RecordingImportFilter filter;
+    auto format = GlobalMapFormatManager().getMapFormatForGameType("doom3", "map");
+    auto reader = format->getMapReader(filter);
+
+    try
+    {
+        reader->readFromStream(stream);
+        FAIL() << "Reader should have thrown";
+    }
+    catch (const map::IMapReader::FailureException& ex)
+    {
+        std::string message = ex.what();
+        EXPECT_NE(message.find("Failed parsing entity " + std::to_string(BrokenEntity)), std::string::npos) << message;
+        EXPECT_NE(message.find("Unknown primitive type: brushDef4"), std::string::npos) << message;
+    }
+
+    // The entities in front of the broken one have been inserted, in file order
+    ASSERT_EQ(filter.entities.size(), BrokenEntity);
+
+    for (int i = 1; i < BrokenEntity; ++i)
+    {
+        EXPECT_EQ(Node_getEntity(filter.entities[i])->getKeyValue("name"), "entity_" + std::to_string(i));
+        EXPECT_EQ(filter.primitives[filter.entities[i]].size(), 1);
+    }
+}
+
+// Text that can't be split at the entity boundaries is parsed sequentially, with the same errors
+TEST_F(MapLoadingTest, unbalancedMapTextReportsError)
+{
+    std::stringstream stream(generateEntityMap(10) + "}\n");
+
+    RecordingImportFilter filter;
+    auto format = GlobalMapFormatManager().getMapFormatForGameType("doom3", "map");
+    auto reader = format->getMapReader(filter);
+
+    EXPECT_THROW(reader->readFromStream(stream), parser::ParseException);
+    EXPECT_EQ(filter.entities.size(), 11);
+}
+
 TEST_F(MapSavingTest, saveMapWithoutModification)
 {
     auto tempPath = createMapCopyInTempDataPath("altar.map", "altar_saveMapWithoutModification.map");
@@ -643,6 +881,15 @@ TEST_F(MapSavingTest, saveMapxPreservesLayerInfo)
     doCheckSaveMapPreservesLayerInfo(tempPath.string(), format);
 }
 
+TEST_F(MapSavingTest, saveMapbPreservesLayerInfo)
+{
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "six_brushes_with_layers.mapb";
+    auto format = GlobalMapFormatManager().getMapFormatForFilename(tempPath.string());
+
+    doCheckSaveMapPreservesLayerInfo(tempPath.string(), format);
+}
+
 TEST_F(MapSavingTest, saveAs)
 {
     std::string modRelativePath = "maps/altar.map";
@@ -783,6 +1030,173 @@ TEST_F(MapSavingTest, saveCopyAsMapx)
     EXPECT_EQ(GlobalMapModule().getMapName(), tempPath);
 }
 
+TEST_F(MapSavingTest, saveCopyAsMapb)
+{
+    std::string modRelativePath = "maps/altar.map";
+
+    GlobalCommandSystem().executeCommand("OpenMap", modRelativePath);
+    checkAltarScene();
+
+    // Select the format based on the mapb extension
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "altar_copy.mapb";
+
+    auto format = GlobalMapFormatManager().getMapFormatForFilename(tempPath.string());
+    EXPECT_EQ(format->getMapFormatName(), map::BINARY_MAP_FORMAT_NAME);
+
+    FileSelectionHelper responder(tempPath.string(), format);
+
+    EXPECT_FALSE(os::fileOrDirExists(tempPath));
+
+    GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+
+    // Check that the file got created, the binary format doesn't need an info file
+    EXPECT_TRUE(os::fileOrDirExists(tempPath));
+    EXPECT_FALSE(os::fileOrDirExists(fs::path(tempPath).replace_extension("project")));
+
+    // The map path should NOT have been changed
+    EXPECT_EQ(GlobalMapModule().getMapName(), modRelativePath);
+
+    // Load the binary map and verify the scene
+    GlobalCommandSystem().executeCommand("OpenMap", tempPath.string());
+    checkAltarScene();
+
+    EXPECT_EQ(GlobalMapModule().getMapName(), tempPath);
+}
+
+// Converting a binary working copy back to .map must produce the same text as saving the original map
+TEST_F(MapSavingTest, mapbConvertsLosslesslyToMap)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+    checkAltarScene();
+
+    fs::path directPath = _context.getTemporaryDataPath();
+    directPath /= "altar_direct.map";
+    fs::path binaryPath = _context.getTemporaryDataPath();
+    binaryPath /= "altar_binary.mapb";
+    fs::path convertedPath = _context.getTemporaryDataPath();
+    convertedPath /= "altar_converted.map";
+
+    auto mapFormat = GlobalMapFormatManager().getMapFormatForFilename(directPath.string());
+    auto binaryFormat = GlobalMapFormatManager().getMapFormatForFilename(binaryPath.string());
+
+    {
+        FileSelectionHelper responder(directPath.string(), mapFormat);
+        GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    }
+
+    {
+        FileSelectionHelper responder(binaryPath.string(), binaryFormat);
+        GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    }
+
+    GlobalCommandSystem().executeCommand("OpenMap", binaryPath.string());
+    checkAltarScene();
+
+    {
+        FileSelectionHelper responder(convertedPath.string(), mapFormat);
+        GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    }
+
+    EXPECT_TRUE(os::fileOrDirExists(directPath));
+    EXPECT_TRUE(os::fileOrDirExists(convertedPath));
+    EXPECT_EQ(algorithm::loadFileToString(convertedPath), algorithm::loadFileToString(directPath));
+}
+
+// Patch dimensions which can't be represented by the patch need to be rejected by the reader
+TEST_F(MapSavingTest, mapbWithInvalidPatchDimensionsFailsToLoad)
+{
+    algorithm::createPatchFromBounds(GlobalMapModule().findOrInsertWorldspawn());
+
+    fs::path binaryPath = _context.getTemporaryDataPath();
+    binaryPath /= "single_patch.mapb";
+
+    auto binaryFormat = GlobalMapFormatManager().getMapFormatForFilename(binaryPath.string());
+
+    {
+        FileSelectionHelper responder(binaryPath.string(), binaryFormat);
+        GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    }
+
+    std::ifstream file(binaryPath, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // Patch record tag, no fixed subdivisions, 3x3 control points
+    const std::string patchHeader("\x07\x00\x03\x00\x00\x00\x03\x00\x00\x00", 10);
+    auto widthOffset = contents.find(patchHeader);
+    ASSERT_NE(widthOffset, std::string::npos) << "Patch record not found";
+    widthOffset += 2;
+
+    for (auto width : { 4, 101 })
+    {
+        auto modified = contents;
+        modified[widthOffset] = static_cast<char>(width);
+
+        std::stringstream stream(modified);
+        RecordingImportFilter filter;
+        auto reader = binaryFormat->getMapReader(filter);
+
+        EXPECT_THROW(reader->readFromStream(stream), map::IMapReader::FailureException) << "Width " << width << " should be rejected";
+        EXPECT_TRUE(filter.primitives.empty()) << "No patch should have been imported";
+    }
+
+    fs::remove(binaryPath);
+}
+
+// Compares the save and load times of the text and the binary format on a large map
+TEST_F(MapSavingTest, mapbSaveAndLoadThroughput)
+{
+    constexpr std::size_t NumBrushes = 20000;
+
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brushes = algorithm::createBrushGrid(worldspawn, NumBrushes, 256, 4096);
+
+    {
+        // Spread the brushes over several materials to fill the string table
+        UndoableCommand cmd("assignMaterials");
+
+        for (std::size_t i = 0; i < brushes.size(); ++i)
+        {
+            Node_getIBrush(brushes[i])->setShader("textures/numbers/" + std::to_string(i % 10));
+        }
+    }
+
+    auto expectedChildCount = algorithm::getChildCount(worldspawn);
+    worldspawn.reset();
+    brushes.clear();
+
+    auto measure = [&](const std::string& extension)
+    {
+        fs::path path = _context.getTemporaryDataPath();
+        path /= "large_copy." + extension;
+
+        auto format = GlobalMapFormatManager().getMapFormatForFilename(path.string());
+        FileSelectionHelper responder(path.string(), format);
+
+        util::StopWatch saveTimer;
+        GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+        auto saveTime = saveTimer.getMilliSecondsPassed();
+
+        auto resource = GlobalMapResourceManager().createFromPath(path.string());
+
+        util::StopWatch loadTimer;
+        EXPECT_TRUE(resource->load()) << "Copied map not found: " << path.string();
+        auto loadTime = loadTimer.getMilliSecondsPassed();
+
+        auto loadedWorldspawn = algorithm::findWorldspawn(resource->getRootNode());
+        EXPECT_TRUE(loadedWorldspawn);
+        EXPECT_EQ(algorithm::getChildCount(loadedWorldspawn), expectedChildCount);
+
+        rMessage() << "." << extension << ": " << fs::file_size(path) / 1024 << " kB, saved in " << saveTime
+            << " ms, loaded in " << loadTime << " ms" << std::endl;
+    };
+
+    measure("map");
+    measure("mapb");
+}
+
 // Check that the overwriting an existing map file will create a backup set
 TEST_F(MapSavingTest, saveMapCreatesBackup)
 {
@@ -1261,6 +1675,7 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportRelativePaths)
 
     // Trigger an auto save now
     GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
 
     EXPECT_TRUE(GlobalFileSystem().openTextFile(expectedSnapshotPath)) << "Snapshot should now exist in " << expectedSnapshotPath;
     
@@ -1296,6 +1711,7 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportAbsolutePaths)
 
     // Trigger an auto save now
     GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
 
     EXPECT_TRUE(GlobalFileSystem().openTextFileInAbsolutePath(expectedSnapshotPath)) << "Snapshot should now exist in " << expectedSnapshotPath;
 
@@ -1307,6 +1723,55 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportAbsolutePaths)
     fs::remove(expectedSnapshotPath);
 }
 
+TEST_F(MapSavingTest, AutoSaveInBackground)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+    checkAltarScene();
+
+    // Blow up the map to make the save times measurable
+    algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 20000, 256, 4096);
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "backgroundsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+
+    auto measureAutosave = [&](bool inBackground)
+    {
+        registry::setValue(map::RKEY_AUTOSAVE_IN_BACKGROUND, inBackground);
+
+        util::StopWatch timer;
+        GlobalAutoSaver().performAutosave();
+        auto stallTime = timer.getMilliSecondsPassed();
+
+        GlobalAutoSaver().waitForPendingSave();
+        return stallTime;
+    };
+
+    // The first save fills the serialisation caches of the nodes, measure the two modes after that
+    measureAutosave(false);
+    auto synchronousStall = measureAutosave(false);
+    auto backgroundStall = measureAutosave(true);
+
+    rMessage() << "Autosave blocked the main thread for " << synchronousStall << " ms when writing directly, "
+        << backgroundStall << " ms when writing in the background" << std::endl;
+
+    auto synchronousSnapshot = snapshotFolder + "altar.1.map";
+    auto backgroundSnapshot = snapshotFolder + "altar.2.map";
+
+    EXPECT_TRUE(os::fileOrDirExists(synchronousSnapshot));
+    EXPECT_TRUE(os::fileOrDirExists(backgroundSnapshot));
+    EXPECT_EQ(algorithm::loadFileToString(backgroundSnapshot), algorithm::loadFileToString(synchronousSnapshot));
+    EXPECT_EQ(algorithm::loadFileToString(os::replaceExtension(backgroundSnapshot, "project")),
+        algorithm::loadFileToString(os::replaceExtension(synchronousSnapshot, "project")));
+
+    // The background save leaves the map in a loadable state
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", backgroundSnapshot);
+    checkAltarScene();
+
+    fs::remove_all(snapshotFolder);
+}
+
 namespace
 {
 
@@ -2,6 +2,8 @@
 
 #include "ishaders.h"
 #include <algorithm>
+#include <thread>
+#include <chrono>
 
 #include "string/split.h"
 #include "string/case_conv.h"
@@ -10,6 +12,7 @@
 #include "math/MatrixUtils.h"
 #include "materials/FrobStageSetup.h"
 #include "testutil/TemporaryFile.h"
+#include "registry/registry.h"
 
 namespace test
 {
@@ -2035,4 +2038,120 @@ TEST_F(MaterialsTest, EditorImageUpdatedBeforeMaterialChangedSignalEmission)
     EXPECT_FALSE(material->isEditorImageNoTex()) << "Editor image should have been updated";
 }
 
+
+namespace
+{
+
+inline TexturePtr getDiffuseTexture(const MaterialPtr& material)
+{
+    TexturePtr texture;
+
+    material->foreachLayer([&](const IShaderLayer::Ptr& layer)
+    {
+        if (layer->getType() != IShaderLayer::DIFFUSE) return true;
+
+        texture = layer->getTexture();
+        return false;
+    });
+
+    return texture;
+}
+
+// Uploads the textures loaded in the background, returns false if this takes longer than 10 seconds
+inline bool finishPendingTextureLoads()
+{
+    for (auto i = 0; i < 1000 && GlobalMaterialManager().getNumPendingTextureLoads() > 0; ++i)
+    {
+        GlobalMaterialManager().uploadStreamedTextures(5);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return GlobalMaterialManager().getNumPendingTextureLoads() == 0;
+}
+
+}
+
+TEST_F(MaterialsTest, LayerTextureLoadedSynchronously)
+{
+    registry::setValue(RKEY_TEXTURE_STREAMING, false);
+
+    auto texture = getDiffuseTexture(GlobalMaterialManager().getMaterial("textures/a_1024x512"));
+
+    ASSERT_TRUE(texture) << "No diffuse texture";
+    EXPECT_EQ(texture->getWidth(), 1024) << "Texture should have been loaded right away";
+    EXPECT_EQ(texture->getHeight(), 512) << "Texture should have been loaded right away";
+    EXPECT_EQ(GlobalMaterialManager().getNumPendingTextureLoads(), 0) << "Nothing should be pending";
+}
+
+TEST_F(MaterialsTest, LayerTextureLoadedInBackground)
+{
+    registry::setValue(RKEY_TEXTURE_STREAMING, true);
+
+    auto texture = getDiffuseTexture(GlobalMaterialManager().getMaterial("textures/a_1024x512"));
+
+    ASSERT_TRUE(texture) << "No diffuse texture";
+    EXPECT_EQ(texture->getName(), "textures/a_1024x512");
+    EXPECT_EQ(GlobalMaterialManager().getNumPendingTextureLoads(), 1) << "The texture should be loading";
+
+    // Both materials refer to the same image, it's loaded only once
+    auto otherTexture = getDiffuseTexture(GlobalMaterialManager().getMaterial("textures/b_1024x512"));
+    EXPECT_EQ(otherTexture, texture) << "The texture should be shared";
+    EXPECT_EQ(GlobalMaterialManager().getNumPendingTextureLoads(), 1) << "The texture should be loaded only once";
+
+    // The placeholder is in use until the texture has been uploaded
+    auto placeholderTexNum = texture->getGLTexNum();
+    EXPECT_NE(placeholderTexNum, 0) << "Placeholder should be a valid texture";
+
+    EXPECT_TRUE(finishPendingTextureLoads()) << "The texture should have been uploaded";
+    EXPECT_EQ(texture->getWidth(), 1024) << "Texture should show the loaded image";
+    EXPECT_EQ(texture->getHeight(), 512) << "Texture should show the loaded image";
+    EXPECT_NE(texture->getGLTexNum(), placeholderTexNum) << "Texture should have replaced the placeholder";
+}
+
+TEST_F(MaterialsTest, MissingLayerTextureLoadedInBackground)
+{
+    registry::setValue(RKEY_TEXTURE_STREAMING, true);
+
+    auto material = GlobalMaterialManager().createEmptyMaterial("textures/test/streamed");
+    auto index = material->addLayer(IShaderLayer::DIFFUSE);
+    material->getEditableLayer(index)->setMapExpressionFromString("textures/does_not_exist");
+
+    auto texture = getDiffuseTexture(material);
+    ASSERT_TRUE(texture) << "No diffuse texture";
+
+    auto placeholderTexNum = texture->getGLTexNum();
+
+    EXPECT_TRUE(finishPendingTextureLoads()) << "The load should have finished";
+    EXPECT_NE(texture->getGLTexNum(), placeholderTexNum) << "The missing image should have replaced the placeholder";
+}
+
+TEST_F(MaterialsTest, UnusedTextureEvictedAboveMemoryLimit)
+{
+    registry::setValue(RKEY_TEXTURE_STREAMING, true);
+    registry::setValue(RKEY_TEXTURE_MEMORY_LIMIT, 1);
+
+    auto texture = getDiffuseTexture(GlobalMaterialManager().getMaterial("textures/a_1024x512"));
+    ASSERT_TRUE(texture) << "No diffuse texture";
+
+    EXPECT_TRUE(finishPendingTextureLoads()) << "The texture should have been uploaded";
+    EXPECT_EQ(texture->getWidth(), 1024) << "Texture should show the loaded image";
+
+    // The uploaded image exceeds the limit, but it has just been uploaded
+    GlobalMaterialManager().uploadStreamedTextures(5);
+    EXPECT_EQ(texture->getWidth(), 1024) << "Recently used textures should stay resident";
+
+    // Leave the texture unused for a while
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    GlobalMaterialManager().uploadStreamedTextures(5);
+    EXPECT_EQ(texture->getWidth(), 1) << "Texture should have been evicted, showing the placeholder";
+    EXPECT_EQ(GlobalMaterialManager().getNumPendingTextureLoads(), 0) << "Nothing should be loading";
+
+    // Rendering the texture brings it back
+    texture->getGLTexNum();
+    GlobalMaterialManager().uploadStreamedTextures(5);
+
+    EXPECT_TRUE(finishPendingTextureLoads()) << "The texture should have been uploaded again";
+    EXPECT_EQ(texture->getWidth(), 1024) << "Texture should show the loaded image again";
+}
+
 }
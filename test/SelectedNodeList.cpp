@@ -0,0 +1,261 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include "itextstream.h"
+#include "scene/Node.h"
+#include "selection/SelectedNodeList.h"
+#include "time/StopWatch.h"
+
+namespace test
+{
+
+namespace
+{
+
+class TestNode :
+    public scene::Node
+{
+public:
+    Type getNodeType() const override
+    {
+        return Type::Unknown;
+    }
+
+    const AABB& localAABB() const override
+    {
+        static AABB dummy;
+        return dummy;
+    }
+
+    void onPreRender(const VolumeTest& volume) override
+    {}
+
+    void renderHighlights(IRenderableCollector& collector, const VolumeTest& volume) override
+    {}
+
+    std::size_t getHighlightFlags() override
+    {
+        return 0;
+    }
+};
+
+std::vector<scene::INodePtr> createNodes(std::size_t count)
+{
+    std::vector<scene::INodePtr> nodes;
+    nodes.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        nodes.emplace_back(std::make_shared<TestNode>());
+    }
+
+    return nodes;
+}
+
+std::vector<scene::INodePtr> getContents(SelectedNodeList& list)
+{
+    std::vector<scene::INodePtr> result;
+    list.foreachNode([&](const scene::INodePtr& node) { result.push_back(node); });
+    return result;
+}
+
+}
+
+TEST(SelectedNodeListTest, IteratesInSelectionOrder)
+{
+    auto nodes = createNodes(5);
+    SelectedNodeList list;
+
+    list.append(nodes[3]);
+    list.append(nodes[0]);
+    list.append(nodes[4]);
+    list.append(nodes[1]);
+
+    EXPECT_EQ(list.size(), 4);
+    EXPECT_EQ(getContents(list), (std::vector<scene::INodePtr>{ nodes[3], nodes[0], nodes[4], nodes[1] }));
+    EXPECT_EQ(list.ultimate(), nodes[1]);
+    EXPECT_EQ(list.penultimate(), nodes[4]);
+
+    list.erase(nodes[1]);
+    EXPECT_EQ(list.ultimate(), nodes[4]);
+    EXPECT_EQ(list.penultimate(), nodes[0]);
+
+    list.erase(nodes[0]);
+    EXPECT_EQ(list.penultimate(), nodes[3]);
+    EXPECT_EQ(getContents(list), (std::vector<scene::INodePtr>{ nodes[3], nodes[4] }));
+}
+
+TEST(SelectedNodeListTest, EraseRemovesLatestOccurrence)
+{
+    auto nodes = createNodes(2);
+    SelectedNodeList list;
+
+    // A node with several selected components is added multiple times
+    list.append(nodes[0]);
+    list.append(nodes[1]);
+    list.append(nodes[0]);
+
+    EXPECT_EQ(list.count(nodes[0]), 2);
+    EXPECT_EQ(list.ultimate(), nodes[0]);
+
+    list.erase(nodes[0]);
+
+    EXPECT_EQ(list.count(nodes[0]), 1);
+    EXPECT_EQ(list.ultimate(), nodes[1]);
+    EXPECT_EQ(getContents(list), (std::vector<scene::INodePtr>{ nodes[0], nodes[1] }));
+
+    list.erase(nodes[0]);
+    list.erase(nodes[1]);
+
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.count(nodes[0]), 0);
+}
+
+TEST(SelectedNodeListTest, ErasingDuringIteration)
+{
+    auto nodes = createNodes(200);
+    auto extraNodes = createNodes(10);
+    SelectedNodeList list;
+
+    for (const auto& node : nodes)
+    {
+        list.append(node);
+    }
+
+    std::size_t visited = 0;
+
+    // Erase each node while visiting it, plus every node after an odd one, and append a few
+    list.foreachNode([&](const scene::INodePtr& node)
+    {
+        ++visited;
+
+        auto index = static_cast<std::size_t>(std::find(nodes.begin(), nodes.end(), node) - nodes.begin());
+        ASSERT_LT(index, nodes.size());
+
+        list.erase(node);
+
+        if (index % 2 == 1 && index + 1 < nodes.size())
+        {
+            list.erase(nodes[index + 1]);
+        }
+
+        if (index < extraNodes.size())
+        {
+            list.append(extraNodes[index]);
+        }
+    });
+
+    // The erased nodes are skipped, the appended ones not visited
+    EXPECT_EQ(visited, 101);
+
+    // Nodes 0, 1, 3, 5, 7, 9 have been visited, each of them appended an extra node
+    EXPECT_EQ(getContents(list), (std::vector<scene::INodePtr>{
+        extraNodes[0], extraNodes[1], extraNodes[3], extraNodes[5], extraNodes[7], extraNodes[9] }));
+    EXPECT_EQ(list.ultimate(), extraNodes[9]);
+    EXPECT_EQ(list.penultimate(), extraNodes[7]);
+}
+
+TEST(SelectedNodeListTest, CompactionKeepsOrder)
+{
+    auto nodes = createNodes(1000);
+    SelectedNodeList list;
+
+    for (const auto& node : nodes)
+    {
+        list.append(node);
+    }
+
+    // Add a second occurrence of some nodes
+    for (std::size_t i = 0; i < nodes.size(); i += 100)
+    {
+        list.append(nodes[i]);
+    }
+
+    std::vector<scene::INodePtr> expected;
+
+    // Erase most of the nodes from the front, this triggers several compactions
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (i % 7 != 0)
+        {
+            list.erase(nodes[i]);
+        }
+    }
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        // Nodes with a second occurrence are left at their first position
+        if (i % 7 == 0 || i % 100 == 0)
+        {
+            expected.push_back(nodes[i]);
+        }
+    }
+
+    for (std::size_t i = 0; i < nodes.size(); i += 100)
+    {
+        if (i % 7 == 0)
+        {
+            expected.push_back(nodes[i]);
+        }
+    }
+
+    EXPECT_EQ(list.size(), expected.size());
+    EXPECT_EQ(getContents(list), expected);
+    EXPECT_EQ(list.ultimate(), expected.back());
+    EXPECT_EQ(list.penultimate(), expected[expected.size() - 2]);
+}
+
+// Times building, walking and clearing large selections
+TEST(SelectedNodeListTest, Benchmark)
+{
+    for (std::size_t count : { 1000, 10000, 100000 })
+    {
+        auto nodes = createNodes(count);
+        SelectedNodeList list;
+
+        util::StopWatch timer;
+
+        for (const auto& node : nodes)
+        {
+            list.append(node);
+        }
+
+        auto appendTime = timer.getMilliSecondsPassed();
+        timer.restart();
+
+        std::size_t visited = 0;
+
+        for (int pass = 0; pass < 10; ++pass)
+        {
+            list.foreachNode([&](const scene::INodePtr&) { ++visited; });
+        }
+
+        auto walkTime = timer.getMilliSecondsPassed();
+        timer.restart();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            list.ultimate();
+        }
+
+        auto ultimateTime = timer.getMilliSecondsPassed();
+        timer.restart();
+
+        // Deselect in a different order than the selection, like a scene traversal would
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            list.erase(nodes[(i * 7919) % count]);
+        }
+
+        auto eraseTime = timer.getMilliSecondsPassed();
+
+        EXPECT_EQ(visited, count * 10);
+        EXPECT_TRUE(list.empty());
+
+        rMessage() << "SelectedNodeList with " << count << " nodes: append " << appendTime <<
+            " ms, 10 walks " << walkTime << " ms, " << count << "x ultimate " << ultimateTime <<
+            " ms, erase " << eraseTime << " ms" << std::endl;
+    }
+}
+
+}
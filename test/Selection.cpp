@@ -24,6 +24,7 @@
 #include "algorithm/XmlUtils.h"
 #include "command/ExecutionNotPossible.h"
 #include "scene/Group.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -392,6 +393,155 @@ TEST_F(SelectionTest, DeselectCommandLeavesFocus)
     EXPECT_EQ(GlobalSelectionSystem().countSelected(), 0);
 }
 
+namespace
+{
+
+// Records the individual and the batched selection change notifications
+class RecordingSelectionObserver :
+    public selection::SelectionSystem::Observer
+{
+public:
+    std::size_t numSingleChanges = 0;
+    std::vector<std::vector<scene::INodePtr>> batches;
+
+    RecordingSelectionObserver()
+    {
+        GlobalSelectionSystem().addObserver(this);
+    }
+
+    ~RecordingSelectionObserver() override
+    {
+        GlobalSelectionSystem().removeObserver(this);
+    }
+
+    void selectionChanged(const scene::INodePtr& node, bool isComponent) override
+    {
+        if (!isComponent) ++numSingleChanges;
+    }
+
+    void selectionBatchChanged(const std::vector<scene::INodePtr>& nodes, bool isComponent) override
+    {
+        if (!isComponent) batches.push_back(nodes);
+    }
+};
+
+}
+
+TEST_F(SelectionTest, SelectionChangesOutsideTransactionAreNotifiedIndividually)
+{
+    auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 3, 32);
+
+    RecordingSelectionObserver observer;
+    std::size_t signalCount = 0;
+    auto conn = GlobalSelectionSystem().signal_selectionChanged().connect([&](const ISelectable&) { ++signalCount; });
+
+    for (const auto& brush : brushes)
+    {
+        Node_setSelected(brush, true);
+    }
+
+    EXPECT_EQ(signalCount, 3);
+    EXPECT_EQ(observer.numSingleChanges, 3);
+    EXPECT_TRUE(observer.batches.empty());
+
+    conn.disconnect();
+}
+
+TEST_F(SelectionTest, SelectionChangeTransactionNotifiesOnce)
+{
+    auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 10, 32);
+    Node_setSelected(brushes[9], true);
+
+    RecordingSelectionObserver observer;
+    std::size_t signalCount = 0;
+    auto conn = GlobalSelectionSystem().signal_selectionChanged().connect([&](const ISelectable&) { ++signalCount; });
+
+    {
+        selection::SelectionChangeTransaction transaction;
+
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            Node_setSelected(brushes[i], true);
+        }
+
+        {
+            // Nested transactions are merged into the outer one
+            selection::SelectionChangeTransaction nested;
+            Node_setSelected(brushes[9], false);
+            Node_setSelected(brushes[0], false);
+            Node_setSelected(brushes[0], true);
+        }
+
+        // The selection state is up to date within the transaction
+        EXPECT_EQ(GlobalSelectionSystem().countSelected(), 5);
+        EXPECT_EQ(GlobalSelectionSystem().getSelectionInfo().brushCount, 5);
+        EXPECT_EQ(GlobalSelectionSystem().ultimateSelected(), brushes[0]);
+        EXPECT_EQ(signalCount, 0);
+        EXPECT_TRUE(observer.batches.empty());
+    }
+
+    EXPECT_EQ(signalCount, 1);
+    EXPECT_EQ(observer.numSingleChanges, 0);
+
+    // Every changed node is reported once, in order of the first change
+    ASSERT_EQ(observer.batches.size(), 1);
+    EXPECT_EQ(observer.batches[0], (std::vector<scene::INodePtr>{
+        brushes[0], brushes[1], brushes[2], brushes[3], brushes[4], brushes[9] }));
+
+    conn.disconnect();
+}
+
+TEST_F(SelectionTest, SelectAllIsSingleSelectionChange)
+{
+    auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 50, 32);
+
+    RecordingSelectionObserver observer;
+    std::size_t signalCount = 0;
+    auto conn = GlobalSelectionSystem().signal_selectionChanged().connect([&](const ISelectable&) { ++signalCount; });
+
+    GlobalSelectionSystem().setSelectedAll(true);
+
+    expectNodeSelectionStatus(brushes, {});
+    EXPECT_EQ(signalCount, 1);
+    ASSERT_EQ(observer.batches.size(), 1);
+    EXPECT_EQ(observer.batches[0].size(), GlobalSelectionSystem().countSelected());
+
+    GlobalCommandSystem().executeCommand("InvertSelection");
+    expectNodeSelectionStatus({}, brushes);
+    EXPECT_EQ(signalCount, 2);
+    EXPECT_EQ(observer.batches.size(), 2);
+
+    conn.disconnect();
+}
+
+// Times select all and deselect all on a larger number of nodes
+TEST_F(SelectionTest, SelectAllDeselectAllBenchmark)
+{
+    constexpr std::size_t NumBrushes = 10000;
+    algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), NumBrushes, 32);
+
+    std::size_t signalCount = 0;
+    auto conn = GlobalSelectionSystem().signal_selectionChanged().connect([&](const ISelectable&) { ++signalCount; });
+
+    util::StopWatch timer;
+    GlobalSelectionSystem().setSelectedAll(true);
+    auto selectTime = timer.getMilliSecondsPassed();
+
+    EXPECT_GE(GlobalSelectionSystem().countSelected(), NumBrushes);
+
+    timer.restart();
+    GlobalSelectionSystem().setSelectedAll(false);
+    auto deselectTime = timer.getMilliSecondsPassed();
+
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 0);
+    EXPECT_EQ(signalCount, 2);
+
+    rMessage() << "Select all of " << NumBrushes << " brushes: " << selectTime << " ms, deselect all: "
+        << deselectTime << " ms" << std::endl;
+
+    conn.disconnect();
+}
+
 class ViewSelectionTest :
     public SelectionTest
 {
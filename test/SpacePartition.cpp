@@ -0,0 +1,520 @@
+#include "RadiantTest.h"
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <set>
+#include "iscenegraph.h"
+#include "iscenegraphfactory.h"
+#include "ispacepartition.h"
+#include "itextstream.h"
+#include "scene/BasicRootNode.h"
+#include "scene/Node.h"
+#include "scenelib.h"
+#include "registry/registry.h"
+#include "render/View.h"
+#include "time/StopWatch.h"
+#include "algorithm/View.h"
+
+namespace test
+{
+
+using SpacePartitionTest = RadiantTest;
+
+namespace
+{
+
+// Scene node with freely assignable local bounds
+class BoundsTestNode :
+    public scene::Node
+{
+private:
+    AABB _bounds;
+
+public:
+    BoundsTestNode(const AABB& bounds) :
+        _bounds(bounds)
+    {}
+
+    Type getNodeType() const override
+    {
+        return Type::Unknown;
+    }
+
+    const AABB& localAABB() const override
+    {
+        return _bounds;
+    }
+
+    void setBounds(const AABB& bounds)
+    {
+        _bounds = bounds;
+        boundsChanged();
+    }
+
+    void onPreRender(const VolumeTest& volume) override
+    {}
+
+    void renderHighlights(IRenderableCollector& collector, const VolumeTest& volume) override
+    {}
+
+    std::size_t getHighlightFlags() override
+    {
+        return 0;
+    }
+};
+
+constexpr std::size_t NumTestNodes = 20000;
+constexpr double TestWorldExtents = 16384;
+
+AABB createRandomBounds(std::minstd_rand& rand)
+{
+    std::uniform_real_distribution<double> position(-TestWorldExtents, TestWorldExtents);
+    std::uniform_real_distribution<double> size(4, 256);
+
+    return AABB(Vector3(position(rand), position(rand), position(rand)), Vector3(size(rand), size(rand), size(rand)));
+}
+
+// A scene with its own root, using the given space partition type
+struct TestScene
+{
+    scene::GraphPtr graph;
+    scene::IMapRootNodePtr root;
+    std::vector<std::shared_ptr<BoundsTestNode>> nodes;
+
+    TestScene(const std::string& partitionType)
+    {
+        registry::setValue(scene::RKEY_SPACE_PARTITION_TYPE, partitionType);
+
+        graph = GlobalSceneGraphFactory().createSceneGraph();
+        root = std::make_shared<scene::BasicRootNode>();
+        graph->setRoot(root);
+    }
+
+    ~TestScene()
+    {
+        graph->setRoot(scene::IMapRootNodePtr());
+    }
+
+    void populate(std::size_t numNodes)
+    {
+        std::minstd_rand rand(17);
+
+        for (std::size_t i = 0; i < numNodes; ++i)
+        {
+            auto node = std::make_shared<BoundsTestNode>(createRandomBounds(rand));
+            scene::addNodeToContainer(node, root);
+            nodes.push_back(node);
+        }
+
+        // Evaluate the bounds, this links the nodes into the proper octants
+        root->worldAABB();
+    }
+};
+
+std::size_t countMembers(const scene::ISPNodePtr& node)
+{
+    auto count = node->getMembers().size();
+
+    for (const auto& child : node->getChildNodes())
+    {
+        EXPECT_EQ(child->getParent(), node) << "Parent/child relationship broken";
+        EXPECT_TRUE(node->getBounds().contains(child->getBounds())) << "Child octant exceeds the parent bounds";
+        count += countMembers(child);
+    }
+
+    return count;
+}
+
+std::set<scene::INodePtr> getNodesInVolume(scene::Graph& graph, const VolumeTest& volume)
+{
+    std::set<scene::INodePtr> result;
+
+    graph.foreachNodeInVolume(volume, [&](const scene::INodePtr& node)
+    {
+        result.insert(node);
+        return true;
+    });
+
+    return result;
+}
+
+// Thread-safe chunk walker collecting all visited nodes
+class CollectingChunkWalker :
+    public scene::Graph::ChunkWalker
+{
+private:
+    std::mutex _lock;
+
+public:
+    std::set<scene::INodePtr> nodes;
+    std::size_t numChunks = 0;
+
+    bool isThreadSafe() const override
+    {
+        return true;
+    }
+
+    void visitChunk(const std::vector<scene::INodePtr>& chunk) override
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        EXPECT_FALSE(chunk.empty()) << "Empty chunks should not be delivered";
+
+        nodes.insert(chunk.begin(), chunk.end());
+        ++numChunks;
+    }
+};
+
+void createQueryView(render::View& view)
+{
+    algorithm::constructCenteredOrthoview(view, Vector3(2048, -1024, 0));
+}
+
+}
+
+TEST_F(SpacePartitionTest, AllNodesAreLinkedOnce)
+{
+    for (auto type : { "octree", "flatOctree" })
+    {
+        TestScene scene(type);
+        scene.populate(NumTestNodes);
+
+        // All nodes plus the root node
+        EXPECT_EQ(countMembers(scene.graph->getSpacePartition()->getRoot()), NumTestNodes + 1) << "Member count mismatch in " << type;
+
+        // Unlinking is successful exactly once
+        auto& node = scene.nodes.front();
+        EXPECT_TRUE(scene.graph->getSpacePartition()->unlink(node)) << type;
+        EXPECT_FALSE(scene.graph->getSpacePartition()->unlink(node)) << type;
+        EXPECT_EQ(countMembers(scene.graph->getSpacePartition()->getRoot()), NumTestNodes) << type;
+    }
+}
+
+TEST_F(SpacePartitionTest, NodesAreRelinkedAfterBoundsChange)
+{
+    for (auto type : { "octree", "flatOctree" })
+    {
+        TestScene scene(type);
+        scene.populate(NumTestNodes);
+
+        render::View view(false);
+        createQueryView(view);
+
+        // Move all nodes far away from the queried area
+        for (const auto& node : scene.nodes)
+        {
+            node->setBounds(AABB(Vector3(-12000, -12000, 100), Vector3(8, 8, 8)));
+            node->worldAABB();
+        }
+
+        auto nodesInVolume = getNodesInVolume(*scene.graph, view);
+
+        for (const auto& node : scene.nodes)
+        {
+            EXPECT_EQ(nodesInVolume.count(node), 0) << "Node should have been culled in " << type;
+        }
+
+        EXPECT_EQ(countMembers(scene.graph->getSpacePartition()->getRoot()), NumTestNodes + 1) << type;
+    }
+}
+
+TEST_F(SpacePartitionTest, FlatOctreeMatchesOctree)
+{
+    render::View view(false);
+    createQueryView(view);
+
+    TestScene octree("octree");
+    octree.populate(NumTestNodes);
+
+    TestScene flatOctree("flatOctree");
+    flatOctree.populate(NumTestNodes);
+
+    auto octreeNodes = getNodesInVolume(*octree.graph, view);
+    auto flatOctreeNodes = getNodesInVolume(*flatOctree.graph, view);
+
+    // Both scenes have been populated with the same random sequence,
+    // compare the visited nodes by their index
+    std::set<std::size_t> octreeIndices;
+    std::set<std::size_t> flatOctreeIndices;
+
+    for (std::size_t i = 0; i < NumTestNodes; ++i)
+    {
+        if (octreeNodes.count(octree.nodes[i]) > 0) octreeIndices.insert(i);
+        if (flatOctreeNodes.count(flatOctree.nodes[i]) > 0) flatOctreeIndices.insert(i);
+    }
+
+    EXPECT_FALSE(octreeIndices.empty()) << "Query volume should contain some nodes";
+    EXPECT_LT(octreeIndices.size(), NumTestNodes) << "Query volume should have culled some nodes";
+    EXPECT_EQ(octreeIndices, flatOctreeIndices) << "Both partitions should deliver the same nodes";
+}
+
+// Benchmark comparing the link/unlink/relink throughput of both partitions
+TEST_F(SpacePartitionTest, LinkUnlinkRelinkThroughput)
+{
+    for (auto type : { "octree", "flatOctree" })
+    {
+        TestScene scene(type);
+        scene.populate(NumTestNodes);
+
+        auto spacePartition = scene.graph->getSpacePartition();
+
+        util::StopWatch timer;
+
+        for (const auto& node : scene.nodes)
+        {
+            spacePartition->unlink(node);
+        }
+
+        auto unlinkTime = timer.getMilliSecondsPassed();
+        timer.restart();
+
+        for (const auto& node : scene.nodes)
+        {
+            spacePartition->link(node);
+        }
+
+        auto linkTime = timer.getMilliSecondsPassed();
+
+        // Relink every node after moving it around, like a drag operation would
+        std::minstd_rand rand(42);
+        timer.restart();
+
+        for (int pass = 0; pass < 5; ++pass)
+        {
+            for (const auto& node : scene.nodes)
+            {
+                node->setBounds(createRandomBounds(rand));
+                node->worldAABB();
+            }
+
+            // Process the queued relinks
+            scene.graph->getSpacePartition();
+        }
+
+        auto relinkTime = timer.getMilliSecondsPassed();
+
+        rMessage() << "[" << type << "] " << NumTestNodes << " nodes: unlink " << unlinkTime << " ms, link " <<
+            linkTime << " ms, 5x relink " << relinkTime << " ms" << std::endl;
+
+        EXPECT_EQ(countMembers(spacePartition->getRoot()), NumTestNodes + 1) << type;
+    }
+}
+
+TEST_F(SpacePartitionTest, PendingRelinksAreFlushedBeforeQuery)
+{
+    TestScene scene("octree");
+    scene.populate(NumTestNodes);
+
+    render::View view(false);
+    createQueryView(view);
+
+    // Move every node several times, the last location should win
+    for (const auto& node : scene.nodes)
+    {
+        node->setBounds(AABB(Vector3(2048, -1024, 100), Vector3(8, 8, 8)));
+        node->worldAABB();
+        node->setBounds(AABB(Vector3(-12000, -12000, 100), Vector3(8, 8, 8)));
+        node->worldAABB();
+    }
+
+    auto nodesInVolume = getNodesInVolume(*scene.graph, view);
+
+    for (const auto& node : scene.nodes)
+    {
+        EXPECT_EQ(nodesInVolume.count(node), 0) << "Node should have been culled";
+    }
+
+    // Erasing a node with a pending relink must not link it again
+    auto node = scene.nodes.front();
+    node->setBounds(AABB(Vector3(2048, -1024, 100), Vector3(8, 8, 8)));
+    node->worldAABB();
+    scene::removeNodeFromParent(node);
+
+    EXPECT_EQ(countMembers(scene.graph->getSpacePartition()->getRoot()), NumTestNodes) << "Erased node got re-linked";
+}
+
+// Benchmark comparing immediate per-node relinking to batched relinking,
+// with every node changing its bounds several times per frame
+TEST_F(SpacePartitionTest, PerNodeVersusBatchedRelink)
+{
+    constexpr int NumFrames = 5;
+    constexpr int BoundsChangesPerFrame = 3;
+
+    for (auto type : { "octree", "flatOctree" })
+    {
+        TestScene scene(type);
+        scene.populate(NumTestNodes);
+
+        std::minstd_rand rand(42);
+        util::StopWatch timer;
+
+        for (int frame = 0; frame < NumFrames; ++frame)
+        {
+            for (const auto& node : scene.nodes)
+            {
+                for (int i = 0; i < BoundsChangesPerFrame; ++i)
+                {
+                    node->setBounds(createRandomBounds(rand));
+                    node->worldAABB();
+
+                    // Acquiring the partition processes the relink right away
+                    scene.graph->getSpacePartition();
+                }
+            }
+        }
+
+        auto perNodeTime = timer.getMilliSecondsPassed();
+        timer.restart();
+
+        for (int frame = 0; frame < NumFrames; ++frame)
+        {
+            for (const auto& node : scene.nodes)
+            {
+                for (int i = 0; i < BoundsChangesPerFrame; ++i)
+                {
+                    node->setBounds(createRandomBounds(rand));
+                    node->worldAABB();
+                }
+            }
+
+            // One relink batch per frame
+            scene.graph->getSpacePartition();
+        }
+
+        auto batchedTime = timer.getMilliSecondsPassed();
+
+        rMessage() << "[" << type << "] " << NumFrames << " frames, " << NumTestNodes << " nodes with " <<
+            BoundsChangesPerFrame << " bounds changes each: per-node " << perNodeTime <<
+            " ms, batched " << batchedTime << " ms" << std::endl;
+
+        EXPECT_EQ(countMembers(scene.graph->getSpacePartition()->getRoot()), NumTestNodes + 1) << type;
+    }
+}
+
+TEST_F(SpacePartitionTest, ParallelVolumeTraversal)
+{
+    for (auto type : { "octree", "flatOctree" })
+    {
+        TestScene scene(type);
+        scene.populate(NumTestNodes);
+
+        render::View view(false);
+        createQueryView(view);
+
+        auto sequentialNodes = getNodesInVolume(*scene.graph, view);
+
+        CollectingChunkWalker walker;
+        scene.graph->foreachNodeInVolumeParallel(view, walker);
+
+        EXPECT_GT(walker.numChunks, 1) << "Nodes should have been delivered in several chunks";
+
+        // The parallel traversal visits the subset of nodes actually intersecting the volume
+        for (const auto& node : sequentialNodes)
+        {
+            auto intersects = view.TestAABB(node->worldAABB()) != VOLUME_OUTSIDE;
+            EXPECT_EQ(walker.nodes.count(node), intersects ? 1 : 0) << "Parallel traversal mismatch in " << type;
+        }
+
+        for (const auto& node : walker.nodes)
+        {
+            EXPECT_EQ(sequentialNodes.count(node), 1) << "Parallel traversal visited a culled node in " << type;
+        }
+    }
+}
+
+// Benchmark comparing sequential and parallel volume traversal with a visitor testing node bounds
+TEST_F(SpacePartitionTest, ParallelVolumeTraversalLatency)
+{
+    constexpr int NumQueries = 100;
+
+    TestScene scene("octree");
+    scene.populate(NumTestNodes);
+
+    render::View view(false);
+    createQueryView(view);
+
+    std::size_t intersecting = 0;
+    util::StopWatch timer;
+
+    for (int i = 0; i < NumQueries; ++i)
+    {
+        scene.graph->foreachNodeInVolume(view, [&](const scene::INodePtr& node)
+        {
+            if (view.TestAABB(node->worldAABB()) != VOLUME_OUTSIDE)
+            {
+                ++intersecting;
+            }
+            return true;
+        });
+    }
+
+    auto sequentialTime = timer.getMilliSecondsPassed();
+
+    class CountingWalker :
+        public scene::Graph::ChunkWalker
+    {
+    public:
+        std::atomic<std::size_t> count = 0;
+
+        bool isThreadSafe() const override
+        {
+            return true;
+        }
+
+        void visitChunk(const std::vector<scene::INodePtr>& chunk) override
+        {
+            count += chunk.size();
+        }
+    } walker;
+
+    timer.restart();
+
+    for (int i = 0; i < NumQueries; ++i)
+    {
+        scene.graph->foreachNodeInVolumeParallel(view, walker);
+    }
+
+    auto parallelTime = timer.getMilliSecondsPassed();
+
+    rMessage() << NumQueries << " volume queries over " << NumTestNodes << " nodes: sequential " <<
+        sequentialTime << " ms, parallel " << parallelTime << " ms" << std::endl;
+
+    EXPECT_EQ(walker.count.load(), intersecting) << "Both traversals should find the same nodes";
+}
+
+// Benchmark measuring the foreachNodeInVolume latency of both partitions
+TEST_F(SpacePartitionTest, VolumeQueryLatency)
+{
+    constexpr int NumQueries = 100;
+
+    render::View view(false);
+    createQueryView(view);
+
+    for (auto type : { "octree", "flatOctree" })
+    {
+        TestScene scene(type);
+        scene.populate(NumTestNodes);
+
+        std::size_t visitedNodes = 0;
+        util::StopWatch timer;
+
+        for (int i = 0; i < NumQueries; ++i)
+        {
+            scene.graph->foreachNodeInVolume(view, [&](const scene::INodePtr& node)
+            {
+                ++visitedNodes;
+                return true;
+            });
+        }
+
+        auto queryTime = timer.getMilliSecondsPassed();
+
+        rMessage() << "[" << type << "] " << NumQueries << " volume queries over " << NumTestNodes <<
+            " nodes: " << queryTime << " ms, " << (visitedNodes / NumQueries) << " nodes per query" << std::endl;
+
+        EXPECT_GT(visitedNodes, 0) << type;
+    }
+}
+
+}
@@ -14,6 +14,9 @@
 #include "scenelib.h"
 #include "scene/BasicRootNode.h"
 #include "testutil/FileSelectionHelper.h"
+#include "registry/registry.h"
+#include "time/StopWatch.h"
+#include "undo/UndoSystem.h"
 
 namespace test
 {
@@ -872,4 +875,198 @@ TEST_F(UndoTest, OperationTracking)
     EXPECT_EQ(tracker.receivedOperationName, "") << "Nothing should fire, already detached";
 }
 
+namespace
+{
+
+// Undoes operations until there is nothing left to undo, returns the number of undone operations
+std::size_t undoAllOperations()
+{
+    std::size_t count = 0;
+
+    auto conn = GlobalUndoSystem().signal_undoEvent().connect([&](IUndoSystem::EventType type, const std::string&)
+    {
+        if (type == IUndoSystem::EventType::OperationUndone) ++count;
+    });
+
+    for (auto previous = count + 1; previous != count;)
+    {
+        previous = count;
+        GlobalUndoSystem().undo();
+    }
+
+    conn.disconnect();
+    return count;
+}
+
+}
+
+TEST_F(UndoTest, MemoryUsageIsReported)
+{
+    auto& undoSystem = GlobalUndoSystem();
+    undoSystem.clear();
+
+    EXPECT_EQ(undoSystem.getMemoryUsage(), 0) << "Empty undo system should not report any memory";
+
+    {
+        UndoableCommand cmd("createBrushes");
+        auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 10, 32);
+
+        for (const auto& brush : brushes)
+        {
+            Node_setSelected(brush, true);
+        }
+    }
+
+    auto usageAfterCreation = undoSystem.getMemoryUsage();
+    EXPECT_GT(usageAfterCreation, 0) << "Recorded operation should occupy memory";
+
+    GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(16, 0, 0)));
+
+    // 10 brushes with 6 faces each have been saved
+    auto usageAfterMove = undoSystem.getMemoryUsage();
+    EXPECT_GT(usageAfterMove, usageAfterCreation + 60 * sizeof(Plane3)) << "Moved faces should have been recorded";
+
+    // The redo stack is included too
+    undoSystem.undo();
+    EXPECT_GT(undoSystem.getMemoryUsage(), usageAfterCreation);
+
+    undoSystem.clear();
+    EXPECT_EQ(undoSystem.getMemoryUsage(), 0) << "Cleared undo system should not report any memory";
+}
+
+TEST_F(UndoTest, MemoryLimitDiscardsOldestOperations)
+{
+    auto& undoSystem = GlobalUndoSystem();
+
+    auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 1000, 32);
+
+    for (const auto& brush : brushes)
+    {
+        Node_setSelected(brush, true);
+    }
+    auto originalOrigin = brushes.front()->worldAABB().getOrigin();
+
+    undoSystem.clear();
+    registry::setValue(undo::RKEY_UNDO_MEMORY_LIMIT, 4);
+
+    constexpr std::size_t NumMoves = 20;
+
+    for (std::size_t i = 0; i < NumMoves; ++i)
+    {
+        GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(16, 0, 0)));
+    }
+
+    EXPECT_LE(undoSystem.getMemoryUsage(), 4 * 1024 * 1024) << "Memory limit exceeded";
+
+    auto numUndone = undoAllOperations();
+
+    EXPECT_GT(numUndone, 1) << "More than one operation should fit into the limit";
+    EXPECT_LT(numUndone, NumMoves) << "The oldest operations should have been discarded";
+
+    // The remaining operations have been reverted, the discarded ones stay in effect
+    EXPECT_EQ(brushes.front()->worldAABB().getOrigin(), originalOrigin + Vector3(16.0 * (NumMoves - numUndone), 0, 0));
+
+    // Without a limit, all operations are kept
+    registry::setValue(undo::RKEY_UNDO_MEMORY_LIMIT, 0);
+    undoSystem.clear();
+
+    for (std::size_t i = 0; i < NumMoves; ++i)
+    {
+        GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(16, 0, 0)));
+    }
+
+    EXPECT_EQ(undoAllOperations(), NumMoves);
+}
+
+TEST_F(UndoTest, MemoryLimitCountsSharedFaceState)
+{
+    auto& undoSystem = GlobalUndoSystem();
+
+    auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 5000, 32);
+
+    for (const auto& brush : brushes)
+    {
+        Node_setSelected(brush, true);
+    }
+
+    undoSystem.clear();
+    registry::setValue(undo::RKEY_UNDO_MEMORY_LIMIT, 0);
+
+    GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(16, 0, 0)));
+    auto usageOfSingleOperation = undoSystem.getMemoryUsage();
+
+    // A single operation exceeds the limit, so only the most recent one is kept
+    undoSystem.clear();
+    registry::setValue(undo::RKEY_UNDO_MEMORY_LIMIT, 1);
+
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(16, 0, 0)));
+    }
+
+    auto usage = undoSystem.getMemoryUsage();
+    EXPECT_EQ(undoAllOperations(), 1) << "Only the most recent operation should have been kept";
+
+    // The discarded operations allocated the texture and material information
+    // which is still referenced by the remaining one
+    EXPECT_GE(usage, usageOfSingleOperation) << "Face state kept alive by the remaining operation is not accounted for";
+}
+
+// Records 500 transforms of 10k brushes and reports the memory used by the undo stack
+TEST_F(UndoTest, TransformMemoryBenchmark)
+{
+    auto& undoSystem = GlobalUndoSystem();
+
+    auto brushes = algorithm::createBrushGrid(GlobalMapModule().findOrInsertWorldspawn(), 10000, 32);
+
+    for (const auto& brush : brushes)
+    {
+        Node_setSelected(brush, true);
+    }
+    auto originalOrigin = brushes.front()->worldAABB().getOrigin();
+
+    constexpr std::size_t NumTransforms = 500;
+    constexpr std::size_t MemoryLimit = 256;
+
+    undoSystem.clear();
+    registry::setValue(undo::RKEY_UNDO_QUEUE_SIZE, NumTransforms);
+    registry::setValue(undo::RKEY_UNDO_MEMORY_LIMIT, MemoryLimit);
+
+    util::StopWatch timer;
+    std::size_t usageAfterFirstTransform = 0;
+
+    for (std::size_t i = 0; i < NumTransforms; ++i)
+    {
+        GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(0, 0, i % 2 == 0 ? 8 : -8)));
+
+        if (i == 0)
+        {
+            usageAfterFirstTransform = undoSystem.getMemoryUsage();
+        }
+
+        ASSERT_LE(undoSystem.getMemoryUsage(), MemoryLimit * 1024 * 1024) << "Memory limit exceeded";
+    }
+
+    auto recordingTime = timer.getMilliSecondsPassed();
+    auto usage = undoSystem.getMemoryUsage();
+
+    timer.restart();
+    auto numUndone = undoAllOperations();
+    auto undoTime = timer.getMilliSecondsPassed();
+
+    rMessage() << NumTransforms << " transforms of " << brushes.size() << " brushes recorded in " << recordingTime <<
+        " ms, " << numUndone << " operations kept in " << (usage / 1024) << " kB (first operation: " <<
+        (usageAfterFirstTransform / 1024) << " kB), undone in " << undoTime << " ms" << std::endl;
+
+    EXPECT_GT(numUndone, 1);
+
+    // Subsequent operations share the texture and material information of the first one,
+    // the reported usage is an upper bound and should not grow beyond that of the first
+    EXPECT_LE(usage / numUndone, usageAfterFirstTransform) << "Recorded operations should not grow";
+
+    // The moves that have been discarded stay in effect
+    auto numDiscarded = NumTransforms - numUndone;
+    EXPECT_EQ(brushes.front()->worldAABB().getOrigin(), originalOrigin + Vector3(0, 0, numDiscarded % 2 == 0 ? 0 : 8));
+}
+
 }
@@ -1,8 +1,13 @@
 #include "RadiantTest.h"
 
 #include "ifilesystem.h"
+#include "idatastream.h"
 #include "os/path.h"
 #include "os/file.h"
+#include "time/StopWatch.h"
+
+#include <future>
+#include <random>
 
 namespace test
 {
@@ -240,4 +245,102 @@ TEST_F(VfsTest, GetFileInfo)
     EXPECT_EQ(info.visibility, vfs::Visibility::HIDDEN);
 }
 
+TEST_F(VfsTest, PakFileLookupIsCaseInsensitive)
+{
+    // This file is in tdm_example_mtrs.pk4
+    EXPECT_EQ(GlobalFileSystem().getFileCount("Materials/TDM_Bloom_AFX.mtr"), 1);
+    EXPECT_TRUE(GlobalFileSystem().openFile("Materials/TDM_Bloom_AFX.mtr"));
+    EXPECT_TRUE(GlobalFileSystem().openTextFile("MATERIALS/tdm_bloom_afx.mtr"));
+    EXPECT_FALSE(GlobalFileSystem().getFileInfo("materials/TDM_BLOOM_AFX.mtr").isEmpty());
+
+    // PK4 files are not reported by findFile
+    EXPECT_EQ(GlobalFileSystem().findFile("materials/tdm_bloom_afx.mtr"), "");
+}
+
+TEST_F(VfsTest, OpenRandomAssets)
+{
+    constexpr std::size_t NumOpenedFiles = 50000;
+
+    std::vector<std::string> allFiles;
+    GlobalFileSystem().forEachFile("", "*", [&](const vfs::FileInfo& fi) { allFiles.push_back(fi.name); }, 0);
+
+    ASSERT_FALSE(allFiles.empty());
+
+    std::minstd_rand rand(17);
+    std::uniform_int_distribution<std::size_t> distribution(0, allFiles.size() - 1);
+
+    std::size_t openedFiles = 0;
+    util::StopWatch timer;
+
+    for (std::size_t i = 0; i < NumOpenedFiles; ++i)
+    {
+        if (GlobalFileSystem().openFile(allFiles[distribution(rand)]))
+        {
+            ++openedFiles;
+        }
+    }
+
+    rMessage() << "Opened " << NumOpenedFiles << " random files out of " << allFiles.size() <<
+        " in " << timer.getMilliSecondsPassed() << " msec" << std::endl;
+
+    EXPECT_EQ(openedFiles, NumOpenedFiles) << "All visited files should be openable";
+}
+
+inline std::string readArchiveFile(const ArchiveFilePtr& file)
+{
+    std::string contents;
+    StreamBase::byte_type buffer[512];
+
+    for (std::size_t bytesRead; (bytesRead = file->getInputStream().read(buffer, sizeof(buffer))) > 0; )
+    {
+        contents.append(reinterpret_cast<const char*>(buffer), bytesRead);
+    }
+
+    return contents;
+}
+
+TEST_F(VfsTest, ConcurrentReadsFromPakFile)
+{
+    // Both files are in tdm_example_mtrs.pk4
+    const std::vector<std::string> filenames = { "materials/tdm_bloom_afx.mtr", "materials/tdm_ai_nobles.mtr" };
+    std::vector<std::string> expectedContents;
+
+    for (const auto& filename : filenames)
+    {
+        auto file = GlobalFileSystem().openFile(filename);
+        ASSERT_TRUE(file) << "Cannot open " << filename;
+
+        expectedContents.push_back(readArchiveFile(file));
+        EXPECT_EQ(expectedContents.back().size(), file->size());
+    }
+
+    std::vector<std::future<std::size_t>> tasks;
+
+    for (int thread = 0; thread < 8; ++thread)
+    {
+        tasks.emplace_back(std::async(std::launch::async, [&]()
+        {
+            std::size_t mismatches = 0;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto index = i % filenames.size();
+                auto file = GlobalFileSystem().openFile(filenames[index]);
+
+                if (!file || readArchiveFile(file) != expectedContents[index])
+                {
+                    ++mismatches;
+                }
+            }
+
+            return mismatches;
+        }));
+    }
+
+    for (auto& task : tasks)
+    {
+        EXPECT_EQ(task.get(), 0) << "Concurrent reads returned different contents";
+    }
+}
+
 }
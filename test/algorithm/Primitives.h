@@ -42,6 +42,22 @@ inline scene::INodePtr createCubicBrush(const scene::INodePtr& parent,
     return brushNode;
 }
 
+// Creates the given number of cubic brushes in a grid of 100 columns with the given spacing
+inline std::vector<scene::INodePtr> createBrushGrid(const scene::INodePtr& parent,
+    std::size_t count, double spacing, double z = 0, const std::string& material = "textures/numbers/1")
+{
+    std::vector<scene::INodePtr> brushes;
+    brushes.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Vector3 origin(static_cast<double>(i % 100) * spacing, static_cast<double>(i / 100) * spacing, z);
+        brushes.push_back(createCubicBrush(parent, origin, material));
+    }
+
+    return brushes;
+}
+
 inline scene::INodePtr createCuboidBrush(const scene::INodePtr& parent,
     const AABB& bounds = AABB(Vector3(0, 0, 0), Vector3(64,256,128)),
     const std::string& material = "_default")
@@ -5,16 +5,32 @@
 namespace test
 {
 
+class TestSyncObject final :
+    public render::ISyncObject
+{
+public:
+    std::size_t waitCount = 0;
+
+    void wait() override
+    {
+        ++waitCount;
+    }
+};
+
 class TestSyncObjectProvider final :
     public render::ISyncObjectProvider
 {
 public:
     std::size_t invocationCount = 0;
 
+    std::shared_ptr<TestSyncObject> lastCreatedSyncObject;
+
     render::ISyncObject::Ptr createSyncObject() override
     {
         ++invocationCount;
-        return {};
+
+        lastCreatedSyncObject = std::make_shared<TestSyncObject>();
+        return lastCreatedSyncObject;
     }
 
     static TestSyncObjectProvider& Instance()